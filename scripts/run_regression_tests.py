@@ -1,5 +1,7 @@
 import argparse
 import glob
+import hashlib
+import json
 import sys
 import os
 import subprocess
@@ -14,7 +16,24 @@ def is_game_path(path:str):
     return False
 
 
-def run_regression_test(runner, destdir, dump_interval, frames, renderer, cargs, gamepath):
+def read_manifest(path:str):
+    gamepaths = []
+    with open(path, "r") as f:
+        for line in f:
+            line = line.strip()
+            if len(line) == 0 or line.startswith("#"):
+                continue
+            gamepaths.append(os.path.realpath(os.path.join(os.path.dirname(path), line)))
+    return gamepaths
+
+
+def get_report_path(destdir, gamepath):
+    # Manifests can list images with the same name from different directories, so key by the full path.
+    path_hash = hashlib.sha1(gamepath.encode("utf-8")).hexdigest()[:12]
+    return os.path.join(destdir, "%s.%s.report.json" % (os.path.basename(gamepath), path_hash))
+
+
+def run_regression_test(runner, destdir, dump_interval, frames, renderer, report, cargs, gamepath):
     args = [runner,
             "-log", "error",
             "-dumpdir", destdir,
@@ -22,20 +41,48 @@ def run_regression_test(runner, destdir, dump_interval, frames, renderer, cargs,
             "-frames", str(frames),
             "-renderer", ("Software" if renderer is None else renderer),
     ]
+    report_path = None
+    if report:
+        report_path = get_report_path(destdir, gamepath)
+        # Don't pick up a previous run's report if the runner fails before writing one.
+        try:
+            os.remove(report_path)
+        except FileNotFoundError:
+            pass
+        args += ["-report", report_path]
     args += cargs
     args += ["--", gamepath]
 
     #print("Running '%s'" % (" ".join(args)))
-    subprocess.run(args)
-    return os.path.basename(gamepath)
+    result = subprocess.run(args)
+
+    entry = None
+    if report_path is not None:
+        try:
+            with open(report_path, "r") as f:
+                entry = json.load(f)
+        except (OSError, ValueError):
+            entry = {"path": gamepath, "success": False}
+        entry["exit_code"] = result.returncode
 
+    return (os.path.basename(gamepath), entry)
 
-def run_regression_tests(runner, gamedirs, destdir, dump_interval, frames, parallel, renderer, cargs):
+
+def write_report(path, entries):
+    entries.sort(key=lambda x: (os.path.basename(x["path"]), x["path"]))
+    with open(path, "w") as f:
+        json.dump({"runs": entries}, f, indent=2)
+    print("Wrote report for %u runs to %s" % (len(entries), path))
+
+
+def run_regression_tests(runner, gamedirs, manifest, destdir, dump_interval, frames, parallel, renderer, report, cargs):
     paths = []
     for gamedir in gamedirs:
         paths += glob.glob(os.path.realpath(gamedir) + "/*.*", recursive=True)
     gamepaths = list(filter(is_game_path, paths))
     gamepaths.sort(key=lambda x: os.path.basename(x))
+    if manifest is not None:
+        gamepaths += read_manifest(manifest)
 
     try:
         if not os.path.isdir(destdir):
@@ -46,19 +93,26 @@ def run_regression_tests(runner, gamedirs, destdir, dump_interval, frames, paral
 
     print("Found %u games" % len(gamepaths))
 
+    entries = []
     if parallel <= 1:
         for game in gamepaths:
-            run_regression_test(runner, destdir, dump_interval, frames, renderer, cargs, game)
+            _, entry = run_regression_test(runner, destdir, dump_interval, frames, renderer, report is not None, cargs, game)
+            if entry is not None:
+                entries.append(entry)
     else:
         print("Processing %u games on %u processors" % (len(gamepaths), parallel))
-        func = partial(run_regression_test, runner, destdir, dump_interval, frames, renderer, cargs)
+        func = partial(run_regression_test, runner, destdir, dump_interval, frames, renderer, report is not None, cargs)
         pool = multiprocessing.Pool(parallel)
         completed = 0
-        for filename in pool.imap_unordered(func, gamepaths, chunksize=1):
+        for filename, entry in pool.imap_unordered(func, gamepaths, chunksize=1):
             completed += 1
+            if entry is not None:
+                entries.append(entry)
             print("[%u%% %u/%u] %s" % ((completed * 100) // len(gamepaths), completed, len(gamepaths), filename))
         pool.close()
 
+    if report is not None:
+        write_report(report, entries)
 
     return True
 
@@ -66,7 +120,8 @@ def run_regression_tests(runner, gamedirs, destdir, dump_interval, frames, paral
 if __name__ == "__main__":
     parser = argparse.ArgumentParser(description="Generate frame dump images for regression tests")
     parser.add_argument("-runner", action="store", required=True, help="Path to DuckStation regression test runner")
-    parser.add_argument("-gamedir", action="append", required=True, help="Directory containing game images")
+    parser.add_argument("-gamedir", action="append", default=[], help="Directory containing game images")
+    parser.add_argument("-manifest", action="store", help="File listing game images/GPU dumps to run, one per line")
     parser.add_argument("-destdir", action="store", required=True, help="Base directory to dump frames to")
     parser.add_argument("-dumpinterval", action="store", type=int, default=600, help="Interval to dump frames at")
     parser.add_argument("-frames", action="store", type=int, default=36000, help="Number of frames to run")
@@ -76,8 +131,15 @@ if __name__ == "__main__":
     parser.add_argument("-pgxp", action="store_true", help="Enable PGXP")
     parser.add_argument("-pgxpcpu", action="store_true", help="Enable PGXP CPU mode")
     parser.add_argument("-cpu", action="store", help="CPU execution mode")
+    parser.add_argument("-hashinterval", action="store", type=int, help="Interval to log state hashes at")
+    parser.add_argument("-startframe", action="store", type=int, help="Frame to start GPU dump playback at")
+    parser.add_argument("-gpubench", action="store", type=int, help="Replay GPU dumps N times and report command timings")
+    parser.add_argument("-report", action="store", help="Write a JSON report of hashes, timing and memory usage")
 
     args = parser.parse_args()
+    if len(args.gamedir) == 0 and args.manifest is None:
+        parser.error("at least one of -gamedir or -manifest is required")
+
     cargs = []
     if (args.upscale is not None):
         cargs += ["-upscale", str(args.upscale)]
@@ -87,8 +149,15 @@ if __name__ == "__main__":
         cargs += ["-pgxp-cpu"]
     if (args.cpu is not None):
         cargs += ["-cpu", args.cpu]
-
-    if not run_regression_tests(args.runner, args.gamedir, os.path.realpath(args.destdir), args.dumpinterval, args.frames, args.parallel, args.renderer, cargs):
+    if (args.hashinterval is not None):
+        cargs += ["-hashinterval", str(args.hashinterval)]
+    if (args.startframe is not None):
+        cargs += ["-startframe", str(args.startframe)]
+    if (args.gpubench is not None):
+        cargs += ["-gpubench", str(args.gpubench)]
+
+    if not run_regression_tests(args.runner, args.gamedir, args.manifest, os.path.realpath(args.destdir), args.dumpinterval, args.frames, args.parallel, args.renderer,
+                                (os.path.realpath(args.report) if args.report is not None else None), cargs):
         sys.exit(1)
     else:
         sys.exit(0)
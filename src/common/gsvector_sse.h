@@ -21,6 +21,16 @@
 #define GSVECTOR_HAS_256 1
 #endif
 
+// The classes are compiled differently depending on the enabled ISA, so translation units built for a newer ISA get
+// their own symbols. Otherwise the linker could resolve out-of-line copies in baseline code to the newer ISA's copy.
+#ifdef CPU_ARCH_AVX2
+#define GSVECTOR_ISA_NAMESPACE GSVectorAVX2
+#else
+#define GSVECTOR_ISA_NAMESPACE GSVectorSSE
+#endif
+
+inline namespace GSVECTOR_ISA_NAMESPACE {
+
 class GSVector2;
 class GSVector2i;
 class GSVector4;
@@ -3061,3 +3071,5 @@ public:
 };
 
 #endif
+
+} // namespace GSVECTOR_ISA_NAMESPACE
@@ -11,11 +11,13 @@
 
 #include "fmt/format.h"
 
+#include <cerrno>
 #include <memory>
 
 #if defined(_WIN32)
 #include "windows_headers.h"
 #include <Psapi.h>
+#include <io.h>
 #elif defined(__APPLE__)
 #ifdef __aarch64__
 #include <pthread.h> // pthread_jit_write_protect_np()
@@ -135,6 +137,44 @@ void MemMap::UnmapSharedMemory(void* baseaddr, size_t size)
     Panic("Failed to unmap shared memory");
 }
 
+const void* MemMap::MapFileReadOnly(std::FILE* fp, size_t size, Error* error)
+{
+  const HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(fp)));
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    Error::SetErrno(error, "_get_osfhandle() failed: ", errno);
+    return nullptr;
+  }
+
+  const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping)
+  {
+    Error::SetWin32(error, "CreateFileMappingW() failed: ", GetLastError());
+    return nullptr;
+  }
+
+  // View keeps the mapping object alive.
+  const void* ret = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+  if (!ret)
+    Error::SetWin32(error, "MapViewOfFile() failed: ", GetLastError());
+
+  CloseHandle(mapping);
+  return ret;
+}
+
+void MemMap::UnmapFile(const void* ptr, size_t size)
+{
+  if (!UnmapViewOfFile(ptr))
+    Panic("Failed to unmap file");
+}
+
+void MemMap::PrefetchFileMapping(const void* ptr, size_t size)
+{
+  WIN32_MEMORY_RANGE_ENTRY range = {const_cast<void*>(ptr), size};
+  if (!PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0))
+    WARNING_LOG("PrefetchVirtualMemory() failed: {}", GetLastError());
+}
+
 const void* MemMap::GetBaseAddress()
 {
   const HMODULE mod = GetModuleHandleW(nullptr);
@@ -885,6 +925,37 @@ bool SharedMemoryMappingArea::Unmap(void* map_base, size_t map_size)
 
 #endif
 
+#ifndef _WIN32
+
+const void* MemMap::MapFileReadOnly(std::FILE* fp, size_t size, Error* error)
+{
+  void* ptr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fileno(fp), 0);
+  if (ptr == MAP_FAILED)
+  {
+    Error::SetErrno(error, "mmap() failed: ", errno);
+    return nullptr;
+  }
+
+  return ptr;
+}
+
+void MemMap::UnmapFile(const void* ptr, size_t size)
+{
+  if (munmap(const_cast<void*>(ptr), size) != 0)
+    Panic("Failed to unmap file");
+}
+
+void MemMap::PrefetchFileMapping(const void* ptr, size_t size)
+{
+  // madvise() wants a page-aligned start address.
+  const uintptr_t start = Common::AlignDownPow2(reinterpret_cast<uintptr_t>(ptr), HOST_PAGE_SIZE);
+  const size_t aligned_size = size + static_cast<size_t>(reinterpret_cast<uintptr_t>(ptr) - start);
+  if (madvise(reinterpret_cast<void*>(start), aligned_size, MADV_WILLNEED) != 0)
+    WARNING_LOG("madvise(MADV_WILLNEED) failed: {}", errno);
+}
+
+#endif
+
 void* MemMap::AllocateJITMemory(size_t size)
 {
   const u8* base =
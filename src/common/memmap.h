@@ -5,6 +5,7 @@
 
 #include "types.h"
 
+#include <cstdio>
 #include <map>
 #include <string>
 
@@ -62,6 +63,13 @@ void* MapSharedMemory(void* handle, size_t offset, void* baseaddr, size_t size,
 void UnmapSharedMemory(void* baseaddr, size_t size);
 bool MemProtect(void* baseaddr, size_t size, PageProtect mode);
 
+/// Maps the first size bytes of an open file read-only into the address space.
+const void* MapFileReadOnly(std::FILE* fp, size_t size, Error* error);
+void UnmapFile(const void* ptr, size_t size);
+
+/// Asks the OS to start paging in a range of a file mapping ahead of it being accessed.
+void PrefetchFileMapping(const void* ptr, size_t size);
+
 /// Returns the base address for the current process.
 const void* GetBaseAddress();
 
@@ -0,0 +1,322 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "core/gpu_sw_rasterizer.h"
+
+#include "common/gsvector.h"
+
+#include "cpuinfo.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+// The rasterizer only needs VRAM and the CLUT, not the rest of the GPU.
+u16 g_vram[VRAM_SIZE / sizeof(u16)];
+u16 g_gpu_clut[GPU_CLUT_SIZE];
+
+namespace GPU_SW_Rasterizer {
+constinit const DitherLUT g_dither_lut = []() constexpr {
+  DitherLUT lut = {};
+  for (u32 i = 0; i < DITHER_MATRIX_SIZE; i++)
+  {
+    for (u32 j = 0; j < DITHER_MATRIX_SIZE; j++)
+    {
+      for (u32 value = 0; value < DITHER_LUT_SIZE; value++)
+      {
+        const s32 dithered_value = (static_cast<s32>(value) + DITHER_MATRIX[i][j]) >> 3;
+        lut[i][j][value] = static_cast<u8>((dithered_value < 0) ? 0 : ((dithered_value > 31) ? 31 : dithered_value));
+      }
+    }
+  }
+  return lut;
+}();
+
+GPUDrawingArea g_drawing_area = {};
+constinit thread_local GPUDrawingArea g_clip_area = {};
+
+// Base ISA build of the vector rasterizer, same as core. The AVX2 build is core's own gpu_sw_rasterizer_avx2.cpp.
+namespace SIMD {
+namespace {
+#define USE_VECTOR 1
+#include "core/gpu_sw_rasterizer.inl"
+#undef USE_VECTOR
+} // namespace
+} // namespace GPU_SW_Rasterizer::SIMD
+} // namespace GPU_SW_Rasterizer
+
+namespace {
+
+struct RasterizerFunctions
+{
+  const GPU_SW_Rasterizer::DrawTriangleFunctionTable* triangle;
+  const GPU_SW_Rasterizer::DrawRectangleFunctionTable* rectangle;
+};
+
+static constexpr RasterizerFunctions SIMD_FUNCTIONS = {&GPU_SW_Rasterizer::SIMD::DrawTriangleFunctions,
+                                                       &GPU_SW_Rasterizer::SIMD::DrawRectangleFunctions};
+
+// Primitives are drawn to the top half of VRAM, and textures are read from the bottom half. A primitive which samples
+// its own output depends on the order pixels are written in, so it isn't expected to match between vector widths.
+static constexpr u32 DRAW_AREA_HEIGHT = VRAM_HEIGHT / 2;
+
+class Primitive
+{
+public:
+  bool IsRectangle() const { return m_rectangle; }
+  const GPUDrawingArea& GetDrawingArea() const { return m_drawing_area; }
+
+  const GPUBackendDrawPolygonCommand* GetPolygon() const
+  {
+    return reinterpret_cast<const GPUBackendDrawPolygonCommand*>(m_storage.data());
+  }
+
+  const GPUBackendDrawRectangleCommand* GetRectangle() const
+  {
+    return reinterpret_cast<const GPUBackendDrawRectangleCommand*>(m_storage.data());
+  }
+
+  static Primitive Random(std::mt19937& rng, bool rectangle)
+  {
+    Primitive prim;
+    prim.m_rectangle = rectangle;
+    prim.m_storage.resize(rectangle ? sizeof(GPUBackendDrawRectangleCommand) :
+                                      (sizeof(GPUBackendDrawPolygonCommand) +
+                                       sizeof(GPUBackendDrawPolygonCommand::Vertex) * 3));
+
+    GPUBackendDrawCommand* cmd = reinterpret_cast<GPUBackendDrawCommand*>(prim.m_storage.data());
+    cmd->texture_enable = (rng() & 1) != 0;
+    cmd->raw_texture_enable = cmd->texture_enable && (rng() & 1) != 0;
+    cmd->transparency_enable = (rng() & 1) != 0;
+    cmd->shading_enable = !rectangle && (rng() & 1) != 0;
+    cmd->dither_enable = !rectangle && (rng() & 1) != 0;
+    cmd->check_mask_before_draw = (rng() & 1) != 0;
+    cmd->set_mask_while_drawing = (rng() & 1) != 0;
+    cmd->interlaced_rendering = (rng() % 4) == 0;
+    cmd->active_line_lsb = (rng() & 1) != 0;
+    cmd->draw_mode.texture_page_x_base = static_cast<u8>(rng() % 16);
+    cmd->draw_mode.texture_page_y_base = 1;
+    cmd->draw_mode.transparency_mode = static_cast<GPUTransparencyMode>(rng() % 4);
+    cmd->draw_mode.texture_mode = static_cast<GPUTextureMode>(rng() % 3);
+    cmd->palette.bits = static_cast<u16>(rng());
+    cmd->window.and_x = 0xFF;
+    cmd->window.and_y = 0xFF;
+    if ((rng() % 4) == 0)
+    {
+      cmd->window.and_x = static_cast<u8>(rng());
+      cmd->window.or_x = static_cast<u8>(rng()) & ~cmd->window.and_x;
+    }
+
+    // Narrow drawing areas, and edges close to the right of VRAM, give lots of partially-covered vectors.
+    GPUDrawingArea& area = prim.m_drawing_area;
+    area.left = rng() % VRAM_WIDTH;
+    area.right = std::min<u32>(area.left + ((rng() & 1) ? (rng() % 16) : (rng() % 400)), VRAM_WIDTH - 1);
+    area.top = rng() % (DRAW_AREA_HEIGHT - 64);
+    area.bottom = area.top + (rng() % 64);
+
+    const auto random_x = [&rng, &area]() {
+      // Put some of the vertices on the right clip edge, so spans end just inside or outside it.
+      return ((rng() % 3) == 0) ? (static_cast<s32>(area.right) - static_cast<s32>(rng() % 8)) :
+                                  (static_cast<s32>(area.left) + static_cast<s32>(rng() % 480) - 40);
+    };
+    const auto random_y = [&rng, &area]() {
+      return static_cast<s32>(area.top) + static_cast<s32>(rng() % 96) - 16;
+    };
+
+    if (rectangle)
+    {
+      GPUBackendDrawRectangleCommand* rc = reinterpret_cast<GPUBackendDrawRectangleCommand*>(cmd);
+      rc->x = random_x();
+      rc->y = random_y();
+      rc->width = static_cast<u16>(1 + rng() % 96);
+      rc->height = static_cast<u16>(1 + rng() % 64);
+      rc->texcoord = static_cast<u16>(rng());
+      rc->color = rng();
+    }
+    else
+    {
+      GPUBackendDrawPolygonCommand* pc = reinterpret_cast<GPUBackendDrawPolygonCommand*>(cmd);
+      pc->num_vertices = 3;
+      for (u32 i = 0; i < 3; i++)
+      {
+        GPUBackendDrawPolygonCommand::Vertex& v = pc->vertices[i];
+        v.x = random_x();
+        v.y = random_y();
+        v.color = rng();
+        v.texcoord = static_cast<u16>(rng());
+      }
+    }
+
+    return prim;
+  }
+
+  void Draw(const RasterizerFunctions& functions) const
+  {
+    if (m_rectangle)
+    {
+      const GPUBackendDrawRectangleCommand* cmd = GetRectangle();
+      (*functions.rectangle)[cmd->texture_enable][cmd->raw_texture_enable][cmd->transparency_enable](cmd);
+    }
+    else
+    {
+      const GPUBackendDrawPolygonCommand* cmd = GetPolygon();
+      (*functions.triangle)[cmd->shading_enable][cmd->texture_enable][cmd->raw_texture_enable]
+                           [cmd->transparency_enable](cmd, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2]);
+    }
+  }
+
+private:
+  std::vector<u8> m_storage;
+  GPUDrawingArea m_drawing_area = {};
+  bool m_rectangle = false;
+};
+
+class GPUSWRasterizerTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    std::mt19937 rng(1234);
+    m_initial_vram.resize(std::size(g_vram));
+    for (u16& pixel : m_initial_vram)
+      pixel = static_cast<u16>(rng());
+    std::memcpy(g_vram, m_initial_vram.data(), sizeof(g_vram));
+    for (u16& color : g_gpu_clut)
+      color = static_cast<u16>(rng());
+  }
+
+  // Only the top half is drawn to.
+  void ResetVRAM() { std::memcpy(g_vram, m_initial_vram.data(), DRAW_AREA_HEIGHT * VRAM_WIDTH * sizeof(u16)); }
+
+  static std::vector<u16> GetVRAM() { return std::vector<u16>(g_vram, g_vram + DRAW_AREA_HEIGHT * VRAM_WIDTH); }
+
+  static void DrawWithClipArea(const Primitive& prim, const RasterizerFunctions& functions)
+  {
+    GPU_SW_Rasterizer::g_drawing_area = prim.GetDrawingArea();
+    GPU_SW_Rasterizer::g_clip_area = prim.GetDrawingArea();
+    prim.Draw(functions);
+  }
+
+  static void ExpectSameVRAM(const std::vector<u16>& expected, const std::vector<u16>& actual, const char* what)
+  {
+    size_t mismatches = 0;
+    size_t first = 0;
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+      if (expected[i] != actual[i] && mismatches++ == 0)
+        first = i;
+    }
+
+    EXPECT_EQ(mismatches, 0u) << what << ": first at " << (first % VRAM_WIDTH) << "," << (first / VRAM_WIDTH)
+                              << ", expected " << std::hex << expected[first] << " got " << actual[first];
+  }
+
+  std::vector<u16> m_initial_vram;
+};
+
+} // namespace
+
+#ifdef GPU_SW_RASTERIZER_HAS_AVX2
+
+static constexpr RasterizerFunctions AVX2_FUNCTIONS = {&GPU_SW_Rasterizer::AVX2::DrawTriangleFunctions,
+                                                       &GPU_SW_Rasterizer::AVX2::DrawRectangleFunctions};
+
+TEST_F(GPUSWRasterizerTest, AVX2MatchesSIMD)
+{
+  if (!cpuinfo_initialize() || !cpuinfo_has_x86_avx2())
+    GTEST_SKIP() << "CPU does not support AVX2.";
+
+  // One primitive at a time, so a mismatch can be traced back to the primitive which caused it.
+  std::mt19937 rng(5678);
+  for (u32 i = 0; i < 2000; i++)
+  {
+    const Primitive prim = Primitive::Random(rng, (i % 4) == 3);
+
+    ResetVRAM();
+    DrawWithClipArea(prim, SIMD_FUNCTIONS);
+    const std::vector<u16> expected = GetVRAM();
+
+    ResetVRAM();
+    DrawWithClipArea(prim, AVX2_FUNCTIONS);
+    ExpectSameVRAM(expected, GetVRAM(), prim.IsRectangle() ? "rectangle" : "triangle");
+    if (HasFailure())
+    {
+      ADD_FAILURE() << "Primitive " << i << " differs.";
+      break;
+    }
+  }
+}
+
+#endif
+
+TEST_F(GPUSWRasterizerTest, AdjacentClipAreasDrawnConcurrently)
+{
+  // Tile workers rasterize neighbouring clip areas at the same time. Any write outside the clip area, even of the value
+  // which was already there, can undo a pixel that the neighbouring worker just drew.
+  std::vector<RasterizerFunctions> implementations = {SIMD_FUNCTIONS};
+#ifdef GPU_SW_RASTERIZER_HAS_AVX2
+  if (cpuinfo_initialize() && cpuinfo_has_x86_avx2())
+    implementations.push_back(AVX2_FUNCTIONS);
+#endif
+
+  static constexpr u32 SPLIT_X = 256;
+  static constexpr GPUDrawingArea FULL_AREA = {0, 0, 511, DRAW_AREA_HEIGHT - 1};
+  static constexpr GPUDrawingArea LEFT_AREA = {0, 0, SPLIT_X - 1, DRAW_AREA_HEIGHT - 1};
+  static constexpr GPUDrawingArea RIGHT_AREA = {SPLIT_X, 0, 511, DRAW_AREA_HEIGHT - 1};
+
+  // Every primitive straddles the split.
+  std::mt19937 rng(9012);
+  std::vector<Primitive> prims;
+  for (u32 i = 0; i < 512; i++)
+  {
+    Primitive prim = Primitive::Random(rng, (i % 2) == 1);
+    if (prim.IsRectangle())
+    {
+      GPUBackendDrawRectangleCommand* cmd = const_cast<GPUBackendDrawRectangleCommand*>(prim.GetRectangle());
+      cmd->x = static_cast<s32>(SPLIT_X) - static_cast<s32>(1 + rng() % 40);
+      cmd->y = static_cast<s32>(rng() % (DRAW_AREA_HEIGHT - 64));
+      cmd->width = static_cast<u16>(48 + rng() % 48);
+    }
+    else
+    {
+      GPUBackendDrawPolygonCommand* cmd = const_cast<GPUBackendDrawPolygonCommand*>(prim.GetPolygon());
+      const s32 y = static_cast<s32>(rng() % (DRAW_AREA_HEIGHT - 64));
+      for (u32 j = 0; j < 3; j++)
+      {
+        cmd->vertices[j].x = static_cast<s32>(SPLIT_X) + ((j == 0) ? -48 : 48) + static_cast<s32>(rng() % 16);
+        cmd->vertices[j].y = y + static_cast<s32>(rng() % 64);
+      }
+    }
+
+    prims.push_back(std::move(prim));
+  }
+
+  const auto draw_all = [&prims](const RasterizerFunctions& functions, const GPUDrawingArea& area) {
+    GPU_SW_Rasterizer::g_clip_area = area;
+    for (const Primitive& prim : prims)
+      prim.Draw(functions);
+  };
+
+  for (const RasterizerFunctions& functions : implementations)
+  {
+    GPU_SW_Rasterizer::g_drawing_area = FULL_AREA;
+
+    ResetVRAM();
+    draw_all(functions, FULL_AREA);
+    const std::vector<u16> expected = GetVRAM();
+
+    for (u32 pass = 0; pass < 100 && !HasFailure(); pass++)
+    {
+      ResetVRAM();
+      std::thread right_thread([&draw_all, &functions]() { draw_all(functions, RIGHT_AREA); });
+      draw_all(functions, LEFT_AREA);
+      right_thread.join();
+
+      ExpectSameVRAM(expected, GetVRAM(), (&functions == &implementations.front()) ? "SIMD" : "AVX2");
+    }
+  }
+}
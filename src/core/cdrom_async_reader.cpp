@@ -250,6 +250,9 @@ bool CDROMAsyncReader::ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock)
     ERROR_LOG("Read of LBA {} failed", buffer.lba);
   }
 
+  // let the image start decoding the sectors we're going to read ahead
+  m_media->PrefetchSectors(m_media->GetPositionOnDisc(), static_cast<u32>(m_buffers.size()));
+
   lock.lock();
   m_is_reading.store(false);
   m_buffer_count.fetch_add(1);
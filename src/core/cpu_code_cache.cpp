@@ -15,10 +15,17 @@
 
 #include "common/align.h"
 #include "common/assert.h"
+#include "common/binary_reader_writer.h"
 #include "common/error.h"
+#include "common/file_system.h"
 #include "common/intrin.h"
 #include "common/log.h"
 #include "common/memmap.h"
+#include "common/path.h"
+#include "common/timer.h"
+
+#include "fmt/format.h"
+#include "xxhash.h"
 
 LOG_CHANNEL(CodeCache);
 
@@ -52,6 +59,12 @@ static constexpr u32 RECOMPILE_FRAMES_FOR_INTERPRETER_FALLBACK = 15;
 static constexpr u32 INVALIDATE_COUNT_FOR_MANUAL_PROTECTION = 4;
 static constexpr u32 INVALIDATE_FRAMES_FOR_MANUAL_PROTECTION = 60;
 
+// With deferred compilation, blocks are interpreted once we've spent this long compiling in the current frame.
+static constexpr double DEFERRED_COMPILE_BUDGET_MS = 2.0;
+
+// Number of times a block has to be seen when running events before it's recompiled as a superblock.
+static constexpr u32 SUPERBLOCK_SAMPLE_THRESHOLD = 32;
+
 static void AllocateLUTs();
 static void DeallocateLUTs();
 static void ResetCodeLUT();
@@ -66,13 +79,22 @@ static bool IsBlockCodeCurrent(const Block* block);
 static bool RevalidateBlock(Block* block);
 static PageProtectionMode GetProtectionModeForPC(u32 pc);
 static PageProtectionMode GetProtectionModeForBlock(const Block* block);
-static bool ReadBlockInstructions(u32 start_pc, BlockInstructionList* instructions, BlockMetadata* metadata);
+static bool ReadBlockInstructions(u32 start_pc, BlockInstructionList* instructions, BlockMetadata* metadata,
+                                  bool superblock = false);
 static void FillBlockRegInfo(Block* block);
 static void CopyRegInfo(InstructionInfo* dst, const InstructionInfo* src);
 static void SetRegAccess(InstructionInfo* inst, Reg reg, bool write);
 static void AddBlockToPageList(Block* block);
 static void RemoveBlockFromPageList(Block* block);
 
+static std::string GetBlockCachePath(GameHash game_hash);
+static u64 GetBlockCodeHash(const BlockInstructionList& instructions);
+static u64 GetBlockCodeHash(const Block* block);
+static void UpdateBlockCache();
+static void LoadBlockCache();
+static void SaveBlockCache();
+static bool IsCachedInterpreterFallbackBlock(u32 pc, u32 size);
+
 static Block* CreateCachedInterpreterBlock(u32 pc);
 [[noreturn]] static void ExecuteCachedInterpreter();
 template<PGXPMode pgxp_mode>
@@ -92,18 +114,75 @@ static BlockInstructionList s_block_instructions;
 
 static void BacklinkBlocks(u32 pc, const void* dst);
 static void UnlinkBlockExits(Block* block);
+static BlockLinkIndex AddBlockLink(u32 pc, void* code);
+static void RemoveBlockLink(BlockLinkIndex index);
+static void ClearBlockLinks();
 static void ResetCodeBuffer();
 
 static void CompileASMFunctions();
 static bool CompileBlock(Block* block);
+static bool HasCompileBudget();
+static void InterpretDeferredBlock();
+static bool IsSuperblockCandidate(const Block* block);
+static void SampleHotBlock(u32 pc);
+static void RunEventsAndSampleHotBlock();
 static PageFaultHandler::HandlerResult HandleFastmemException(void* exception_pc, void* fault_address, bool is_write);
 static void BackpatchLoadStore(void* host_pc, const LoadstoreBackpatchInfo& info);
 static void RemoveBackpatchInfoForRange(const void* host_code, u32 size);
 
-static BlockLinkMap s_block_links;
+// Block links live in a flat pool, chained per target pc, with an open-addressed table of chain heads. Blocks keep
+// the index of their exit links, so unlinking doesn't need a lookup, and backlinking walks a single array.
+struct BlockLink
+{
+  void* code;
+  u32 pc;
+  BlockLinkIndex prev;
+  BlockLinkIndex next;
+};
+
+struct BlockLinkHead
+{
+  u32 pc;
+  BlockLinkIndex first;
+};
+
+static constexpr BlockLinkIndex INVALID_BLOCK_LINK = std::numeric_limits<BlockLinkIndex>::max();
+static constexpr u32 EMPTY_BLOCK_LINK_HEAD_PC = 0xFFFFFFFFu; // unaligned, can't be a block
+static constexpr u32 INITIAL_BLOCK_LINK_HEAD_COUNT = 4096;
+
+static BlockLinkHead* FindBlockLinkHead(u32 pc, bool create);
+static void GrowBlockLinkHeads();
+
+static std::vector<BlockLink> s_block_links;
+static BlockLinkIndex s_free_block_link = INVALID_BLOCK_LINK;
+static std::vector<BlockLinkHead> s_block_link_heads;
+static u32 s_block_link_head_count = 0;
+
+static Statistics s_statistics = {};
+
 static std::map<const void*, LoadstoreBackpatchInfo> s_fastmem_backpatch_info;
 static std::unordered_set<u32> s_fastmem_faulting_pcs;
 
+static Timer::Value s_compile_time_this_frame = 0;
+static u32 s_compile_budget_frame = 0;
+
+// Persistent block cache. Host code is not position independent (block links, thunks, fastmem base), so rather
+// than the machine code itself we keep the guest block layout, which lets us recompile it up front after loading
+// a state, along with the blocks which had to fall back to the interpreter and loadstores which needed backpatching.
+struct CachedBlockInfo
+{
+  u32 size;
+  bool fallback_to_interpreter;
+  u64 code_hash;
+};
+
+static constexpr u32 BLOCK_CACHE_SIGNATURE = 0x4B4C4252; // RBLK
+static constexpr u32 BLOCK_CACHE_VERSION = 1;
+
+static std::unordered_map<u32, CachedBlockInfo> s_block_cache;
+static std::unordered_set<u32> s_block_cache_faulting_pcs;
+static GameHash s_block_cache_game_hash = 0;
+
 NORETURN_FUNCTION_POINTER void (*g_enter_recompiler)();
 const void* g_compile_or_revalidate_block;
 const void* g_run_events_and_dispatch;
@@ -163,6 +242,11 @@ bool CPU::CodeCache::IsUsingRecompiler()
   return (g_settings.cpu_execution_mode == CPUExecutionMode::Recompiler);
 }
 
+const CPU::CodeCache::Statistics& CPU::CodeCache::GetStatistics()
+{
+  return s_statistics;
+}
+
 bool CPU::CodeCache::IsUsingFastmem()
 {
   return (g_settings.cpu_fastmem_mode != CPUFastmemMode::Disabled);
@@ -207,7 +291,9 @@ void CPU::CodeCache::ProcessShutdown()
 
 void CPU::CodeCache::Reset()
 {
+  UpdateBlockCache();
   ClearBlocks();
+  s_statistics = {};
 
   if (IsUsingRecompiler())
   {
@@ -215,11 +301,19 @@ void CPU::CodeCache::Reset()
     CompileASMFunctions();
     ResetCodeLUT();
   }
+
+  LoadBlockCache();
 }
 
 void CPU::CodeCache::Shutdown()
 {
+  UpdateBlockCache();
   ClearBlocks();
+  SaveBlockCache();
+
+  s_block_cache.clear();
+  s_block_cache_faulting_pcs.clear();
+  s_block_cache_game_hash = 0;
 }
 
 void CPU::CodeCache::Execute()
@@ -428,6 +522,7 @@ CPU::CodeCache::Block* CPU::CodeCache::CreateBlock(u32 pc, const BlockInstructio
   block->host_code_size = 0;
   block->compile_frame = recompile_frame;
   block->compile_count = recompile_count + 1;
+  block->sample_count = 0;
 
   // copy instructions/info
   {
@@ -455,6 +550,16 @@ CPU::CodeCache::Block* CPU::CodeCache::CreateBlock(u32 pc, const BlockInstructio
   {
     DEV_LOG("{} recompiles in {} frames to block 0x{:08X}, not caching.", block->compile_count, frame_delta, block->pc);
     block->size = 0;
+
+    if (s_block_cache_game_hash != 0)
+      s_block_cache[pc] = CachedBlockInfo{size, true, 0};
+  }
+  else if (block->compile_count == 1 && IsCachedInterpreterFallbackBlock(pc, size))
+  {
+    // Give it one more chance, the code at this address may not be self-modifying any more. If it gets recompiled
+    // again soon it falls straight back, otherwise the entry is dropped when the block cache is next updated.
+    DEV_LOG("Block 0x{:08X} fell back to the interpreter in a previous session, one recompile allowed.", block->pc);
+    block->compile_count = RECOMPILE_COUNT_FOR_INTERPRETER_FALLBACK - 1;
   }
 
   // cached interpreter creates empty blocks when falling back
@@ -591,6 +696,7 @@ void CPU::CodeCache::InvalidateBlocksWithPageIndex(u32 index)
   if (!ppi.first_block_in_page)
     return;
 
+  const Timer::Value start_time = Timer::GetCurrentValue();
   MemMap::BeginCodeWrite();
 
   Block* block = ppi.first_block_in_page;
@@ -604,6 +710,9 @@ void CPU::CodeCache::InvalidateBlocksWithPageIndex(u32 index)
   ppi.last_block_in_page = nullptr;
 
   MemMap::EndCodeWrite();
+
+  s_statistics.page_invalidations++;
+  s_statistics.page_invalidation_ticks += Timer::GetCurrentValue() - start_time;
 }
 
 CPU::CodeCache::PageProtectionMode CPU::CodeCache::GetProtectionModeForPC(u32 pc)
@@ -631,6 +740,7 @@ void CPU::CodeCache::InvalidateBlock(Block* block, BlockState new_state)
   {
     SetCodeLUT(block->pc, g_compile_or_revalidate_block);
     BacklinkBlocks(block->pc, g_compile_or_revalidate_block);
+    s_statistics.blocks_invalidated++;
   }
 
   block->state = new_state;
@@ -673,7 +783,7 @@ void CPU::CodeCache::ClearBlocks()
 
   s_fastmem_backpatch_info.clear();
   s_fastmem_faulting_pcs.clear();
-  s_block_links.clear();
+  ClearBlockLinks();
 
   for (Block* block : s_blocks)
   {
@@ -703,6 +813,227 @@ PageFaultHandler::HandlerResult PageFaultHandler::HandlePageFault(void* exceptio
   return CPU::CodeCache::HandleFastmemException(exception_pc, fault_address, is_write);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// MARK: - Persistent Block Cache
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::string CPU::CodeCache::GetBlockCachePath(GameHash game_hash)
+{
+  return Path::Combine(EmuFolders::Cache, fmt::format("recompiler_blocks_{:016X}.cache", game_hash));
+}
+
+u64 CPU::CodeCache::GetBlockCodeHash(const BlockInstructionList& instructions)
+{
+  XXH64_state_t* state = XXH64_createState();
+  XXH64_reset(state, 0);
+  for (const auto& [inst, info] : instructions)
+    XXH64_update(state, &inst.bits, sizeof(inst.bits));
+  const u64 hash = XXH64_digest(state);
+  XXH64_freeState(state);
+  return hash;
+}
+
+u64 CPU::CodeCache::GetBlockCodeHash(const Block* block)
+{
+  // Must match the streaming hash above, which is the same as hashing the contiguous words.
+  return XXH64(block->Instructions(), sizeof(Instruction) * block->size, 0);
+}
+
+bool CPU::CodeCache::IsCachedInterpreterFallbackBlock(u32 pc, u32 size)
+{
+  if (s_block_cache_game_hash == 0)
+    return false;
+
+  // Self-modifying code won't match a hash, so only check the block boundaries.
+  const auto iter = s_block_cache.find(pc);
+  return (iter != s_block_cache.end() && iter->second.fallback_to_interpreter && iter->second.size == size);
+}
+
+void CPU::CodeCache::UpdateBlockCache()
+{
+  if (s_block_cache_game_hash == 0)
+    return;
+
+  for (const Block* block : s_blocks)
+  {
+    // Interpreter fallbacks are recorded when they happen, since the block size is discarded.
+    // Superblocks come from runtime profiling, so keep the plain block that was recorded before promotion.
+    if (block->size == 0 || block->state == BlockState::FallbackToInterpreter ||
+        block->HasFlag(BlockFlags::Superblock))
+    {
+      continue;
+    }
+
+    // Previous fallbacks age out once the block has been compiled and stayed valid, not while it's still churning.
+    const auto iter = s_block_cache.find(block->pc);
+    if (iter != s_block_cache.end() && iter->second.fallback_to_interpreter && block->state != BlockState::Valid)
+      continue;
+
+    s_block_cache[block->pc] = CachedBlockInfo{block->size, false, GetBlockCodeHash(block)};
+  }
+
+  s_block_cache_faulting_pcs.insert(s_fastmem_faulting_pcs.begin(), s_fastmem_faulting_pcs.end());
+}
+
+void CPU::CodeCache::LoadBlockCache()
+{
+  const GameHash game_hash =
+    (g_settings.cpu_recompiler_block_cache && IsUsingRecompiler()) ? System::GetGameHash() : 0;
+  if (game_hash != s_block_cache_game_hash)
+  {
+    SaveBlockCache();
+    s_block_cache.clear();
+    s_block_cache_faulting_pcs.clear();
+    s_block_cache_game_hash = game_hash;
+    if (game_hash == 0)
+      return;
+
+    Error error;
+    const std::string path = GetBlockCachePath(game_hash);
+    std::optional<DynamicHeapArray<u8>> data = FileSystem::ReadBinaryFile(path.c_str(), &error);
+    if (!data.has_value())
+    {
+      DEV_LOG("Failed to read block cache: {}", error.GetDescription());
+      return;
+    }
+
+    BinarySpanReader reader(data->cspan());
+    u32 signature, version, num_blocks, num_faulting_pcs;
+    u64 file_game_hash;
+    if (!reader.ReadU32(&signature) || !reader.ReadU32(&version) || !reader.ReadU64(&file_game_hash) ||
+        !reader.ReadU32(&num_blocks) || !reader.ReadU32(&num_faulting_pcs) || signature != BLOCK_CACHE_SIGNATURE ||
+        version != BLOCK_CACHE_VERSION || file_game_hash != game_hash)
+    {
+      WARNING_LOG("Block cache '{}' is corrupted or version mismatch.", Path::GetFileName(path));
+      return;
+    }
+
+    s_block_cache.reserve(num_blocks);
+    for (u32 i = 0; i < num_blocks; i++)
+    {
+      u32 pc;
+      CachedBlockInfo info;
+      if (!reader.ReadU32(&pc) || !reader.ReadU32(&info.size) || !reader.ReadBool(&info.fallback_to_interpreter) ||
+          !reader.ReadU64(&info.code_hash) || info.size == 0)
+      {
+        WARNING_LOG("Block cache '{}' is corrupted.", Path::GetFileName(path));
+        s_block_cache.clear();
+        return;
+      }
+
+      s_block_cache.emplace(pc, info);
+    }
+
+    for (u32 i = 0; i < num_faulting_pcs; i++)
+    {
+      u32 pc;
+      if (!reader.ReadU32(&pc))
+      {
+        WARNING_LOG("Block cache '{}' is corrupted.", Path::GetFileName(path));
+        s_block_cache.clear();
+        s_block_cache_faulting_pcs.clear();
+        return;
+      }
+
+      s_block_cache_faulting_pcs.insert(pc);
+    }
+
+    INFO_LOG("Loaded {} blocks and {} faulting loadstores from block cache.", s_block_cache.size(),
+             s_block_cache_faulting_pcs.size());
+  }
+
+  // Don't bother emitting fastmem accesses that we already know will fault.
+  if (game_hash != 0)
+    s_fastmem_faulting_pcs.insert(s_block_cache_faulting_pcs.begin(), s_block_cache_faulting_pcs.end());
+}
+
+void CPU::CodeCache::SaveBlockCache()
+{
+  if (s_block_cache_game_hash == 0 || s_block_cache.empty())
+    return;
+
+  Error error;
+  FileSystem::AtomicRenamedFile file =
+    FileSystem::CreateAtomicRenamedFile(GetBlockCachePath(s_block_cache_game_hash), &error);
+  if (!file)
+  {
+    ERROR_LOG("Failed to open block cache for writing: {}", error.GetDescription());
+    return;
+  }
+
+  BinaryFileWriter writer(file.get());
+  writer.WriteU32(BLOCK_CACHE_SIGNATURE);
+  writer.WriteU32(BLOCK_CACHE_VERSION);
+  writer.WriteU64(s_block_cache_game_hash);
+  writer.WriteU32(static_cast<u32>(s_block_cache.size()));
+  writer.WriteU32(static_cast<u32>(s_block_cache_faulting_pcs.size()));
+
+  for (const auto& [pc, info] : s_block_cache)
+  {
+    writer.WriteU32(pc);
+    writer.WriteU32(info.size);
+    writer.WriteBool(info.fallback_to_interpreter);
+    writer.WriteU64(info.code_hash);
+  }
+
+  for (const u32 pc : s_block_cache_faulting_pcs)
+    writer.WriteU32(pc);
+
+  if (!writer.Flush(&error) || !FileSystem::CommitAtomicRenamedFile(file, &error))
+  {
+    ERROR_LOG("Failed to write block cache: {}", error.GetDescription());
+    FileSystem::DiscardAtomicRenamedFile(file);
+    return;
+  }
+
+  DEV_LOG("Wrote {} blocks to block cache.", s_block_cache.size());
+}
+
+void CPU::CodeCache::PrecompileCachedBlocks()
+{
+  if (s_block_cache_game_hash == 0 || s_block_cache.empty())
+    return;
+
+  Timer timer;
+  u32 num_compiled = 0;
+  MemMap::BeginCodeWrite();
+
+  for (const auto& [pc, info] : s_block_cache)
+  {
+    if (info.fallback_to_interpreter || !HasBlockLUT(pc) || LookupBlock(pc))
+      continue;
+
+    // Leave the remaining space for blocks compiled at runtime, we don't want to trigger a reset here.
+    if (GetFreeCodeSpace() < (info.size * Recompiler::MAX_NEAR_HOST_BYTES_PER_INSTRUCTION) ||
+        GetFreeCodeSpace() < (Recompiler::MIN_CODE_RESERVE_FOR_BLOCK * 2) ||
+        GetFreeFarCodeSpace() < (Recompiler::MIN_CODE_RESERVE_FOR_BLOCK * 2))
+    {
+      break;
+    }
+
+    // Only compile the block if the guest code hasn't changed since it was recorded, i.e. same overlay.
+    BlockMetadata metadata = {};
+    if (!ReadBlockInstructions(pc, &s_block_instructions, &metadata) || s_block_instructions.size() != info.size ||
+        GetBlockCodeHash(s_block_instructions) != info.code_hash)
+    {
+      continue;
+    }
+
+    Block* block = CreateBlock(pc, s_block_instructions, metadata);
+    if (!block || block->size == 0 || !CompileBlock(block))
+      continue;
+
+    SetCodeLUT(pc, block->host_code);
+    BacklinkBlocks(pc, block->host_code);
+    num_compiled++;
+  }
+
+  MemMap::EndCodeWrite();
+
+  INFO_LOG("Precompiled {} of {} cached blocks in {:.2f} ms.", num_compiled, s_block_cache.size(),
+           timer.GetTimeMilliseconds());
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // MARK: - Cached Interpreter
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -849,7 +1180,8 @@ void CPU::CodeCache::LogCurrentState()
 // MARK: - Block Compilation: Shared Code
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* instructions, BlockMetadata* metadata)
+bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* instructions, BlockMetadata* metadata,
+                                           bool superblock /* = false */)
 {
   // TODO: Jump to other block if it exists at this pc?
 
@@ -858,9 +1190,13 @@ bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* i
   const bool dynamic_fetch_ticks =
     (!use_icache && Bus::GetMemoryAccessTimePtr(VirtualAddressToPhysical(start_pc), MemoryAccessSize::Word) != nullptr);
   u32 pc = start_pc;
+  u32 superblock_branches = 0;
   bool is_branch_delay_slot = false;
   bool is_load_delay_slot = false;
 
+  // Side exits charge no fetch ticks, so only extend blocks which don't need them.
+  superblock = superblock && use_icache && !g_settings.cpu_recompiler_icache;
+
 #if 0
   if (pc == 0x0005aa90)
     __debugbreak();
@@ -871,6 +1207,8 @@ bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* i
   metadata->uncached_fetch_ticks = 0;
   metadata->flags = use_icache ? BlockFlags::IsUsingICache :
                                  (dynamic_fetch_ticks ? BlockFlags::NeedsDynamicFetchTicks : BlockFlags::None);
+  if (superblock)
+    metadata->flags |= BlockFlags::Superblock;
 
   u32 last_cache_line = ICACHE_LINES;
   u32 last_page = (protection == PageProtectionMode::WriteProtected) ? Bus::GetRAMCodePageIndex(start_pc) : 0;
@@ -973,7 +1311,17 @@ bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* i
     // if we're in a branch delay slot, the block is now done
     // except if this is a branch in a branch delay slot, then we grab the one after that, and so on...
     if (is_branch_delay_slot && !info.is_branch_instruction)
-      break;
+    {
+      // superblocks keep going through the not-taken path of conditional branches, the taken path is a side exit
+      const InstructionInfo& branch_info = (instructions->end() - 2)->second;
+      if (!superblock || superblock_branches == MAX_SUPERBLOCK_BRANCHES || !branch_info.is_direct_branch_instruction ||
+          branch_info.is_unconditional_branch_instruction)
+      {
+        break;
+      }
+
+      superblock_branches++;
+    }
 
     // if this is a branch, we grab the next instruction (delay slot), and then exit
     is_branch_delay_slot = info.is_branch_instruction;
@@ -1000,6 +1348,7 @@ bool CPU::CodeCache::ReadBlockInstructions(u32 start_pc, BlockInstructionList* i
   DEBUG_LOG("Block at 0x{:08X}", start_pc);
   DEBUG_LOG(" Uncached fetch ticks: {}", metadata->uncached_fetch_ticks);
   DEBUG_LOG(" ICache line count: {}", metadata->icache_line_count);
+  DEBUG_LOG(" Superblock branches: {}", superblock_branches);
   for (const auto& cbi : *instructions)
   {
     CPU::DisassembleInstruction(&disasm, disasm_pc, cbi.first.bits);
@@ -1298,7 +1647,21 @@ void CPU::CodeCache::CompileOrRevalidateBlock(u32 start_pc)
       MemMap::EndCodeWrite();
       return;
     }
+  }
+
+  // Spent too long compiling this frame? Interpret the block for now, the LUT still points to the compiler so we'll
+  // come back here on the next execution, and compile it once the budget has reset.
+  if (g_settings.cpu_recompiler_deferred_compilation && !HasCompileBudget())
+  {
+    MemMap::EndCodeWrite();
+    InterpretDeferredBlock();
+    return;
+  }
+
+  const Timer::Value compile_start_time = Timer::GetCurrentValue();
 
+  if (block)
+  {
     // remove outward links from this block, since we're recompiling it
     UnlinkBlockExits(block);
 
@@ -1307,8 +1670,11 @@ void CPU::CodeCache::CompileOrRevalidateBlock(u32 start_pc)
       RemoveBackpatchInfoForRange(block->host_code, block->host_code_size);
   }
 
+  // hot blocks keep being compiled as superblocks, even if they get invalidated
+  const bool superblock = (block && block->HasFlag(BlockFlags::Superblock));
+
   BlockMetadata metadata = {};
-  if (!ReadBlockInstructions(start_pc, &s_block_instructions, &metadata))
+  if (!ReadBlockInstructions(start_pc, &s_block_instructions, &metadata, superblock))
   {
     ERROR_LOG("Failed to read block at 0x{:08X}, falling back to uncached interpreter", start_pc);
     SetCodeLUT(start_pc, g_interpret_block);
@@ -1343,6 +1709,8 @@ void CPU::CodeCache::CompileOrRevalidateBlock(u32 start_pc)
   SetCodeLUT(start_pc, block->host_code);
   BacklinkBlocks(start_pc, block->host_code);
   MemMap::EndCodeWrite();
+
+  s_compile_time_this_frame += Timer::GetCurrentValue() - compile_start_time;
 }
 
 void CPU::CodeCache::DiscardAndRecompileBlock(u32 start_pc)
@@ -1353,9 +1721,73 @@ void CPU::CodeCache::DiscardAndRecompileBlock(u32 start_pc)
   Block* block = LookupBlock(start_pc);
   DebugAssert(block && block->state == BlockState::Valid);
   InvalidateBlock(block, BlockState::NeedsRecompile);
+
+  MemMap::EndCodeWrite();
+
+  // Not nested in the code write, compilation may be deferred, and the interpreter can exit execution.
   CompileOrRevalidateBlock(start_pc);
+}
+
+bool CPU::CodeCache::HasCompileBudget()
+{
+  const u32 frame_number = System::GetFrameNumber();
+  if (frame_number != s_compile_budget_frame)
+  {
+    s_compile_budget_frame = frame_number;
+    s_compile_time_this_frame = 0;
+    return true;
+  }
+
+  static const Timer::Value budget = Timer::ConvertMillisecondsToValue(DEFERRED_COMPILE_BUDGET_MS);
+  return (s_compile_time_this_frame < budget);
+}
+
+void CPU::CodeCache::InterpretDeferredBlock()
+{
+  // Same as the interpret block ASM function, run events if we're out of time, then return to the dispatcher.
+  reinterpret_cast<void (*)()>(const_cast<void*>(GetInterpretUncachedBlockFunction()))();
+  if (g_state.pending_ticks >= g_state.downcount)
+    TimingEvents::RunEvents();
+}
+
+bool CPU::CodeCache::IsSuperblockCandidate(const Block* block)
+{
+  // Needs to end in a conditional branch to have anything to extend with, and exits can't change the fetch ticks.
+  if (block->state != BlockState::Valid || block->size < 2 || block->HasFlag(BlockFlags::Superblock) ||
+      !block->HasFlag(BlockFlags::IsUsingICache) || g_settings.cpu_recompiler_icache)
+  {
+    return false;
+  }
+
+  const InstructionInfo& branch_info = block->InstructionsInfo()[block->size - 2];
+  return (branch_info.is_direct_branch_instruction && !branch_info.is_unconditional_branch_instruction &&
+          block->InstructionsInfo()[block->size - 1].is_branch_delay_slot);
+}
+
+void CPU::CodeCache::SampleHotBlock(u32 pc)
+{
+  Block* const block = LookupBlock(pc);
+  if (!block || !IsSuperblockCandidate(block) || ++block->sample_count < SUPERBLOCK_SAMPLE_THRESHOLD)
+    return;
 
+  DEV_LOG("Block 0x{:08X} is hot, recompiling as superblock", pc);
+
+  // Same as invalidating from a write, except we know the code hasn't changed.
+  MemMap::BeginCodeWrite();
+  RemoveBlockFromPageList(block);
+  InvalidateBlock(block, BlockState::NeedsRecompile);
   MemMap::EndCodeWrite();
+
+  // Which also means it shouldn't count towards the interpreter fallback.
+  block->flags |= BlockFlags::Superblock;
+  block->compile_count--;
+}
+
+void CPU::CodeCache::RunEventsAndSampleHotBlock()
+{
+  // Sampling when events run is much cheaper than counting every block execution, and still finds the hot loops.
+  SampleHotBlock(g_state.pc);
+  TimingEvents::RunEvents();
 }
 
 const void* CPU::CodeCache::CreateBlockLink(Block* block, void* code, u32 newpc)
@@ -1380,9 +1812,8 @@ const void* CPU::CodeCache::CreateBlockLink(Block* block, void* code, u32 newpc)
       dst = HasBlockLUT(newpc) ? g_compile_or_revalidate_block : g_interpret_block;
     }
 
-    BlockLinkMap::iterator iter = s_block_links.emplace(newpc, code);
     DebugAssert(block->num_exit_links < MAX_BLOCK_EXIT_LINKS);
-    block->exit_links[block->num_exit_links++] = iter;
+    block->exit_links[block->num_exit_links++] = AddBlockLink(newpc, code);
   }
 
   DEBUG_LOG("Linking {} with dst pc {:08X} to {}{}", code, newpc, dst,
@@ -1397,9 +1828,8 @@ const void* CPU::CodeCache::CreateSelfBlockLink(Block* block, void* code, const
   {
     dst = block_start;
 
-    BlockLinkMap::iterator iter = s_block_links.emplace(block->pc, code);
     DebugAssert(block->num_exit_links < MAX_BLOCK_EXIT_LINKS);
-    block->exit_links[block->num_exit_links++] = iter;
+    block->exit_links[block->num_exit_links++] = AddBlockLink(block->pc, code);
   }
 
   DEBUG_LOG("Self linking {} with dst pc {:08X} to {}", code, block->pc, dst);
@@ -1411,12 +1841,17 @@ void CPU::CodeCache::BacklinkBlocks(u32 pc, const void* dst)
   if (!g_settings.cpu_recompiler_block_linking)
     return;
 
-  const auto link_range = s_block_links.equal_range(pc);
-  for (auto it = link_range.first; it != link_range.second; ++it)
+  const BlockLinkHead* head = FindBlockLinkHead(pc, false);
+  if (!head)
+    return;
+
+  for (BlockLinkIndex index = head->first; index != INVALID_BLOCK_LINK; index = s_block_links[index].next)
   {
-    DEBUG_LOG("Backlinking {} with dst pc {:08X} to {}{}", it->second, pc, dst,
+    const BlockLink& link = s_block_links[index];
+    DEBUG_LOG("Backlinking {} with dst pc {:08X} to {}{}", link.code, pc, dst,
               (dst == g_compile_or_revalidate_block) ? "[compiler]" : "");
-    EmitJump(it->second, dst, true);
+    EmitJump(link.code, dst, true);
+    s_statistics.links_patched++;
   }
 }
 
@@ -1424,10 +1859,128 @@ void CPU::CodeCache::UnlinkBlockExits(Block* block)
 {
   const u32 num_exit_links = block->num_exit_links;
   for (u32 i = 0; i < num_exit_links; i++)
-    s_block_links.erase(block->exit_links[i]);
+    RemoveBlockLink(block->exit_links[i]);
   block->num_exit_links = 0;
 }
 
+CPU::CodeCache::BlockLinkHead* CPU::CodeCache::FindBlockLinkHead(u32 pc, bool create)
+{
+  if (s_block_link_heads.empty())
+  {
+    if (!create)
+      return nullptr;
+
+    s_block_link_heads.resize(INITIAL_BLOCK_LINK_HEAD_COUNT, BlockLinkHead{EMPTY_BLOCK_LINK_HEAD_PC, INVALID_BLOCK_LINK});
+  }
+  else if (create && ((s_block_link_head_count + 1) * 2) > s_block_link_heads.size())
+  {
+    GrowBlockLinkHeads();
+  }
+
+  // linear probing, pcs are word aligned so drop the low bits before mixing
+  const u32 mask = static_cast<u32>(s_block_link_heads.size()) - 1;
+  u32 hash = (pc >> 2) * 0x9E3779B1u;
+  for (u32 pos = (hash ^ (hash >> 16)) & mask;; pos = (pos + 1) & mask)
+  {
+    BlockLinkHead& head = s_block_link_heads[pos];
+    if (head.pc == pc)
+      return &head;
+
+    if (head.pc == EMPTY_BLOCK_LINK_HEAD_PC)
+    {
+      if (!create)
+        return nullptr;
+
+      head.pc = pc;
+      head.first = INVALID_BLOCK_LINK;
+      s_block_link_head_count++;
+      return &head;
+    }
+  }
+}
+
+void CPU::CodeCache::GrowBlockLinkHeads()
+{
+  // heads aren't removed when their chain empties, so drop those while we're rehashing
+  std::vector<BlockLinkHead> old_heads = std::move(s_block_link_heads);
+  u32 new_size = static_cast<u32>(old_heads.size());
+  u32 num_live_heads = 0;
+  for (const BlockLinkHead& head : old_heads)
+    num_live_heads += BoolToUInt32(head.first != INVALID_BLOCK_LINK);
+  while ((num_live_heads + 1) * 4 > new_size)
+    new_size *= 2;
+
+  s_block_link_heads.clear();
+  s_block_link_heads.resize(new_size, BlockLinkHead{EMPTY_BLOCK_LINK_HEAD_PC, INVALID_BLOCK_LINK});
+  s_block_link_head_count = 0;
+  for (const BlockLinkHead& head : old_heads)
+  {
+    if (head.first != INVALID_BLOCK_LINK)
+      FindBlockLinkHead(head.pc, true)->first = head.first;
+  }
+
+  DEV_LOG("Rehashed {} block link heads into {} slots", num_live_heads, new_size);
+}
+
+CPU::CodeCache::BlockLinkIndex CPU::CodeCache::AddBlockLink(u32 pc, void* code)
+{
+  BlockLinkIndex index = s_free_block_link;
+  if (index != INVALID_BLOCK_LINK)
+  {
+    s_free_block_link = s_block_links[index].next;
+  }
+  else
+  {
+    index = static_cast<BlockLinkIndex>(s_block_links.size());
+    s_block_links.emplace_back();
+  }
+
+  BlockLinkHead* head = FindBlockLinkHead(pc, true);
+  BlockLink& link = s_block_links[index];
+  link.code = code;
+  link.pc = pc;
+  link.prev = INVALID_BLOCK_LINK;
+  link.next = head->first;
+  if (head->first != INVALID_BLOCK_LINK)
+    s_block_links[head->first].prev = index;
+  head->first = index;
+  s_statistics.links_added++;
+  return index;
+}
+
+void CPU::CodeCache::RemoveBlockLink(BlockLinkIndex index)
+{
+  BlockLink& link = s_block_links[index];
+  if (link.prev != INVALID_BLOCK_LINK)
+  {
+    s_block_links[link.prev].next = link.next;
+  }
+  else
+  {
+    BlockLinkHead* head = FindBlockLinkHead(link.pc, false);
+    DebugAssert(head && head->first == index);
+    head->first = link.next;
+  }
+  if (link.next != INVALID_BLOCK_LINK)
+    s_block_links[link.next].prev = link.prev;
+
+  // push onto the free list
+  link.code = nullptr;
+  link.prev = INVALID_BLOCK_LINK;
+  link.next = s_free_block_link;
+  s_free_block_link = index;
+  s_statistics.links_removed++;
+}
+
+void CPU::CodeCache::ClearBlockLinks()
+{
+  s_block_links.clear();
+  s_free_block_link = INVALID_BLOCK_LINK;
+  std::fill(s_block_link_heads.begin(), s_block_link_heads.end(),
+            BlockLinkHead{EMPTY_BLOCK_LINK_HEAD_PC, INVALID_BLOCK_LINK});
+  s_block_link_head_count = 0;
+}
+
 void CPU::CodeCache::ResetCodeBuffer()
 {
   if (s_code_used > 0 || s_far_code_used > 0)
@@ -1537,6 +2090,14 @@ const void* CPU::CodeCache::GetInterpretUncachedBlockFunction()
   }
 }
 
+const void* CPU::CodeCache::GetRunEventsFunction()
+{
+  if (g_settings.cpu_recompiler_superblocks)
+    return reinterpret_cast<const void*>(&RunEventsAndSampleHotBlock);
+  else
+    return reinterpret_cast<const void*>(&TimingEvents::RunEvents);
+}
+
 void CPU::CodeCache::CompileASMFunctions()
 {
   MemMap::BeginCodeWrite();
@@ -10,6 +10,17 @@ class Error;
 
 namespace CPU::CodeCache {
 
+/// Invalidation and block link counters since the last reset, for benchmarking.
+struct Statistics
+{
+  u64 page_invalidations;
+  u64 page_invalidation_ticks; // host Timer ticks
+  u64 blocks_invalidated;
+  u64 links_added;
+  u64 links_removed;
+  u64 links_patched;
+};
+
 /// Returns true if any recompiler is in use.
 bool IsUsingRecompiler();
 
@@ -37,4 +48,10 @@ void InvalidateBlocksWithPageIndex(u32 page_index);
 /// Invalidates all blocks in the cache.
 void InvalidateAllRAMBlocks();
 
+/// Returns invalidation and block link counters.
+const Statistics& GetStatistics();
+
+/// Compiles blocks from the persistent block cache whose guest code is currently present in memory.
+void PrecompileCachedBlocks();
+
 } // namespace CPU::CodeCache
@@ -21,12 +21,13 @@ enum : u32
   LUT_TABLE_SIZE = 0x10000 / sizeof(u32), // 16384, one for each PC
   LUT_TABLE_SHIFT = 16,
 
-  MAX_BLOCK_EXIT_LINKS = 2,
+  MAX_SUPERBLOCK_BRANCHES = 4,
+  MAX_BLOCK_EXIT_LINKS = 2 + MAX_SUPERBLOCK_BRANCHES,
 };
 
 using CodeLUT = const void**;
 using CodeLUTArray = std::array<CodeLUT, LUT_TABLE_COUNT>;
-using BlockLinkMap = std::unordered_multimap<u32, void*>; // TODO: try ordered?
+using BlockLinkIndex = u32; // index into the flat link pool, see BacklinkBlocks()
 
 enum RegInfoFlags : u8
 {
@@ -89,6 +90,7 @@ enum class BlockFlags : u8
   BranchDelaySpansPages = (1 << 2),
   IsUsingICache = (1 << 3),
   NeedsDynamicFetchTicks = (1 << 4),
+  Superblock = (1 << 5),
 };
 IMPLEMENT_ENUM_CLASS_BITWISE_OPERATORS(BlockFlags);
 
@@ -115,7 +117,7 @@ struct alignas(16) Block
   // links to previous/next block within page
   Block* next_block_in_page;
 
-  BlockLinkMap::iterator exit_links[MAX_BLOCK_EXIT_LINKS];
+  BlockLinkIndex exit_links[MAX_BLOCK_EXIT_LINKS];
   u8 num_exit_links;
 
   // TODO: Move up so it's part of the same cache line
@@ -129,6 +131,7 @@ struct alignas(16) Block
   u32 host_code_size;
   u32 compile_frame;
   u8 compile_count;
+  u8 sample_count;
 
   // followed by Instruction * size, InstructionRegInfo * size
   ALWAYS_INLINE const Instruction* Instructions() const { return reinterpret_cast<const Instruction*>(this + 1); }
@@ -233,6 +236,7 @@ void CommitFarCode(u32 length);
 void AlignCode(u32 alignment);
 
 const void* GetInterpretUncachedBlockFunction();
+const void* GetRunEventsFunction();
 
 void CompileOrRevalidateBlock(u32 start_pc);
 void DiscardAndRecompileBlock(u32 start_pc);
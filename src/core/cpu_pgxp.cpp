@@ -19,6 +19,7 @@
 #include "common/assert.h"
 #include "common/log.h"
 
+#include <array>
 #include <climits>
 #include <cmath>
 
@@ -38,8 +39,15 @@ enum : u32
   VERTEX_CACHE_SIZE = VERTEX_CACHE_WIDTH * VERTEX_CACHE_HEIGHT,
   PGXP_MEM_SIZE = (static_cast<u32>(Bus::RAM_8MB_SIZE) + static_cast<u32>(CPU::SCRATCHPAD_SIZE)) / 4,
   PGXP_MEM_SCRATCH_OFFSET = Bus::RAM_8MB_SIZE / 4,
+
+  // Dirty tracking granularity, one page covers 4KB of guest memory.
+  PGXP_MEM_PAGE_SHIFT = 10,
+  PGXP_MEM_PAGE_SIZE = 1u << PGXP_MEM_PAGE_SHIFT,
+  PGXP_MEM_PAGE_COUNT = (PGXP_MEM_SIZE + PGXP_MEM_PAGE_SIZE - 1) / PGXP_MEM_PAGE_SIZE,
 };
 
+using PGXPMemPageBitmap = std::array<u64, (PGXP_MEM_PAGE_COUNT + 63) / 64>;
+
 enum : u32
 {
   VALID_X = (1u << 0),
@@ -84,6 +92,10 @@ static void SetRtValue(Instruction instr, const PGXPValue& val, u32 rtVal);
 static void PushScreenXYFIFO();
 
 static PGXPValue* GetPtr(u32 addr);
+static PGXPValue* GetPtrForWrite(u32 addr);
+static bool IsMemPageDirty(const PGXPMemPageBitmap& bitmap, u32 page);
+static bool IsMemPageDirty(const PGXPValue* ptr);
+static u32 GetMemPageValueCount(u32 page);
 static const PGXPValue& ValidateAndLoadMem(u32 addr, u32 value);
 static void ValidateAndLoadMem16(PGXPValue& dest, u32 addr, u32 value, bool sign);
 
@@ -122,7 +134,10 @@ static void LogValueStr(SmallStringBase& str, const char* name, u32 rval, const
 
 static constexpr const PGXPValue INVALID_VALUE = {};
 
+// Shadow memory is allocated zeroed, so the OS only backs the pages which get written. Those pages are tracked, so
+// that resetting and saving state only has to touch what the game has actually used.
 static PGXPValue* s_mem = nullptr;
+static PGXPMemPageBitmap s_mem_dirty_pages = {};
 static PGXPValue* s_vertex_cache = nullptr;
 
 #ifdef LOG_VALUES
@@ -158,9 +173,10 @@ void CPU::PGXP::Initialize()
       g_settings.gpu_pgxp_vertex_cache = false;
     }
   }
-
-  if (s_vertex_cache)
+  else if (s_vertex_cache)
+  {
     std::memset(s_vertex_cache, 0, sizeof(PGXPValue) * VERTEX_CACHE_SIZE);
+  }
 }
 
 void CPU::PGXP::Reset()
@@ -170,7 +186,14 @@ void CPU::PGXP::Reset()
   std::memset(g_state.pgxp_gte, 0, sizeof(g_state.pgxp_gte));
 
   if (s_mem)
-    std::memset(s_mem, 0, sizeof(PGXPValue) * PGXP_MEM_SIZE);
+  {
+    for (u32 page = 0; page < PGXP_MEM_PAGE_COUNT; page++)
+    {
+      if (IsMemPageDirty(s_mem_dirty_pages, page))
+        std::memset(&s_mem[page << PGXP_MEM_PAGE_SHIFT], 0, sizeof(PGXPValue) * GetMemPageValueCount(page));
+    }
+  }
+  s_mem_dirty_pages = {};
 
   if (g_settings.gpu_pgxp_vertex_cache && s_vertex_cache)
     std::memset(s_vertex_cache, 0, sizeof(PGXPValue) * VERTEX_CACHE_SIZE);
@@ -188,6 +211,7 @@ void CPU::PGXP::Shutdown()
     std::free(s_mem);
     s_mem = nullptr;
   }
+  s_mem_dirty_pages = {};
 
   std::memset(g_state.pgxp_gte, 0, sizeof(g_state.pgxp_gte));
   std::memset(g_state.pgxp_gpr, 0, sizeof(g_state.pgxp_gpr));
@@ -206,8 +230,9 @@ size_t CPU::PGXP::GetStateSize()
   if (!ShouldSavePGXPState())
     return 0;
 
+  // worst case, every page has been written
   const size_t base_size = sizeof(g_state.pgxp_gpr) + sizeof(g_state.pgxp_cop0) + sizeof(g_state.pgxp_gte) +
-                           (sizeof(PGXPValue) * PGXP_MEM_SIZE);
+                           sizeof(s_mem_dirty_pages) + (sizeof(PGXPValue) * PGXP_MEM_SIZE);
   const size_t vertex_cache_size = sizeof(PGXPValue) * VERTEX_CACHE_SIZE;
   return base_size + (g_settings.gpu_pgxp_vertex_cache ? vertex_cache_size : 0);
 }
@@ -224,7 +249,34 @@ void CPU::PGXP::DoState(StateWrapper& sw)
   sw.DoBytes(g_state.pgxp_cop0, sizeof(g_state.pgxp_cop0));
   sw.DoBytes(g_state.pgxp_gte, sizeof(g_state.pgxp_gte));
 
-  sw.DoBytes(s_mem, sizeof(PGXPValue) * PGXP_MEM_SIZE);
+  // Only written pages are stored, the rest are still zero.
+  if (sw.IsReading())
+  {
+    PGXPMemPageBitmap state_dirty_pages;
+    sw.DoBytes(state_dirty_pages.data(), sizeof(state_dirty_pages));
+
+    for (u32 page = 0; page < PGXP_MEM_PAGE_COUNT; page++)
+    {
+      PGXPValue* const page_ptr = &s_mem[page << PGXP_MEM_PAGE_SHIFT];
+      const u32 page_size = sizeof(PGXPValue) * GetMemPageValueCount(page);
+      if (IsMemPageDirty(state_dirty_pages, page))
+        sw.DoBytes(page_ptr, page_size);
+      else if (IsMemPageDirty(s_mem_dirty_pages, page))
+        std::memset(page_ptr, 0, page_size);
+    }
+
+    s_mem_dirty_pages = state_dirty_pages;
+  }
+  else
+  {
+    sw.DoBytes(s_mem_dirty_pages.data(), sizeof(s_mem_dirty_pages));
+
+    for (u32 page = 0; page < PGXP_MEM_PAGE_COUNT; page++)
+    {
+      if (IsMemPageDirty(s_mem_dirty_pages, page))
+        sw.DoBytes(&s_mem[page << PGXP_MEM_PAGE_SHIFT], sizeof(PGXPValue) * GetMemPageValueCount(page));
+    }
+  }
 
   if (s_vertex_cache)
     sw.DoBytes(s_vertex_cache, sizeof(PGXPValue) * VERTEX_CACHE_SIZE);
@@ -308,10 +360,39 @@ ALWAYS_INLINE_RELEASE CPU::PGXPValue* CPU::PGXP::GetPtr(u32 addr)
     return nullptr;
 }
 
+ALWAYS_INLINE_RELEASE CPU::PGXPValue* CPU::PGXP::GetPtrForWrite(u32 addr)
+{
+  PGXPValue* ptr = GetPtr(addr);
+  if (ptr)
+  {
+    const u32 page = static_cast<u32>(ptr - s_mem) >> PGXP_MEM_PAGE_SHIFT;
+    s_mem_dirty_pages[page / 64] |= (UINT64_C(1) << (page % 64));
+  }
+
+  return ptr;
+}
+
+ALWAYS_INLINE bool CPU::PGXP::IsMemPageDirty(const PGXPMemPageBitmap& bitmap, u32 page)
+{
+  return ((bitmap[page / 64] & (UINT64_C(1) << (page % 64))) != 0);
+}
+
+ALWAYS_INLINE bool CPU::PGXP::IsMemPageDirty(const PGXPValue* ptr)
+{
+  return IsMemPageDirty(s_mem_dirty_pages, static_cast<u32>(ptr - s_mem) >> PGXP_MEM_PAGE_SHIFT);
+}
+
+ALWAYS_INLINE u32 CPU::PGXP::GetMemPageValueCount(u32 page)
+{
+  // scratchpad doesn't fill the last page
+  return std::min<u32>(PGXP_MEM_SIZE - (page << PGXP_MEM_PAGE_SHIFT), PGXP_MEM_PAGE_SIZE);
+}
+
 ALWAYS_INLINE_RELEASE const CPU::PGXPValue& CPU::PGXP::ValidateAndLoadMem(u32 addr, u32 value)
 {
+  // Values in pages which haven't been written are zero and can never validate, don't dirty them.
   PGXPValue* pMem = GetPtr(addr);
-  if (!pMem) [[unlikely]]
+  if (!pMem || !IsMemPageDirty(pMem)) [[unlikely]]
     return INVALID_VALUE;
 
   pMem->Validate(value);
@@ -326,6 +407,12 @@ ALWAYS_INLINE_RELEASE void CPU::PGXP::ValidateAndLoadMem16(PGXPValue& dest, u32
     dest = INVALID_VALUE;
     return;
   }
+  else if (!IsMemPageDirty(pMem))
+  {
+    dest = INVALID_VALUE;
+    dest.value = value;
+    return;
+  }
 
   // determine if high or low word
   const bool hiword = ((addr & 2) != 0);
@@ -362,7 +449,7 @@ ALWAYS_INLINE_RELEASE void CPU::PGXP::ValidateAndLoadMem16(PGXPValue& dest, u32
 
 ALWAYS_INLINE_RELEASE void CPU::PGXP::WriteMem(u32 addr, const PGXPValue& value)
 {
-  PGXPValue* pMem = GetPtr(addr);
+  PGXPValue* pMem = GetPtrForWrite(addr);
   if (!pMem) [[unlikely]]
     return;
 
@@ -373,7 +460,7 @@ ALWAYS_INLINE_RELEASE void CPU::PGXP::WriteMem(u32 addr, const PGXPValue& value)
 
 ALWAYS_INLINE_RELEASE void CPU::PGXP::WriteMem16(u32 addr, const PGXPValue& value)
 {
-  PGXPValue* dest = GetPtr(addr);
+  PGXPValue* dest = GetPtrForWrite(addr);
   if (!dest) [[unlikely]]
     return;
 
@@ -747,7 +834,7 @@ void CPU::PGXP::CPU_SW(Instruction instr, u32 addr, u32 rtVal)
 void CPU::PGXP::CPU_LWx(Instruction instr, u32 addr, u32 rtVal)
 {
   const u32 aligned_addr = addr & ~3u;
-  PGXPValue* pmemVal = GetPtr(aligned_addr);
+  PGXPValue* pmemVal = GetPtrForWrite(aligned_addr);
   u32 memVal;
   if (!pmemVal)
     return;
@@ -861,7 +948,7 @@ void CPU::PGXP::CPU_SWx(Instruction instr, u32 addr, u32 rtVal)
   LOG_VALUES_STORE(instr.r.rt.GetValue(), rtVal, addr);
 
   const u32 aligned_addr = addr & ~3u;
-  PGXPValue* pmemVal = GetPtr(aligned_addr);
+  PGXPValue* pmemVal = GetPtrForWrite(aligned_addr);
   u32 memVal;
   if (!pmemVal)
     return;
@@ -366,6 +366,10 @@ bool CPU::Recompiler::Recompiler::TrySwapDelaySlot(Reg rs, Reg rt, Reg rd)
   const u32 backup_instruction_pc = m_current_instruction_pc;
   const bool backup_instruction_delay_slot = m_current_instruction_branch_delay_slot;
 
+  // the not-taken path of superblocks carries on after the delay slot
+  if (BranchContinuesBlock())
+    goto is_unsafe;
+
   if (next_instruction->bits == 0)
   {
     // nop
@@ -1942,7 +1946,8 @@ void CPU::Recompiler::Recompiler::Compile_bxx_const(CompileFlags cf, BranchCondi
 
   const u32 taken_pc = GetConditionalBranchTarget(cf);
   CompileBranchDelaySlot();
-  EndBlock(taken ? taken_pc : m_compiler_pc, true);
+  if (taken || !BranchContinuesBlock())
+    EndBlock(taken ? taken_pc : m_compiler_pc, true);
 }
 
 void CPU::Recompiler::Recompiler::Compile_sll_const(CompileFlags cf)
@@ -254,6 +254,9 @@ protected:
   u32 GetConditionalBranchTarget(CompileFlags cf) const;
   u32 GetBranchReturnAddress(CompileFlags cf) const;
   bool TrySwapDelaySlot(Reg rs = Reg::zero, Reg rt = Reg::zero, Reg rd = Reg::zero);
+
+  /// Returns true if the block continues past the current branch's delay slot when not taken, i.e. superblocks.
+  bool BranchContinuesBlock() const { return !iinfo->is_last_instruction && !(iinfo + 1)->is_last_instruction; }
   void SetCompilerPC(u32 newpc);
   void TruncateBlock();
 
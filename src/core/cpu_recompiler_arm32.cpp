@@ -277,7 +277,7 @@ u32 CPU::CodeCache::EmitASMFunctions(void* code, u32 code_size)
 
     g_run_events_and_dispatch = armAsm->GetCursorAddress<const void*>();
     armAsm->bind(&run_events_and_dispatch);
-    armEmitCall(armAsm, reinterpret_cast<const void*>(&TimingEvents::RunEvents), true);
+    armEmitCall(armAsm, GetRunEventsFunction(), true);
 
     armAsm->bind(&skip_event_check);
   }
@@ -1176,6 +1176,24 @@ void CPU::ARM32Recompiler::Compile_bxx(CompileFlags cf, BranchCondition cond)
     break;
   }
 
+  if (BranchContinuesBlock())
+  {
+    // Superblock, taken path exits, not taken carries on with the rest of the block.
+    DebugAssert(!cf.delay_slot_swapped);
+    Label not_taken;
+    armAsm->b(&not_taken);
+
+    armAsm->bind(&taken);
+    BackupHostState();
+    CompileBranchDelaySlot();
+    EndBlock(taken_pc, true);
+    RestoreHostState();
+
+    armAsm->bind(&not_taken);
+    CompileBranchDelaySlot();
+    return;
+  }
+
   BackupHostState();
   if (!cf.delay_slot_swapped)
     CompileBranchDelaySlot();
@@ -477,7 +477,7 @@ u32 CPU::CodeCache::EmitASMFunctions(void* code, u32 code_size)
 
     g_run_events_and_dispatch = armAsm->GetCursorAddress<const void*>();
     armAsm->bind(&run_events_and_dispatch);
-    armEmitCall(armAsm, reinterpret_cast<const void*>(&TimingEvents::RunEvents), true);
+    armEmitCall(armAsm, GetRunEventsFunction(), true);
   }
 
   armAlignCode(armAsm, Recompiler::FUNCTION_ALIGNMENT);
@@ -1347,6 +1347,24 @@ void CPU::ARM64Recompiler::Compile_bxx(CompileFlags cf, BranchCondition cond)
     break;
   }
 
+  if (BranchContinuesBlock())
+  {
+    // Superblock, taken path exits, not taken carries on with the rest of the block.
+    DebugAssert(!cf.delay_slot_swapped);
+    Label not_taken;
+    armAsm->b(&not_taken);
+
+    armAsm->bind(&taken);
+    BackupHostState();
+    CompileBranchDelaySlot();
+    EndBlock(taken_pc, true);
+    RestoreHostState();
+
+    armAsm->bind(&not_taken);
+    CompileBranchDelaySlot();
+    return;
+  }
+
   BackupHostState();
   if (!cf.delay_slot_swapped)
     CompileBranchDelaySlot();
@@ -266,7 +266,7 @@ u32 CPU::CodeCache::EmitASMFunctions(void* code, u32 code_size)
 
     rvAsm->Bind(&run_events_and_dispatch);
     g_run_events_and_dispatch = rvAsm->GetCursorPointer();
-    rvEmitCall(rvAsm, reinterpret_cast<const void*>(&TimingEvents::RunEvents));
+    rvEmitCall(rvAsm, CodeCache::GetRunEventsFunction());
 
     rvAsm->Bind(&skip_event_check);
   }
@@ -1172,6 +1172,24 @@ void CPU::RISCV64Recompiler::Compile_bxx(CompileFlags cf, BranchCondition cond)
     break;
   }
 
+  if (BranchContinuesBlock())
+  {
+    // Superblock, taken path exits, not taken carries on with the rest of the block.
+    DebugAssert(!cf.delay_slot_swapped);
+    Label not_taken;
+    rvAsm->J(&not_taken);
+
+    rvAsm->Bind(&taken);
+    BackupHostState();
+    CompileBranchDelaySlot();
+    EndBlock(taken_pc, true);
+    RestoreHostState();
+
+    rvAsm->Bind(&not_taken);
+    CompileBranchDelaySlot();
+    return;
+  }
+
   BackupHostState();
   if (!cf.delay_slot_swapped)
     CompileBranchDelaySlot();
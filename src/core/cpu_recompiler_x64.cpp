@@ -144,7 +144,7 @@ u32 CPU::CodeCache::EmitASMFunctions(void* code, u32 code_size)
 
     g_run_events_and_dispatch = cg->getCurr();
     cg->L(run_events_and_dispatch);
-    cg->call(reinterpret_cast<const void*>(&TimingEvents::RunEvents));
+    cg->call(CodeCache::GetRunEventsFunction());
   }
 
   cg->align(FUNCTION_ALIGNMENT);
@@ -1113,6 +1113,24 @@ void CPU::X64Recompiler::Compile_bxx(CompileFlags cf, BranchCondition cond)
     break;
   }
 
+  if (BranchContinuesBlock())
+  {
+    // Superblock, taken path exits, not taken carries on with the rest of the block.
+    DebugAssert(!cf.delay_slot_swapped);
+    Label not_taken;
+    cg->jmp(not_taken, type);
+
+    cg->L(taken);
+    BackupHostState();
+    CompileBranchDelaySlot();
+    EndBlock(taken_pc, true);
+    RestoreHostState();
+
+    cg->L(not_taken);
+    CompileBranchDelaySlot();
+    return;
+  }
+
   BackupHostState();
   if (!cf.delay_slot_swapped)
     CompileBranchDelaySlot();
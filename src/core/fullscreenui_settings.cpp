@@ -2813,6 +2813,10 @@ void FullscreenUI::DrawEmulationSettingsPage()
     bsi, FSUI_ICONVSTR(ICON_FA_WHISKEY_GLASS, "Rewind Save Slots"),
     FSUI_VSTR("How many saves will be kept for rewinding. Higher values have greater memory requirements."), "Main",
     "RewindSaveSlots", 10, 1, 10000, FSUI_CSTR("%d Frames"), rewind_enabled && !runahead_enabled);
+  DrawToggleSetting(bsi, FSUI_ICONVSTR(ICON_FA_COMPRESS, "Compress Rewind States"),
+                    FSUI_VSTR("Stores rewind states as differences from the next state. Allows many more slots in the "
+                              "same amount of memory, at a small CPU cost."),
+                    "Main", "RewindCompression", false, rewind_enabled && !runahead_enabled);
 
   static constexpr const std::array runahead_options = {
     FSUI_NSTR("Disabled"), FSUI_NSTR("1 Frame"),  FSUI_NSTR("2 Frames"), FSUI_NSTR("3 Frames"),
@@ -2840,12 +2844,14 @@ void FullscreenUI::DrawEmulationSettingsPage()
     const u32 resolution_scale = GetEffectiveUIntSetting(bsi, "GPU", "ResolutionScale", 1);
     const float rewind_frequency = GetEffectiveFloatSetting(bsi, "Main", "RewindFrequency", 10.0f);
     const s32 rewind_save_slots = GetEffectiveIntSetting(bsi, "Main", "RewindSaveSlots", 10);
+    const bool rewind_compression = GetEffectiveBoolSetting(bsi, "Main", "RewindCompression", false);
     const float duration =
       ((rewind_frequency <= std::numeric_limits<float>::epsilon()) ? (1.0f / 60.0f) : rewind_frequency) *
       static_cast<float>(rewind_save_slots);
 
     u64 ram_usage, vram_usage;
-    System::CalculateRewindMemoryUsage(rewind_save_slots, resolution_scale, &ram_usage, &vram_usage);
+    System::CalculateRewindMemoryUsage(rewind_save_slots, resolution_scale, rewind_compression, &ram_usage,
+                                       &vram_usage);
     rewind_summary.format(
       FSUI_FSTR("Rewind for {0} frames, lasting {1:.2f} seconds will require up to {2} MB of RAM and {3} MB of VRAM."),
       rewind_save_slots, duration, ram_usage / 1048576, vram_usage / 1048576);
@@ -3847,6 +3853,11 @@ void FullscreenUI::DrawGraphicsSettingsPage()
                               "particularly with the software renderer, and is safe to use."),
                     "GPU", "UseThread", true);
 
+  DrawIntRangeSetting(bsi, FSUI_ICONVSTR(ICON_FA_MICROCHIP, "Software Renderer Threads"),
+                      FSUI_VSTR("Splits drawing in the software renderer across multiple threads. Experimental. 0 "
+                                "uses up to half of the available CPU cores."),
+                      "GPU", "SoftwareRendererThreads", 1, 0, 16, FSUI_CSTR("%d Threads"), !is_hardware);
+
   DrawToggleSetting(bsi, FSUI_ICONVSTR(ICON_FA_ARROWS_UP_DOWN_LEFT_RIGHT, "Automatically Resize Window"),
                     FSUI_VSTR("Automatically resizes the window to match the internal resolution."), "Display",
                     "AutoResizeWindow", false);
@@ -4885,6 +4896,15 @@ void FullscreenUI::DrawAdvancedSettingsPage()
     bsi, FSUI_VSTR("Enable Recompiler Block Linking"),
     FSUI_VSTR("Performance enhancement - jumps directly between blocks instead of returning to the dispatcher."), "CPU",
     "RecompilerBlockLinking", true);
+  DrawToggleSetting(bsi, FSUI_VSTR("Enable Recompiler Block Cache"),
+                    FSUI_VSTR("Remembers compiled blocks per game, and compiles them up front when loading states."),
+                    "CPU", "RecompilerBlockCache", false);
+  DrawToggleSetting(bsi, FSUI_VSTR("Enable Recompiler Deferred Compilation"),
+                    FSUI_VSTR("Interprets new blocks once the per-frame compile budget is used, reducing stutter."),
+                    "CPU", "RecompilerDeferredCompilation", false);
+  DrawToggleSetting(bsi, FSUI_VSTR("Enable Recompiler Superblocks"),
+                    FSUI_VSTR("Recompiles frequently-executed blocks together with their fall-through successors."),
+                    "CPU", "RecompilerSuperblocks", false);
   DrawEnumSetting(bsi, FSUI_VSTR("Recompiler Fast Memory Access"),
                   FSUI_VSTR("Avoids calls to C++ code, significantly speeding up the recompiler."), "CPU",
                   "FastmemMode", Settings::DEFAULT_CPU_FASTMEM_MODE, &Settings::ParseCPUFastmemMode,
@@ -4911,6 +4931,10 @@ void FullscreenUI::DrawAdvancedSettingsPage()
     bsi, FSUI_VSTR("Disable Speedup on MDEC"),
     FSUI_VSTR("Tries to detect FMVs and disable read speedup during games that don't use XA streaming audio."), "CDROM",
     "DisableSpeedupOnMDEC", false);
+  DrawToggleSetting(bsi, FSUI_VSTR("Use MDEC Worker Thread"),
+                    FSUI_VSTR("Decodes the current FMV macroblock on a separate thread while the CPU keeps running. "
+                              "Experimental, only one macroblock can be in flight."),
+                    "Hacks", "MDECWorkerThread", false);
 
   DrawToggleSetting(bsi, FSUI_VSTR("Enable Region Check"),
                     FSUI_VSTR("Simulates the region check present in original, unmodified consoles."), "CDROM",
@@ -22,6 +22,8 @@
 
 #include "ryml.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <bit>
 #include <iomanip>
 #include <memory>
@@ -166,7 +168,7 @@ static DisplayDeinterlacingMode DEFAULT_DEINTERLACING_MODE = DisplayDeinterlacin
 namespace {
 struct State
 {
-  bool loaded;
+  std::atomic_bool loaded{false};
   bool track_hashes_loaded;
 
   DynamicHeapArray<u8> db_data;          // we take strings from the data, so store a copy
@@ -188,7 +190,8 @@ ALIGN_TO_CACHE_LINE static State s_state;
 
 void GameDatabase::EnsureLoaded()
 {
-  if (s_state.loaded)
+  // Game list scanning looks up entries from several threads, so this needs to pair with the store in Load().
+  if (s_state.loaded.load(std::memory_order_acquire))
     return;
 
   std::call_once(s_state.load_once_flag, &GameDatabase::Load);
@@ -218,7 +221,7 @@ void GameDatabase::Load()
     }
   }
 
-  s_state.loaded = true;
+  s_state.loaded.store(true, std::memory_order_release);
 
   INFO_LOG("Database load of {} entries took {:.0f}ms.", s_state.entries.size(), timer.GetTimeMilliseconds());
 }
@@ -1818,3 +1821,60 @@ const GameDatabase::TrackHashesMap& GameDatabase::GetTrackHashesMap()
   EnsureTrackHashesMapLoaded();
   return s_state.track_hashes_map;
 }
+
+const GameDatabase::TrackData* GameDatabase::MatchTrackHashes(std::span<const CDImageHasher::Hash> track_hashes,
+                                                               std::vector<bool>* track_results)
+{
+  track_results->assign(track_hashes.size(), false);
+  if (track_hashes.empty())
+    return nullptr;
+
+  // Verification strategy used:
+  // 1. First, find all matches for the data track
+  //    If none are found, fail verification for all tracks
+  // 2. For each data track match, try to match all audio tracks
+  //    If all match, assume this revision. Else, try other revisions,
+  //    and accept the one with the most matches.
+  const TrackHashesMap& hashes_map = GetTrackHashesMap();
+  const auto data_track_matches = hashes_map.equal_range(track_hashes.front());
+  if (data_track_matches.first == data_track_matches.second)
+    return nullptr;
+
+  auto best_data_match = data_track_matches.second;
+  size_t best_matches_count = 0;
+  std::vector<bool> current_results(track_hashes.size());
+  for (auto iter = data_track_matches.first; iter != data_track_matches.second; ++iter)
+  {
+    const TrackData& data_track_attribs = iter->second;
+    std::fill(current_results.begin(), current_results.end(), false);
+    current_results[0] = true; // Data track already matched
+
+    for (size_t i = 1; i < track_hashes.size(); i++)
+    {
+      const auto audio_track_matches = hashes_map.equal_range(track_hashes[i]);
+      for (auto audio_iter = audio_track_matches.first; audio_iter != audio_track_matches.second; ++audio_iter)
+      {
+        // If audio track comes from the same revision and code as the data track, "pass" it
+        if (audio_iter->second == data_track_attribs)
+        {
+          current_results[i] = true;
+          break;
+        }
+      }
+    }
+
+    const size_t matches_count = static_cast<size_t>(std::count(current_results.begin(), current_results.end(), true));
+    if (matches_count > best_matches_count)
+    {
+      best_data_match = iter;
+      best_matches_count = matches_count;
+      *track_results = current_results;
+
+      // If all elements got matched, early out
+      if (matches_count == track_hashes.size())
+        break;
+    }
+  }
+
+  return &best_data_match->second;
+}
@@ -11,6 +11,7 @@
 
 #include <bitset>
 #include <map>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -236,4 +237,8 @@ using TrackHashesMap = std::multimap<CDImageHasher::Hash, TrackData>;
 const TrackHashesMap& GetTrackHashesMap();
 void EnsureTrackHashesMapLoaded();
 
+/// Finds the known dump which matches the most tracks, and sets track_results to which tracks matched it.
+/// Returns nullptr if the data track (the first hash) doesn't match any known dump.
+const TrackData* MatchTrackHashes(std::span<const CDImageHasher::Hash> track_hashes, std::vector<bool>* track_results);
+
 } // namespace GameDatabase
@@ -28,6 +28,7 @@
 #include "common/progress_callback.h"
 #include "common/string_pool.h"
 #include "common/string_util.h"
+#include "common/task_queue.h"
 #include "common/thirdparty/SmallVector.h"
 #include "common/time_helpers.h"
 #include "common/timer.h"
@@ -39,6 +40,7 @@
 #include <bit>
 #include <ctime>
 #include <string_view>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -57,6 +59,14 @@ enum : u32
   GAME_LIST_CACHE_SIGNATURE = 0x45434C48,
   GAME_LIST_CACHE_VERSION = 39,
 
+  // Cache is an append-only journal, rewrite it once most of the records are stale.
+  GAME_LIST_CACHE_COMPACT_MIN_RECORDS = 256,
+  GAME_LIST_CACHE_COMPACT_RATIO = 2,
+
+  // Scanning is mostly I/O and decompression bound, don't use too many threads.
+  MAX_SCAN_THREADS = 8,
+  SCAN_BATCH_SIZE_PER_THREAD = 4,
+
   PLAYED_TIME_SERIAL_LENGTH = 32,
   PLAYED_TIME_LAST_TIME_LENGTH = 20,  // uint64
   PLAYED_TIME_TOTAL_TIME_LENGTH = 20, // uint64
@@ -64,6 +74,13 @@ enum : u32
     PLAYED_TIME_SERIAL_LENGTH + 1 + PLAYED_TIME_LAST_TIME_LENGTH + 1 + PLAYED_TIME_TOTAL_TIME_LENGTH,
 };
 
+struct PendingScan
+{
+  std::string path;
+  std::string path_in_cache;
+  std::time_t timestamp;
+};
+
 struct PlayedTimeEntry
 {
   std::time_t last_played_time;
@@ -114,13 +131,19 @@ static void ScanDirectory(const std::string& path, bool recursive, bool only_cac
 static bool AddFileFromCache(const std::string& path, const std::string& path_in_cache, std::time_t timestamp,
                              const PlayedTimeMap& played_time_map, const INISettingsInterface& custom_attributes_ini,
                              const Achievements::ProgressDatabase& achievements_progress);
-static void ScanFile(std::string path, std::time_t timestamp, std::unique_lock<std::recursive_mutex>& lock,
-                     const PlayedTimeMap& played_time_map, const INISettingsInterface& custom_attributes_ini,
+static void ScanFiles(std::vector<PendingScan>& files, const PlayedTimeMap& played_time_map,
+                      const INISettingsInterface& custom_attributes_ini,
+                      const Achievements::ProgressDatabase& achievements_progress, BinaryFileWriter& cache_writer,
+                      ProgressCallback* progress, u32 progress_base);
+static void ScanFile(std::string path, std::time_t timestamp, const PlayedTimeMap& played_time_map,
+                     const INISettingsInterface& custom_attributes_ini,
                      const Achievements::ProgressDatabase& achievements_progress, const std::string& path_for_cache,
-                     BinaryFileWriter& cache_writer);
+                     Entry* entry);
+static void AddScannedEntry(Entry entry, const std::string& path_for_cache, BinaryFileWriter& cache_writer);
 
 static bool LoadOrInitializeCache(std::FILE* fp, bool invalidate_cache);
-static bool LoadEntriesFromCache(BinaryFileReader& reader);
+static bool LoadEntriesFromCache(BinaryFileReader& reader, u32* record_count);
+static bool CompactCache(std::FILE* fp);
 static bool WriteEntryToCache(const Entry* entry, const std::string& entry_path, BinaryFileWriter& writer);
 static void CreateDiscSetEntries(const std::vector<std::string>& excluded_paths, const PlayedTimeMap& played_time_map);
 
@@ -445,8 +468,10 @@ bool GameList::GetGameListEntryFromCache(const std::string& path, Entry* entry,
   return true;
 }
 
-bool GameList::LoadEntriesFromCache(BinaryFileReader& reader)
+bool GameList::LoadEntriesFromCache(BinaryFileReader& reader, u32* record_count)
 {
+  *record_count = 0;
+
   u32 file_signature, file_version;
   if (!reader.ReadU32(&file_signature) || !reader.ReadU32(&file_version) ||
       file_signature != GAME_LIST_CACHE_SIGNATURE || file_version != GAME_LIST_CACHE_VERSION)
@@ -477,6 +502,7 @@ bool GameList::LoadEntriesFromCache(BinaryFileReader& reader)
     ge.path = path;
     ge.region = static_cast<DiscRegion>(region);
     ge.type = static_cast<EntryType>(type);
+    (*record_count)++;
 
     auto iter = s_state.cache_map.find(ge.path);
     if (iter != s_state.cache_map.end())
@@ -507,8 +533,17 @@ bool GameList::WriteEntryToCache(const Entry* entry, const std::string& entry_pa
 bool GameList::LoadOrInitializeCache(std::FILE* fp, bool invalidate_cache)
 {
   BinaryFileReader reader(fp);
-  if (!invalidate_cache && !reader.IsAtEnd() && LoadEntriesFromCache(reader))
+  u32 record_count;
+  if (!invalidate_cache && !reader.IsAtEnd() && LoadEntriesFromCache(reader, &record_count))
   {
+    // Rescanned files get appended, so drop the stale records if there's a lot of them.
+    if (record_count >= GAME_LIST_CACHE_COMPACT_MIN_RECORDS &&
+        record_count >= (s_state.cache_map.size() * GAME_LIST_CACHE_COMPACT_RATIO))
+    {
+      INFO_LOG("Compacting game list cache from {} to {} records.", record_count, s_state.cache_map.size());
+      return CompactCache(fp);
+    }
+
     // Prepare for writing.
     return (FileSystem::FSeek64(fp, 0, SEEK_END) == 0);
   }
@@ -538,6 +573,30 @@ bool GameList::LoadOrInitializeCache(std::FILE* fp, bool invalidate_cache)
   return true;
 }
 
+bool GameList::CompactCache(std::FILE* fp)
+{
+  Error error;
+  if (!FileSystem::FSeek64(fp, 0, SEEK_SET, &error) || !FileSystem::FTruncate64(fp, 0, &error))
+  {
+    ERROR_LOG("Failed to truncate game list cache: {}", error.GetDescription());
+    return false;
+  }
+
+  BinaryFileWriter writer(fp);
+  writer.WriteU32(GAME_LIST_CACHE_SIGNATURE);
+  writer.WriteU32((GAME_LIST_CACHE_VERSION));
+  for (const auto& [path, entry] : s_state.cache_map)
+    WriteEntryToCache(&entry, path, writer);
+
+  if (!writer.Flush(&error))
+  {
+    ERROR_LOG("Failed to write compacted game list cache: {}", error.GetDescription());
+    return false;
+  }
+
+  return true;
+}
+
 static bool IsPathExcluded(const std::vector<std::string>& excluded_paths, const std::string_view& path)
 {
   return std::find_if(excluded_paths.begin(), excluded_paths.end(),
@@ -573,6 +632,8 @@ void GameList::ScanDirectory(const std::string& path, bool recursive, bool only_
   progress->SetProgressRange(static_cast<u32>(files.size()));
   progress->SetProgressValue(0);
 
+  // Cache lookups are cheap, so do them first, then open the remaining images in parallel.
+  std::vector<PendingScan> pending_files;
   u32 files_scanned = 0;
   for (FILESYSTEM_FIND_DATA& ffd : files)
   {
@@ -599,11 +660,13 @@ void GameList::ScanDirectory(const std::string& path, bool recursive, bool only_
       continue;
     }
 
-    progress->SetStatusText(SmallString::from_format(TRANSLATE_FS("GameList", "Scanning '{}'..."),
-                                                     FileSystem::GetDisplayNameFromPath(ffd.FileName)));
-    ScanFile(std::move(ffd.FileName), ffd.ModificationTime, lock, played_time_map, custom_attributes_ini,
-             achievements_progress, path_in_cache, cache_writer);
-    progress->SetProgressValue(files_scanned);
+    pending_files.push_back(PendingScan{std::move(ffd.FileName), std::move(path_in_cache), ffd.ModificationTime});
+  }
+
+  if (!pending_files.empty() && !progress->IsCancelled())
+  {
+    ScanFiles(pending_files, played_time_map, custom_attributes_ini, achievements_progress, cache_writer, progress,
+              files_scanned - static_cast<u32>(pending_files.size()));
   }
 
   progress->SetProgressValue(files_scanned);
@@ -641,39 +704,83 @@ bool GameList::AddFileFromCache(const std::string& path, const std::string& path
   return true;
 }
 
-void GameList::ScanFile(std::string path, std::time_t timestamp, std::unique_lock<std::recursive_mutex>& lock,
-                        const PlayedTimeMap& played_time_map, const INISettingsInterface& custom_attributes_ini,
-                        const Achievements::ProgressDatabase& achievements_progress, const std::string& path_for_cache,
-                        BinaryFileWriter& cache_writer)
+void GameList::ScanFiles(std::vector<PendingScan>& files, const PlayedTimeMap& played_time_map,
+                         const INISettingsInterface& custom_attributes_ini,
+                         const Achievements::ProgressDatabase& achievements_progress, BinaryFileWriter& cache_writer,
+                         ProgressCallback* progress, u32 progress_base)
 {
-  // don't block UI while scanning
-  lock.unlock();
+  const u32 num_threads = std::clamp<u32>(std::thread::hardware_concurrency(), 1, MAX_SCAN_THREADS);
+  const size_t batch_size = num_threads * SCAN_BATCH_SIZE_PER_THREAD;
+
+  // Calling thread also scans while waiting.
+  TaskQueue queue;
+  queue.SetWorkerCount(num_threads - 1);
+
+  // Work in batches, so progress/cancellation stay responsive and the cache is written as we go.
+  std::vector<Entry> entries(std::min(batch_size, files.size()));
+  for (size_t batch_start = 0; batch_start < files.size(); batch_start += batch_size)
+  {
+    if (progress->IsCancelled())
+      break;
+
+    const size_t batch_count = std::min(batch_size, files.size() - batch_start);
+    progress->SetStatusText(SmallString::from_format(TRANSLATE_FS("GameList", "Scanning '{}'..."),
+                                                     FileSystem::GetDisplayNameFromPath(files[batch_start].path)));
+
+    // Each task only touches its own entry, no need to lock until the results are merged.
+    for (size_t i = 0; i < batch_count; i++)
+    {
+      queue.SubmitTask([&file = files[batch_start + i], entry = &entries[i], &played_time_map, &custom_attributes_ini,
+                        &achievements_progress]() {
+        ScanFile(std::move(file.path), file.timestamp, played_time_map, custom_attributes_ini, achievements_progress,
+                 file.path_in_cache, entry);
+      });
+    }
+    queue.WaitForAll();
 
+    {
+      std::unique_lock lock(s_state.mutex);
+      for (size_t i = 0; i < batch_count; i++)
+        AddScannedEntry(std::move(entries[i]), files[batch_start + i].path_in_cache, cache_writer);
+    }
+
+    progress->SetProgressValue(progress_base + static_cast<u32>(batch_start + batch_count));
+  }
+}
+
+void GameList::ScanFile(std::string path, std::time_t timestamp, const PlayedTimeMap& played_time_map,
+                        const INISettingsInterface& custom_attributes_ini,
+                        const Achievements::ProgressDatabase& achievements_progress, const std::string& path_for_cache,
+                        Entry* entry)
+{
   VERBOSE_LOG("Scanning '{}'...", path);
 
-  Entry entry;
-  if (PopulateEntryFromPath(path, &entry))
+  *entry = {};
+  if (PopulateEntryFromPath(path, entry))
   {
-    const auto iter = played_time_map.find(entry.serial);
+    const auto iter = played_time_map.find(entry->serial);
     if (iter != played_time_map.end())
     {
-      entry.last_played_time = iter->second.last_played_time;
-      entry.total_played_time = iter->second.total_played_time;
+      entry->last_played_time = iter->second.last_played_time;
+      entry->total_played_time = iter->second.total_played_time;
     }
 
-    ApplyCustomAttributes(path_for_cache.empty() ? path : path_for_cache, &entry, custom_attributes_ini);
+    ApplyCustomAttributes(path_for_cache.empty() ? path : path_for_cache, entry, custom_attributes_ini);
 
-    if (entry.IsDisc())
-      PopulateEntryAchievements(&entry, achievements_progress);
+    if (entry->IsDisc())
+      PopulateEntryAchievements(entry, achievements_progress);
   }
   else
   {
-    MakeInvalidEntry(&entry);
+    MakeInvalidEntry(entry);
   }
 
-  entry.path = std::move(path);
-  entry.last_modified_time = timestamp;
+  entry->path = std::move(path);
+  entry->last_modified_time = timestamp;
+}
 
+void GameList::AddScannedEntry(Entry entry, const std::string& path_for_cache, BinaryFileWriter& cache_writer)
+{
   // write the relative path to the cache if this is a relative scan
   if (cache_writer.IsOpen() &&
       !WriteEntryToCache(&entry, path_for_cache.empty() ? entry.path : path_for_cache, cache_writer)) [[unlikely]]
@@ -681,8 +788,6 @@ void GameList::ScanFile(std::string path, std::time_t timestamp, std::unique_loc
     WARNING_LOG("Failed to write entry '{}' to cache", entry.path);
   }
 
-  lock.lock();
-
   // don't add invalid entries to the list
   if (!entry.IsValid())
     return;
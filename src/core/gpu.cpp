@@ -1215,7 +1215,15 @@ void GPU::CRTCTickEvent(TickCount ticks)
         {
           m_gpu_dump->WriteVSync(System::GetGlobalTickCounter());
           if (m_gpu_dump->IsFinished()) [[unlikely]]
+          {
             StopRecordingGPUDump();
+          }
+          else if (m_gpu_dump->IsKeyframeDue() && m_fifo.IsEmpty() && m_blitter_state == BlitterState::Idle)
+          {
+            // keyframes can only go between commands, and need vram to be up to date
+            ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+            m_gpu_dump->WriteKeyframe();
+          }
         }
 
         // flush any pending draws and "scan out" the image
@@ -2160,9 +2168,13 @@ bool GPU::StartRecordingGPUDump(const char* path, u32 num_frames /* = 1 */)
   // ensure vram is up to date
   ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
 
+  const GPUDumpCompressionMode compress_mode =
+    Settings::ParseGPUDumpCompressionMode(Host::GetTinyStringSettingValue("GPU", "DumpCompressionMode"))
+      .value_or(Settings::DEFAULT_GPU_DUMP_COMPRESSION_MODE);
+
   std::string osd_key = fmt::format("GPUDump_{}", Path::GetFileName(path));
   Error error;
-  m_gpu_dump = GPUDump::Recorder::Create(path, System::GetGameSerial(), num_frames, &error);
+  m_gpu_dump = GPUDump::Recorder::Create(path, System::GetGameSerial(), num_frames, compress_mode, &error);
   if (!m_gpu_dump)
   {
     Host::AddIconOSDWarning(
@@ -2175,9 +2187,10 @@ bool GPU::StartRecordingGPUDump(const char* path, u32 num_frames /* = 1 */)
   Host::AddIconOSDMessage(
     std::move(osd_key), ICON_EMOJI_CAMERA_WITH_FLASH,
     (num_frames != 0) ?
-      fmt::format(TRANSLATE_FS("GPU", "Saving {0} frame GPU trace to '{1}'."), num_frames, Path::GetFileName(path)) :
+      fmt::format(TRANSLATE_FS("GPU", "Saving {0} frame GPU trace to '{1}'."), num_frames,
+                  Path::GetFileName(m_gpu_dump->GetPath())) :
       fmt::format(TRANSLATE_FS("GPU", "Saving multi-frame frame GPU trace to '{1}'."), num_frames,
-                  Path::GetFileName(path)),
+                  Path::GetFileName(m_gpu_dump->GetPath())),
     Host::OSD_QUICK_DURATION);
 
   // save screenshot to same location to identify it
@@ -2191,45 +2204,24 @@ void GPU::StopRecordingGPUDump()
   if (!m_gpu_dump)
     return;
 
-  Error error;
-  if (!m_gpu_dump->Close(&error))
-  {
-    Host::AddIconOSDWarning(
-      "GPUDump", ICON_EMOJI_CAMERA_WITH_FLASH,
-      fmt::format("{}\n{}", TRANSLATE_SV("GPU", "Failed to close GPU trace:"), error.GetDescription()),
-      Host::OSD_ERROR_DURATION);
-    m_gpu_dump.reset();
-  }
-
-  // Are we compressing the dump?
-  const GPUDumpCompressionMode compress_mode =
-    Settings::ParseGPUDumpCompressionMode(Host::GetTinyStringSettingValue("GPU", "DumpCompressionMode"))
-      .value_or(Settings::DEFAULT_GPU_DUMP_COMPRESSION_MODE);
+  // The writer thread may still have pages to compress, so finish the file off the emulation thread.
+  // Use a 60 second timeout to give it plenty of time to actually save.
   std::string osd_key = fmt::format("GPUDump_{}", Path::GetFileName(m_gpu_dump->GetPath()));
-  if (compress_mode == GPUDumpCompressionMode::Disabled)
+  if (m_gpu_dump->IsCompressed())
   {
     Host::AddIconOSDMessage(
-      "GPUDump", ICON_EMOJI_CAMERA_WITH_FLASH,
-      fmt::format(TRANSLATE_FS("GPU", "Saved GPU trace to '{}'."), Path::GetFileName(m_gpu_dump->GetPath())),
-      Host::OSD_QUICK_DURATION);
-    m_gpu_dump.reset();
-    return;
+      osd_key, ICON_EMOJI_CAMERA_WITH_FLASH,
+      fmt::format(TRANSLATE_FS("GPU", "Compressing GPU trace '{}'..."), Path::GetFileName(m_gpu_dump->GetPath())),
+      60.0f);
   }
-
-  std::string source_path = m_gpu_dump->GetPath();
-  m_gpu_dump.reset();
-
-  // Use a 60 second timeout to give it plenty of time to actually save.
-  Host::AddIconOSDMessage(
-    osd_key, ICON_EMOJI_CAMERA_WITH_FLASH,
-    fmt::format(TRANSLATE_FS("GPU", "Compressing GPU trace '{}'..."), Path::GetFileName(source_path)), 60.0f);
-  System::QueueAsyncTask([compress_mode, source_path = std::move(source_path), osd_key = std::move(osd_key)]() mutable {
+  System::QueueAsyncTask([dump = std::shared_ptr<GPUDump::Recorder>(std::move(m_gpu_dump)),
+                          osd_key = std::move(osd_key)]() mutable {
     Error error;
-    if (GPUDump::Recorder::Compress(source_path, compress_mode, &error))
+    if (dump->Close(&error))
     {
       Host::AddIconOSDMessage(
         std::move(osd_key), ICON_EMOJI_CAMERA_WITH_FLASH,
-        fmt::format(TRANSLATE_FS("GPU", "Saved GPU trace to '{}'."), Path::GetFileName(source_path)),
+        fmt::format(TRANSLATE_FS("GPU", "Saved GPU trace to '{}'."), Path::GetFileName(dump->GetPath())),
         Host::OSD_QUICK_DURATION);
     }
     else
@@ -2238,7 +2230,7 @@ void GPU::StopRecordingGPUDump()
         std::move(osd_key), ICON_EMOJI_CAMERA_WITH_FLASH,
         fmt::format("{}\n{}",
                     SmallString::from_format(TRANSLATE_FS("GPU", "Failed to save GPU trace to '{}':"),
-                                             Path::GetFileName(source_path)),
+                                             Path::GetFileName(dump->GetPath())),
                     error.GetDescription()),
         Host::OSD_ERROR_DURATION);
     }
@@ -22,6 +22,7 @@
 #include "common/log.h"
 #include "common/path.h"
 #include "common/threading.h"
+#include "common/timer.h"
 
 #include "IconsEmoji.h"
 #include "IconsFontAwesome6.h"
@@ -47,6 +48,8 @@ struct ALIGN_TO_CACHE_LINE CPUThreadState
 
 GPUBackend::Counters GPUBackend::s_counters = {};
 GPUBackend::Stats GPUBackend::s_stats = {};
+bool GPUBackend::s_command_profiling_enabled = false;
+GPUBackend::CommandProfile GPUBackend::s_command_profile = {};
 
 static CPUThreadState s_cpu_thread_state = {};
 
@@ -106,6 +109,7 @@ void GPUBackend::DrawScreenQuad(const GSVector4i bounds, const GSVector2i rt_siz
 
 bool GPUBackend::Initialize(bool clear_vram, Error* error)
 {
+  GPU_SW_Rasterizer::g_clip_area = GPU_SW_Rasterizer::g_drawing_area;
   m_clamped_drawing_area = GPU::GetClampedDrawingArea(GPU_SW_Rasterizer::g_drawing_area);
   return true;
 }
@@ -351,6 +355,7 @@ bool GPUBackend::AllocateMemorySaveStates(std::span<System::MemorySaveState> sta
 
       for (size_t i = 0; i < states.size(); i++)
       {
+        states[i].gpu_state_delta.deallocate();
         if (!backend->AllocateMemorySaveState(states[i], error))
         {
           // Try flushing the pool.
@@ -369,6 +374,8 @@ bool GPUBackend::AllocateMemorySaveStates(std::span<System::MemorySaveState> sta
             }
           }
         }
+
+        states[i].gpu_state_capacity = states[i].gpu_state_data.size();
       }
 
       backend->RestoreDeviceContext();
@@ -379,6 +386,17 @@ bool GPUBackend::AllocateMemorySaveStates(std::span<System::MemorySaveState> sta
 }
 
 void GPUBackend::HandleCommand(const GPUThreadCommand* cmd)
+{
+  if (s_command_profiling_enabled) [[unlikely]]
+  {
+    ProfileCommand(cmd);
+    return;
+  }
+
+  ExecuteCommand(cmd);
+}
+
+void GPUBackend::ExecuteCommand(const GPUThreadCommand* cmd)
 {
   switch (cmd->type)
   {
@@ -480,6 +498,7 @@ void GPUBackend::HandleCommand(const GPUThreadCommand* cmd)
     {
       const GPUBackendSetDrawingAreaCommand* ccmd = static_cast<const GPUBackendSetDrawingAreaCommand*>(cmd);
       GPU_SW_Rasterizer::g_drawing_area = ccmd->new_area;
+      GPU_SW_Rasterizer::g_clip_area = ccmd->new_area;
       m_clamped_drawing_area = GPU::GetClampedDrawingArea(ccmd->new_area);
       DrawingAreaChanged();
     }
@@ -488,7 +507,7 @@ void GPUBackend::HandleCommand(const GPUThreadCommand* cmd)
     case GPUBackendCommandType::UpdateCLUT:
     {
       const GPUBackendUpdateCLUTCommand* ccmd = static_cast<const GPUBackendUpdateCLUTCommand*>(cmd);
-      GPU_SW_Rasterizer::UpdateCLUT(ccmd->reg, ccmd->clut_is_8bit);
+      UpdateCLUT(ccmd->reg, ccmd->clut_is_8bit);
     }
     break;
 
@@ -541,6 +560,166 @@ void GPUBackend::HandleCommand(const GPUThreadCommand* cmd)
   }
 }
 
+static u64 GetTriangleArea(s32 x0, s32 y0, s32 x1, s32 y1, s32 x2, s32 y2)
+{
+  const s64 cross = static_cast<s64>(x1 - x0) * static_cast<s64>(y2 - y0) -
+                    static_cast<s64>(x2 - x0) * static_cast<s64>(y1 - y0);
+  return static_cast<u64>(std::abs(cross)) / 2;
+}
+
+static u64 GetLineLength(s32 x0, s32 y0, s32 x1, s32 y1)
+{
+  return static_cast<u64>(std::max(std::abs(x1 - x0), std::abs(y1 - y0))) + 1;
+}
+
+/// Estimates the work done by a command from its geometry. Clipping, masking and culling are not taken into account.
+static void GetCommandWorkload(const GPUThreadCommand* cmd, u64* primitives, u64* pixels)
+{
+  *primitives = 0;
+  *pixels = 0;
+
+  switch (cmd->type)
+  {
+    case GPUBackendCommandType::ReadVRAM:
+    {
+      const GPUBackendReadVRAMCommand* ccmd = static_cast<const GPUBackendReadVRAMCommand*>(cmd);
+      *pixels = static_cast<u64>(ccmd->width) * ccmd->height;
+    }
+    break;
+
+    case GPUBackendCommandType::FillVRAM:
+    {
+      const GPUBackendFillVRAMCommand* ccmd = static_cast<const GPUBackendFillVRAMCommand*>(cmd);
+      *pixels = static_cast<u64>(ccmd->width) * ccmd->height;
+    }
+    break;
+
+    case GPUBackendCommandType::UpdateVRAM:
+    {
+      const GPUBackendUpdateVRAMCommand* ccmd = static_cast<const GPUBackendUpdateVRAMCommand*>(cmd);
+      *pixels = static_cast<u64>(ccmd->width) * ccmd->height;
+    }
+    break;
+
+    case GPUBackendCommandType::CopyVRAM:
+    {
+      const GPUBackendCopyVRAMCommand* ccmd = static_cast<const GPUBackendCopyVRAMCommand*>(cmd);
+      *pixels = static_cast<u64>(ccmd->width) * ccmd->height;
+    }
+    break;
+
+    case GPUBackendCommandType::DrawPolygon:
+    {
+      const GPUBackendDrawPolygonCommand* ccmd = static_cast<const GPUBackendDrawPolygonCommand*>(cmd);
+      const GPUBackendDrawPolygonCommand::Vertex* v = ccmd->vertices;
+      *primitives = 1;
+      *pixels = GetTriangleArea(v[0].x, v[0].y, v[1].x, v[1].y, v[2].x, v[2].y);
+      if (ccmd->num_vertices == 4)
+        *pixels += GetTriangleArea(v[1].x, v[1].y, v[2].x, v[2].y, v[3].x, v[3].y);
+    }
+    break;
+
+    case GPUBackendCommandType::DrawPrecisePolygon:
+    {
+      const GPUBackendDrawPrecisePolygonCommand* ccmd = static_cast<const GPUBackendDrawPrecisePolygonCommand*>(cmd);
+      const GPUBackendDrawPrecisePolygonCommand::Vertex* v = ccmd->vertices;
+      *primitives = 1;
+      *pixels = GetTriangleArea(v[0].native_x, v[0].native_y, v[1].native_x, v[1].native_y, v[2].native_x,
+                                v[2].native_y);
+      if (ccmd->num_vertices == 4)
+      {
+        *pixels += GetTriangleArea(v[1].native_x, v[1].native_y, v[2].native_x, v[2].native_y, v[3].native_x,
+                                   v[3].native_y);
+      }
+    }
+    break;
+
+    case GPUBackendCommandType::DrawRectangle:
+    {
+      const GPUBackendDrawRectangleCommand* ccmd = static_cast<const GPUBackendDrawRectangleCommand*>(cmd);
+      *primitives = 1;
+      *pixels = static_cast<u64>(ccmd->width) * ccmd->height;
+    }
+    break;
+
+    case GPUBackendCommandType::DrawLine:
+    {
+      const GPUBackendDrawLineCommand* ccmd = static_cast<const GPUBackendDrawLineCommand*>(cmd);
+      *primitives = ccmd->num_vertices / 2;
+      for (u32 i = 0; (i + 1) < ccmd->num_vertices; i += 2)
+      {
+        *pixels += GetLineLength(ccmd->vertices[i].x, ccmd->vertices[i].y, ccmd->vertices[i + 1].x,
+                                 ccmd->vertices[i + 1].y);
+      }
+    }
+    break;
+
+    case GPUBackendCommandType::DrawPreciseLine:
+    {
+      const GPUBackendDrawPreciseLineCommand* ccmd = static_cast<const GPUBackendDrawPreciseLineCommand*>(cmd);
+      *primitives = ccmd->num_vertices / 2;
+      for (u32 i = 0; (i + 1) < ccmd->num_vertices; i += 2)
+      {
+        *pixels += GetLineLength(ccmd->vertices[i].native_x, ccmd->vertices[i].native_y,
+                                 ccmd->vertices[i + 1].native_x, ccmd->vertices[i + 1].native_y);
+      }
+    }
+    break;
+
+    default:
+      break;
+  }
+}
+
+void GPUBackend::ProfileCommand(const GPUThreadCommand* cmd)
+{
+  // A failed present can destroy the backend, so only statics are touched after executing.
+  u64 primitives, pixels;
+  GetCommandWorkload(cmd, &primitives, &pixels);
+
+  CommandProfileEntry& entry = s_command_profile[static_cast<size_t>(cmd->type)];
+  entry.count++;
+  entry.primitives += primitives;
+  entry.pixels += pixels;
+
+  const Timer::Value start_time = Timer::GetCurrentValue();
+  ExecuteCommand(cmd);
+  entry.time += Timer::GetCurrentValue() - start_time;
+}
+
+void GPUBackend::SetCommandProfilingEnabled(bool enabled)
+{
+  s_command_profiling_enabled = enabled;
+}
+
+bool GPUBackend::IsCommandProfilingEnabled()
+{
+  return s_command_profiling_enabled;
+}
+
+void GPUBackend::ResetCommandProfile()
+{
+  s_command_profile = {};
+}
+
+const GPUBackend::CommandProfile& GPUBackend::GetCommandProfile()
+{
+  return s_command_profile;
+}
+
+const char* GPUBackend::GetCommandTypeName(GPUBackendCommandType type)
+{
+  static constexpr const char* names[] = {
+    "Wraparound", "AsyncCall", "AsyncBackendCall", "Reconfigure", "UpdateSettings", "UpdateGameInfo", "Shutdown",
+    "ClearVRAM", "ClearDisplay", "UpdateDisplay", "SubmitFrame", "BufferSwapped", "LoadState", "LoadMemoryState",
+    "SaveMemoryState", "ReadVRAM", "FillVRAM", "UpdateVRAM", "CopyVRAM", "SetDrawingArea", "UpdateCLUT", "ClearCache",
+    "DrawPolygon", "DrawPrecisePolygon", "DrawRectangle", "DrawLine", "DrawPreciseLine",
+  };
+  static_assert(std::size(names) == NUM_GPU_BACKEND_COMMAND_TYPES);
+
+  return names[static_cast<size_t>(type)];
+}
+
 void GPUBackend::HandleUpdateDisplayCommand(const GPUBackendUpdateDisplayCommand* cmd)
 {
   // Height has to be doubled because we halved it on the GPU side.
@@ -559,6 +738,8 @@ void GPUBackend::HandleSubmitFrameCommand(const GPUBackendFramePresentationParam
   // For regtest.
   Host::FrameDoneOnGPUThread(this, cmd->frame_number);
 
+  GPUThread::Internal::UpdateIdleSpinTime();
+
   if (cmd->media_capture)
     m_presenter.SendDisplayToMediaCapture(cmd->media_capture);
 
@@ -836,6 +1017,7 @@ public:
   void DrawPreciseLine(const GPUBackendDrawPreciseLineCommand* cmd) override;
 
   void DrawingAreaChanged() override;
+  void UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit) override;
   void ClearCache() override;
   void OnBufferSwapped() override;
   void ClearVRAM() override;
@@ -921,6 +1103,11 @@ void GPUNullBackend::DrawingAreaChanged()
 {
 }
 
+void GPUNullBackend::UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit)
+{
+  GPU_SW_Rasterizer::UpdateCLUT(reg, clut_is_8bit);
+}
+
 void GPUNullBackend::ClearCache()
 {
 }
@@ -7,6 +7,7 @@
 
 #include "gpu_thread_commands.h"
 
+#include <array>
 #include <memory>
 
 class Error;
@@ -69,6 +70,23 @@ public:
 
   static bool AllocateMemorySaveStates(std::span<System::MemorySaveState> states, Error* error);
 
+  /// Workload and host time for each command type, collected while command profiling is enabled.
+  struct CommandProfileEntry
+  {
+    u64 count;
+    u64 primitives;
+    u64 pixels;
+    u64 time;
+  };
+  using CommandProfile = std::array<CommandProfileEntry, NUM_GPU_BACKEND_COMMAND_TYPES>;
+
+  /// Command profiling is used for benchmarking, and should only be changed while the GPU thread is idle.
+  static void SetCommandProfilingEnabled(bool enabled);
+  static bool IsCommandProfilingEnabled();
+  static void ResetCommandProfile();
+  static const CommandProfile& GetCommandProfile();
+  static const char* GetCommandTypeName(GPUBackendCommandType type);
+
 public:
   GPUBackend(GPUPresenter& presenter);
   virtual ~GPUBackend();
@@ -161,6 +179,7 @@ protected:
   virtual void DrawPreciseLine(const GPUBackendDrawPreciseLineCommand* cmd) = 0;
 
   virtual void DrawingAreaChanged() = 0;
+  virtual void UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit) = 0;
   virtual void ClearCache() = 0;
   virtual void OnBufferSwapped() = 0;
   virtual void ClearVRAM() = 0;
@@ -182,7 +201,13 @@ protected:
   static Stats s_stats;
 
 private:
+  void ExecuteCommand(const GPUThreadCommand* cmd);
+  void ProfileCommand(const GPUThreadCommand* cmd);
+
   static void ReleaseQueuedFrame();
+
+  static bool s_command_profiling_enabled;
+  static CommandProfile s_command_profile;
 };
 
 namespace Host {
@@ -5,6 +5,7 @@
 #include "gpu.h"
 #include "gpu_backend.h"
 #include "gpu_dump.h"
+#include "gpu_thread.h"
 #include "gpu_thread_commands.h"
 #include "interrupt_controller.h"
 #include "system.h"
@@ -111,7 +112,9 @@ void GPU::ExecuteCommands()
 {
   const bool was_executing_from_event = std::exchange(m_executing_commands, true);
 
+  GPUThread::BeginCommandBatch();
   TryExecuteCommands();
+  GPUThread::EndCommandBatch();
   UpdateDMARequest();
   UpdateGPUIdle();
 
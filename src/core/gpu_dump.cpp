@@ -6,6 +6,7 @@
 #include "cpu_core_private.h"
 #include "gpu.h"
 #include "settings.h"
+#include "system_private.h"
 
 #include "scmversion/scmversion.h"
 
@@ -18,11 +19,16 @@
 #include "common/fastjmp.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/memmap.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/threading.h"
 #include "common/timer.h"
 
 #include "fmt/format.h"
+#include "xxhash.h"
+
+#include <algorithm>
 
 LOG_CHANNEL(GPUDump);
 
@@ -32,15 +38,28 @@ static constexpr GPUVersion GPU_VERSION = GPUVersion::V2_1MB_VRAM;
 // Write the file header.
 static constexpr u8 FILE_HEADER[] = {'P', 'S', 'X', 'G', 'P', 'U', 'D', 'U', 'M', 'P', 'v', '1', '\0', '\0'};
 
+// Upper bound on threads compressing pages while recording, the emulation thread also needs a core.
+static constexpr u32 MAX_COMPRESS_WORKERS = 4;
+
+// Frame index, persisted in the cache directory so long dumps don't need to be scanned every time.
+static constexpr u32 INDEX_SIGNATURE = 0x58444950; // PIDX
+static constexpr u32 INDEX_VERSION = 2;
+
 }; // namespace GPUDump
 
-GPUDump::Recorder::Recorder(FileSystem::AtomicRenamedFile fp, u32 vsyncs_remaining, std::string path)
-  : m_fp(std::move(fp)), m_vsyncs_remaining(vsyncs_remaining), m_path(path)
+GPUDump::Recorder::Recorder(FileSystem::AtomicRenamedFile fp, u32 vsyncs_remaining, std::string path,
+                            CompressHelpers::CompressType compress_type, int compress_level)
+  : m_fp(std::move(fp)), m_vsyncs_remaining(vsyncs_remaining), m_compress_type(compress_type),
+    m_compress_level(compress_level), m_page(PAGE_SIZE), m_path(path)
 {
+  if (m_compress_type != CompressHelpers::CompressType::Uncompressed)
+    m_compress_queue.SetWorkerCount(std::min(std::thread::hardware_concurrency() / 2, MAX_COMPRESS_WORKERS));
 }
 
 GPUDump::Recorder::~Recorder()
 {
+  StopWriterThread();
+
   if (m_fp)
     FileSystem::DiscardAtomicRenamedFile(m_fp);
 }
@@ -56,25 +75,62 @@ bool GPUDump::Recorder::IsFinished()
 
 bool GPUDump::Recorder::Close(Error* error)
 {
-  if (m_write_error)
+  SubmitPage();
+  StopWriterThread();
+
+  if (m_write_error.load(std::memory_order_relaxed))
   {
-    Error::SetStringView(error, "Previous write error occurred.");
+    if (m_writer_error.IsValid() && error)
+      *error = m_writer_error;
+    else
+      Error::SetStringView(error, "Previous write error occurred.");
     return false;
   }
 
+  // Seek table goes at the end, so the player can stream chunks.
+  if (m_compress_type == CompressHelpers::CompressType::Zstandard)
+  {
+    const CompressHelpers::ByteBuffer seek_table = CompressHelpers::CreateZstdSeekTable(m_seek_table);
+    if (std::fwrite(seek_table.data(), seek_table.size(), 1, m_fp.get()) != 1)
+    {
+      Error::SetErrno(error, "fwrite() failed: ", errno);
+      return false;
+    }
+  }
+
   return FileSystem::CommitAtomicRenamedFile(m_fp, error);
 }
 
 std::unique_ptr<GPUDump::Recorder> GPUDump::Recorder::Create(std::string path, std::string_view serial, u32 num_frames,
-                                                             Error* error)
+                                                             GPUDumpCompressionMode compress_mode, Error* error)
 {
   std::unique_ptr<Recorder> ret;
 
+  CompressHelpers::CompressType compress_type = CompressHelpers::CompressType::Uncompressed;
+  int compress_level = 0;
+  if (compress_mode >= GPUDumpCompressionMode::ZstLow && compress_mode <= GPUDumpCompressionMode::ZstHigh)
+  {
+    compress_type = CompressHelpers::CompressType::Zstandard;
+    compress_level = ((compress_mode == GPUDumpCompressionMode::ZstLow) ?
+                        1 :
+                        ((compress_mode == GPUDumpCompressionMode::ZstHigh) ? 19 : 0));
+    path.append(".zst");
+  }
+  else if (compress_mode >= GPUDumpCompressionMode::XZLow && compress_mode <= GPUDumpCompressionMode::XZHigh)
+  {
+    compress_type = CompressHelpers::CompressType::XZ;
+    compress_level =
+      ((compress_mode == GPUDumpCompressionMode::XZLow) ? 3 : ((compress_mode == GPUDumpCompressionMode::XZHigh) ? 9 : 5));
+    path.append(".xz");
+  }
+
   auto fp = FileSystem::CreateAtomicRenamedFile(path, error);
   if (!fp)
     return ret;
 
-  ret = std::unique_ptr<Recorder>(new Recorder(std::move(fp), num_frames, std::move(path)));
+  ret = std::unique_ptr<Recorder>(
+    new Recorder(std::move(fp), num_frames, std::move(path), compress_type, compress_level));
+  ret->m_writer_thread = std::thread(&Recorder::WriterThreadEntryPoint, ret.get());
   ret->WriteHeaders(serial);
   g_gpu.WriteCurrentVideoModeToDump(ret.get());
   ret->WriteCurrentVRAM();
@@ -83,52 +139,148 @@ std::unique_ptr<GPUDump::Recorder> GPUDump::Recorder::Create(std::string path, s
   ret->BeginPacket(PacketType::TraceBegin);
   ret->EndPacket();
 
-  if (ret->m_write_error)
+  return ret;
+}
+
+void GPUDump::Recorder::AppendToPage(const void* data, size_t size)
+{
+  const u8* data_ptr = static_cast<const u8*>(data);
+  if (m_staging_keyframe)
   {
-    Error::SetStringView(error, "Previous write error occurred.");
-    ret.reset();
+    m_keyframe_buffer.insert(m_keyframe_buffer.end(), data_ptr, data_ptr + size);
+    return;
   }
 
-  return ret;
+  while (size > 0)
+  {
+    const size_t copy_size = std::min(size, PAGE_SIZE - m_page_used);
+    std::memcpy(m_page.data() + m_page_used, data_ptr, copy_size);
+    m_page_used += copy_size;
+    data_ptr += copy_size;
+    size -= copy_size;
+
+    if (m_page_used == PAGE_SIZE)
+      SubmitPage();
+  }
 }
 
-bool GPUDump::Recorder::Compress(const std::string& source_path, GPUDumpCompressionMode mode, Error* error)
+void GPUDump::Recorder::SubmitPage()
 {
-  if (mode == GPUDumpCompressionMode::Disabled)
-    return true;
+  if (m_page_used == 0)
+    return;
 
-  std::optional<DynamicHeapArray<u8>> data = FileSystem::ReadBinaryFile(source_path.c_str(), error);
-  if (!data)
-    return false;
+  if (m_page_used < PAGE_SIZE)
+    m_page.resize(m_page_used);
+
+  // Blocks if the writer has fallen too far behind, rather than using unbounded memory.
+  std::unique_lock lock(m_writer_mutex);
+  m_writer_space_cv.wait(lock, [this]() { return (m_queued_pages.size() < MAX_QUEUED_PAGES); });
+  m_queued_pages.push_back(std::move(m_page));
+  lock.unlock();
+  m_writer_work_cv.notify_one();
+
+  m_page = CompressHelpers::ByteBuffer(PAGE_SIZE);
+  m_page_used = 0;
+}
+
+void GPUDump::Recorder::StopWriterThread()
+{
+  if (!m_writer_thread.joinable())
+    return;
 
-  if (mode >= GPUDumpCompressionMode::ZstLow && mode <= GPUDumpCompressionMode::ZstHigh)
   {
-    const int clevel =
-      ((mode == GPUDumpCompressionMode::ZstLow) ? 1 : ((mode == GPUDumpCompressionMode::ZstHigh) ? 19 : 0));
-    if (!CompressHelpers::CompressToFile(fmt::format("{}.zst", source_path).c_str(), std::move(data.value()), clevel,
-                                         true, error))
+    std::unique_lock lock(m_writer_mutex);
+    m_writer_shutdown = true;
+  }
+  m_writer_work_cv.notify_one();
+  m_writer_thread.join();
+}
+
+void GPUDump::Recorder::WriterThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("GPU Dump Writer");
+
+  std::vector<CompressHelpers::ByteBuffer> pages;
+  std::unique_lock lock(m_writer_mutex);
+  for (;;)
+  {
+    m_writer_work_cv.wait(lock, [this]() { return (!m_queued_pages.empty() || m_writer_shutdown); });
+    if (m_queued_pages.empty())
+      break;
+
+    // Take everything that's queued, so it can be compressed in parallel.
+    pages.clear();
+    while (!m_queued_pages.empty())
     {
-      return false;
+      pages.push_back(std::move(m_queued_pages.front()));
+      m_queued_pages.pop_front();
+    }
+    lock.unlock();
+    m_writer_space_cv.notify_one();
+
+    // Keep draining after an error, so the emulation thread doesn't block.
+    if (!m_write_error.load(std::memory_order_relaxed))
+    {
+      Error error;
+      if (!WritePages(pages, &error))
+      {
+        ERROR_LOG("Failed to write GPU dump: {}", error.GetDescription());
+        m_writer_error = std::move(error);
+        m_write_error.store(true, std::memory_order_relaxed);
+      }
     }
+
+    lock.lock();
   }
-  else if (mode >= GPUDumpCompressionMode::XZLow && mode <= GPUDumpCompressionMode::XZHigh)
+}
+
+bool GPUDump::Recorder::WritePages(std::span<CompressHelpers::ByteBuffer> pages, Error* error)
+{
+  std::vector<size_t> uncompressed_sizes(pages.size());
+  for (size_t i = 0; i < pages.size(); i++)
+    uncompressed_sizes[i] = pages[i].size();
+
+  if (m_compress_type != CompressHelpers::CompressType::Uncompressed)
   {
-    const int clevel =
-      ((mode == GPUDumpCompressionMode::XZLow) ? 3 : ((mode == GPUDumpCompressionMode::ZstHigh) ? 9 : 5));
-    if (!CompressHelpers::CompressToFile(fmt::format("{}.xz", source_path).c_str(), std::move(data.value()), clevel,
-                                         true, error))
+    // Each page is compressed independently, giving one zstd frame or xz stream per page.
+    std::vector<Error> errors(pages.size());
+    std::vector<u8> results(pages.size());
+    for (size_t i = 0; i < pages.size(); i++)
     {
-      return false;
+      m_compress_queue.SubmitTask([this, &pages, &errors, &results, i]() {
+        results[i] = CompressHelpers::CompressToBuffer(pages[i], m_compress_type, std::move(pages[i]),
+                                                       m_compress_level, &errors[i]);
+      });
+    }
+    m_compress_queue.WaitForAll();
+
+    for (size_t i = 0; i < pages.size(); i++)
+    {
+      if (!results[i])
+      {
+        if (error)
+          *error = std::move(errors[i]);
+        return false;
+      }
     }
   }
-  else
+
+  for (size_t i = 0; i < pages.size(); i++)
   {
-    Error::SetStringView(error, "Unknown compression mode.");
-    return false;
+    if (std::fwrite(pages[i].data(), pages[i].size(), 1, m_fp.get()) != 1)
+    {
+      Error::SetErrno(error, "fwrite() failed: ", errno);
+      return false;
+    }
+
+    if (m_compress_type == CompressHelpers::CompressType::Zstandard)
+      m_seek_table.push_back({m_compressed_size, pages[i].size(), m_uncompressed_size, uncompressed_sizes[i]});
+
+    m_compressed_size += pages[i].size();
+    m_uncompressed_size += uncompressed_sizes[i];
   }
 
-  // remove original file
-  return FileSystem::DeleteFile(source_path.c_str(), error);
+  return true;
 }
 
 void GPUDump::Recorder::BeginGP0Packet(u32 size)
@@ -181,6 +333,28 @@ void GPUDump::Recorder::WriteVSync(u64 ticks)
   WriteWord(static_cast<u32>(ticks));
   WriteWord(static_cast<u32>(ticks >> 32));
   EndPacket();
+
+  m_vsyncs_since_keyframe++;
+}
+
+void GPUDump::Recorder::WriteKeyframe()
+{
+  m_keyframe_buffer.clear();
+  m_staging_keyframe = true;
+
+  // Clear mask bits first, otherwise the current mask settings would apply to the upload.
+  WriteGP0Packet(0xE6u << 24);
+  WriteCurrentVRAM();
+  g_gpu.WriteCurrentVideoModeToDump(this);
+
+  m_staging_keyframe = false;
+
+  BeginPacket(PacketType::Keyframe, 1);
+  WriteWord(static_cast<u32>(m_keyframe_buffer.size()));
+  EndPacket();
+  AppendToPage(m_keyframe_buffer.data(), m_keyframe_buffer.size());
+
+  m_vsyncs_since_keyframe = 0;
 }
 
 void GPUDump::Recorder::BeginPacket(PacketType packet, u32 minimum_size)
@@ -236,24 +410,20 @@ void GPUDump::Recorder::WriteBytes(const void* data, size_t data_size_in_bytes)
 
 void GPUDump::Recorder::EndPacket()
 {
-  if (m_write_error)
+  // Nothing more will be written if the writer thread has failed.
+  if (m_write_error.load(std::memory_order_relaxed))
+  {
+    m_packet_buffer.clear();
     return;
+  }
 
   Assert(m_packet_buffer.size() <= MAX_PACKET_LENGTH);
 
   PacketHeader hdr = {};
   hdr.length = static_cast<u32>(m_packet_buffer.size());
   hdr.type = m_current_packet;
-  if (std::fwrite(&hdr, sizeof(hdr), 1, m_fp.get()) != 1 ||
-      (!m_packet_buffer.empty() &&
-       std::fwrite(m_packet_buffer.data(), m_packet_buffer.size() * sizeof(u32), 1, m_fp.get()) != 1))
-  {
-    ERROR_LOG("Failed to write packet to file: {}", Error::CreateErrno(errno).GetDescription());
-    m_write_error = true;
-    m_packet_buffer.clear();
-    return;
-  }
-
+  AppendToPage(&hdr, sizeof(hdr));
+  AppendToPage(m_packet_buffer.data(), m_packet_buffer.size() * sizeof(u32));
   m_packet_buffer.clear();
 }
 
@@ -266,12 +436,7 @@ void GPUDump::Recorder::WriteGP1Command(GP1Command command, u32 param)
 
 void GPUDump::Recorder::WriteHeaders(std::string_view serial)
 {
-  if (std::fwrite(FILE_HEADER, sizeof(FILE_HEADER), 1, m_fp.get()) != 1)
-  {
-    ERROR_LOG("Failed to write file header: {}", Error::CreateErrno(errno).GetDescription());
-    m_write_error = true;
-    return;
-  }
+  AppendToPage(FILE_HEADER, sizeof(FILE_HEADER));
 
   // Write GPU version.
   BeginPacket(PacketType::GPUVersion, 1);
@@ -310,11 +475,15 @@ void GPUDump::Recorder::WriteCurrentVRAM()
   EndPacket();
 }
 
-GPUDump::Player::Player(std::string path, DynamicHeapArray<u8> data) : m_data(std::move(data)), m_path(std::move(path))
+GPUDump::Player::Player(std::string path) : m_path(std::move(path))
 {
 }
 
-GPUDump::Player::~Player() = default;
+GPUDump::Player::~Player()
+{
+  if (m_mapping)
+    MemMap::UnmapFile(m_mapping, m_mapping_size);
+}
 
 std::unique_ptr<GPUDump::Player> GPUDump::Player::Open(std::string path, Error* error)
 {
@@ -322,22 +491,190 @@ std::unique_ptr<GPUDump::Player> GPUDump::Player::Open(std::string path, Error*
 
   Timer timer;
 
+  ret = std::unique_ptr<Player>(new Player(std::move(path)));
+  if (!ret->OpenData(error) || !ret->Preprocess(error))
+  {
+    ret.reset();
+    return ret;
+  }
+
+  INFO_LOG("Loading {} took {:.0f}ms.", Path::GetFileName(ret->GetPath()), timer.GetTimeMilliseconds());
+  return ret;
+}
+
+bool GPUDump::Player::OpenData(Error* error)
+{
+  FileSystem::ManagedCFilePtr fp = FileSystem::OpenManagedCFile(m_path.c_str(), "rb", error);
+  if (!fp)
+    return false;
+
+  FILESYSTEM_STAT_DATA sd;
+  if (!FileSystem::StatFile(fp.get(), &sd, error))
+    return false;
+
+  m_file_size = static_cast<u64>(sd.Size);
+  m_file_mtime = static_cast<u64>(sd.ModificationTime);
+
+  // Not worth the address space on 32-bit hosts.
+  if constexpr (sizeof(void*) >= 8)
+  {
+    if (m_file_size > 0)
+    {
+      Error map_error;
+      m_mapping =
+        static_cast<const u8*>(MemMap::MapFileReadOnly(fp.get(), static_cast<size_t>(m_file_size), &map_error));
+      if (m_mapping)
+      {
+        m_mapping_size = static_cast<size_t>(m_file_size);
+      }
+      else
+      {
+        WARNING_LOG("Failed to map '{}', reading into memory instead: {}", Path::GetFileName(m_path),
+                    map_error.GetDescription());
+      }
+    }
+  }
+
+  if (StringUtil::EndsWithNoCase(m_path, ".psxgpu.zst") || StringUtil::EndsWithNoCase(m_path, ".psxgpu.xz"))
+    return OpenCompressedData(error);
+
+  if (m_mapping)
+  {
+    m_data_ptr = m_mapping;
+    m_data_size = m_mapping_size;
+    return true;
+  }
+
+  std::optional<DynamicHeapArray<u8>> data = FileSystem::ReadBinaryFile(fp.get(), error);
+  if (!data.has_value())
+    return false;
+
+  m_data = std::move(data.value());
+  m_data_ptr = m_data.data();
+  m_data_size = m_data.size();
+  return true;
+}
+
+bool GPUDump::Player::OpenCompressedData(Error* error)
+{
+  // Dumps compressed by the recorder have a seek table, so only the chunk being played has to be decompressed.
+  if (m_mapping && StringUtil::EndsWithNoCase(m_path, ".psxgpu.zst"))
+  {
+    std::optional<CompressHelpers::SeekTable> chunks =
+      CompressHelpers::ReadZstdSeekTable(std::span<const u8>(m_mapping, m_mapping_size));
+    if (chunks.has_value() && !chunks->empty())
+    {
+      size_t max_chunk_size = 0;
+      for (const CompressHelpers::SeekTableEntry& entry : chunks.value())
+        max_chunk_size = std::max(max_chunk_size, entry.decompressed_size);
+
+      m_chunks = std::move(chunks.value());
+      m_chunk_buffer.resize(max_chunk_size);
+      m_data_size = m_chunks.back().decompressed_offset + m_chunks.back().decompressed_size;
+      DEV_LOG("Streaming {} from {} chunks.", Path::GetFileName(m_path), m_chunks.size());
+      return true;
+    }
+  }
+
   std::optional<DynamicHeapArray<u8>> data;
-  if (StringUtil::EndsWithNoCase(path, ".psxgpu.zst") || StringUtil::EndsWithNoCase(path, ".psxgpu.xz"))
-    data = CompressHelpers::DecompressFile(path.c_str(), std::nullopt, error);
+  if (m_mapping)
+    data = CompressHelpers::DecompressFile(m_path, std::span<const u8>(m_mapping, m_mapping_size), std::nullopt, error);
   else
-    data = FileSystem::ReadBinaryFile(path.c_str(), error);
+    data = CompressHelpers::DecompressFile(m_path.c_str(), std::nullopt, error);
   if (!data.has_value())
-    return ret;
+    return false;
 
-  ret = std::unique_ptr<Player>(new Player(std::move(path), std::move(data.value())));
-  if (!ret->Preprocess(error))
+  // compressed data is no longer needed
+  if (m_mapping)
   {
-    ret.reset();
-    return ret;
+    MemMap::UnmapFile(m_mapping, m_mapping_size);
+    m_mapping = nullptr;
+    m_mapping_size = 0;
   }
 
-  INFO_LOG("Loading {} took {:.0f}ms.", Path::GetFileName(ret->GetPath()), timer.GetTimeMilliseconds());
+  m_data = std::move(data.value());
+  m_data_ptr = m_data.data();
+  m_data_size = m_data.size();
+  return true;
+}
+
+const u8* GPUDump::Player::GetData(size_t offset, size_t size)
+{
+  if (offset > m_data_size || size > (m_data_size - offset))
+    return nullptr;
+
+  if (m_data_ptr)
+    return m_data_ptr + offset;
+
+  const auto it = std::upper_bound(
+    m_chunks.begin(), m_chunks.end(), offset,
+    [](size_t value, const CompressHelpers::SeekTableEntry& entry) { return (value < entry.decompressed_offset); });
+  size_t chunk = static_cast<size_t>(std::distance(m_chunks.begin(), it)) - 1;
+  size_t chunk_offset = offset - m_chunks[chunk].decompressed_offset;
+
+  if (!LoadChunk(chunk, &m_read_error))
+  {
+    Error::AddPrefixFmt(&m_read_error, "Failed to decompress chunk {}: ", chunk);
+    return nullptr;
+  }
+
+  if (size <= (m_chunks[chunk].decompressed_size - chunk_offset))
+    return &m_chunk_buffer[chunk_offset];
+
+  // Range crosses a chunk boundary, so it has to be stitched together.
+  if (m_straddle_buffer.size() < size)
+    m_straddle_buffer.resize(size);
+
+  for (size_t copied = 0;;)
+  {
+    const size_t copy_size = std::min(size - copied, m_chunks[chunk].decompressed_size - chunk_offset);
+    std::memcpy(&m_straddle_buffer[copied], &m_chunk_buffer[chunk_offset], copy_size);
+    copied += copy_size;
+    if (copied == size)
+      break;
+
+    chunk++;
+    chunk_offset = 0;
+    if (!LoadChunk(chunk, &m_read_error))
+    {
+      Error::AddPrefixFmt(&m_read_error, "Failed to decompress chunk {}: ", chunk);
+      return nullptr;
+    }
+  }
+
+  return m_straddle_buffer.data();
+}
+
+bool GPUDump::Player::LoadChunk(size_t index, Error* error)
+{
+  if (m_chunk_loaded && m_current_chunk == index)
+    return true;
+
+  // chunk buffer only holds a single chunk, so decompress to the start of it
+  CompressHelpers::SeekTableEntry entry = m_chunks[index];
+  entry.decompressed_offset = 0;
+
+  m_chunk_loaded = false;
+  if (!CompressHelpers::DecompressZstdChunk(m_chunk_buffer.span(), std::span<const u8>(m_mapping, m_mapping_size),
+                                            entry, error))
+  {
+    return false;
+  }
+
+  m_current_chunk = index;
+  m_chunk_loaded = true;
+  return true;
+}
+
+std::optional<GPUDump::PacketHeader> GPUDump::Player::ReadPacketHeader(size_t offset)
+{
+  std::optional<PacketHeader> ret;
+
+  const u8* data = GetData(offset, sizeof(PacketHeader));
+  if (!data)
+    return ret;
+
+  std::memcpy(&ret.emplace(), data, sizeof(PacketHeader));
   return ret;
 }
 
@@ -345,24 +682,19 @@ std::optional<GPUDump::Player::PacketRef> GPUDump::Player::GetNextPacket()
 {
   std::optional<PacketRef> ret;
 
-  if (m_position >= m_data.size())
+  const std::optional<PacketHeader> hdr = ReadPacketHeader(m_position);
+  if (!hdr.has_value())
     return ret;
 
-  size_t new_position = m_position;
-
-  PacketHeader hdr;
-  std::memcpy(&hdr, &m_data[new_position], sizeof(hdr));
-  new_position += sizeof(hdr);
-
-  if ((new_position + (hdr.length * sizeof(u32))) > m_data.size())
+  const size_t data_size = hdr->length * sizeof(u32);
+  const u8* data = (data_size > 0) ? GetData(m_position + sizeof(PacketHeader), data_size) : nullptr;
+  if (data_size > 0 && !data)
     return ret;
 
-  ret = PacketRef{.type = hdr.type,
-                  .data = (hdr.length > 0) ?
-                            std::span<const u32>(reinterpret_cast<const u32*>(&m_data[new_position]), hdr.length) :
-                            std::span<const u32>()};
-  new_position += (hdr.length * sizeof(u32));
-  m_position = new_position;
+  ret = PacketRef{.type = hdr->type,
+                  .data = (data_size > 0) ? std::span<const u32>(reinterpret_cast<const u32*>(data), hdr->length) :
+                                            std::span<const u32>()};
+  m_position += sizeof(PacketHeader) + data_size;
   return ret;
 }
 
@@ -382,12 +714,17 @@ bool GPUDump::Player::Preprocess(Error* error)
     return false;
   }
 
-  m_position = m_start_offset;
-
-  if (!FindFrameStarts(error))
+  if (!LoadIndex())
   {
-    Error::AddPrefix(error, "Failed to process header: ");
-    return false;
+    m_position = m_start_offset;
+
+    if (!FindFrameStarts(error))
+    {
+      Error::AddPrefix(error, "Failed to process header: ");
+      return false;
+    }
+
+    SaveIndex();
   }
 
   m_position = m_start_offset;
@@ -396,7 +733,8 @@ bool GPUDump::Player::Preprocess(Error* error)
 
 bool GPUDump::Player::ProcessHeader(Error* error)
 {
-  if (m_data.size() < sizeof(FILE_HEADER) || std::memcmp(m_data.data(), FILE_HEADER, sizeof(FILE_HEADER)) != 0)
+  const u8* file_header = GetData(0, sizeof(FILE_HEADER));
+  if (!file_header || std::memcmp(file_header, FILE_HEADER, sizeof(FILE_HEADER)) != 0)
   {
     Error::SetStringView(error, "File does not have the correct header.");
     return false;
@@ -410,7 +748,10 @@ bool GPUDump::Player::ProcessHeader(Error* error)
     const std::optional<PacketRef> packet = GetNextPacket();
     if (!packet.has_value())
     {
-      Error::SetStringView(error, "EOF reached before reaching trace begin.");
+      if (m_read_error.IsValid())
+        Error::SetStringView(error, m_read_error.GetDescription());
+      else
+        Error::SetStringView(error, "EOF reached before reaching trace begin.");
       return false;
     }
 
@@ -461,13 +802,23 @@ bool GPUDump::Player::ProcessHeader(Error* error)
 
 bool GPUDump::Player::FindFrameStarts(Error* error)
 {
+  m_frame_offsets.clear();
+  m_keyframes.clear();
+
+  // Only packet headers are needed here, so skip over the data instead of reading it.
   for (;;)
   {
-    const std::optional<PacketRef> packet = GetNextPacket();
-    if (!packet.has_value())
+    const std::optional<PacketHeader> hdr = ReadPacketHeader(m_position);
+    if (!hdr.has_value())
       break;
 
-    switch (packet->type)
+    const size_t next_position = m_position + sizeof(PacketHeader) + (hdr->length * sizeof(u32));
+    if (next_position > m_data_size)
+      break;
+
+    m_position = next_position;
+
+    switch (hdr->type)
     {
       case PacketType::TraceBegin:
       {
@@ -477,7 +828,9 @@ bool GPUDump::Player::FindFrameStarts(Error* error)
           return false;
         }
 
+        // first frame can always be started from, the header has the initial VRAM
         m_frame_offsets.push_back(m_position);
+        m_keyframes.push_back(0);
       }
       break;
 
@@ -490,6 +843,8 @@ bool GPUDump::Player::FindFrameStarts(Error* error)
         }
 
         m_frame_offsets.push_back(m_position);
+        if (IsKeyframeAt(m_position))
+          m_keyframes.push_back(static_cast<u32>(m_frame_offsets.size() - 1));
       }
       break;
 
@@ -501,6 +856,12 @@ bool GPUDump::Player::FindFrameStarts(Error* error)
     }
   }
 
+  if (m_read_error.IsValid())
+  {
+    Error::SetStringView(error, m_read_error.GetDescription());
+    return false;
+  }
+
   if (m_frame_offsets.size() < 2)
   {
     Error::SetStringView(error, "Dump does not contain at least one frame.");
@@ -512,6 +873,137 @@ bool GPUDump::Player::FindFrameStarts(Error* error)
     DEBUG_LOG("Frame {} starts at offset {}", i, m_frame_offsets[i]);
 #endif
 
+  DEV_LOG("Found {} frames and {} keyframes.", m_frame_offsets.size(), m_keyframes.size());
+  return true;
+}
+
+bool GPUDump::Player::IsKeyframeAt(size_t offset)
+{
+  // See Recorder::WriteKeyframe(), the contents must fit in the dump for the keyframe to be usable.
+  const std::optional<PacketHeader> hdr = ReadPacketHeader(offset);
+  if (!hdr.has_value() || hdr->type != PacketType::Keyframe || hdr->length != 1)
+    return false;
+
+  u32 size;
+  const u8* data = GetData(offset + sizeof(PacketHeader), sizeof(size));
+  if (!data)
+    return false;
+
+  std::memcpy(&size, data, sizeof(size));
+  return (size > 0 && size <= (m_data_size - (offset + sizeof(PacketHeader) + sizeof(size))));
+}
+
+std::string GPUDump::Player::GetIndexPath() const
+{
+  return Path::Combine(EmuFolders::Cache,
+                       fmt::format("gpudump_{:016X}.idx", XXH64(m_path.data(), m_path.length(), 0)));
+}
+
+bool GPUDump::Player::LoadIndex()
+{
+  if (EmuFolders::Cache.empty())
+    return false;
+
+  const std::string path = GetIndexPath();
+  std::optional<DynamicHeapArray<u8>> data = FileSystem::ReadBinaryFile(path.c_str());
+  if (!data.has_value())
+    return false;
+
+  BinarySpanReader reader(data->cspan());
+  u32 signature, version, num_frames, num_keyframes;
+  u64 file_size, file_mtime, data_size;
+  if (!reader.ReadU32(&signature) || !reader.ReadU32(&version) || !reader.ReadU64(&file_size) ||
+      !reader.ReadU64(&file_mtime) || !reader.ReadU64(&data_size) || !reader.ReadU32(&num_frames) ||
+      !reader.ReadU32(&num_keyframes) || signature != INDEX_SIGNATURE || version != INDEX_VERSION)
+  {
+    WARNING_LOG("Frame index '{}' is corrupted or version mismatch.", Path::GetFileName(path));
+    return false;
+  }
+
+  // dump was changed since the index was written
+  if (file_size != m_file_size || file_mtime != m_file_mtime || data_size != m_data_size)
+  {
+    DEV_LOG("Frame index '{}' is out of date.", Path::GetFileName(path));
+    return false;
+  }
+
+  m_frame_offsets.resize(num_frames);
+  m_keyframes.resize(num_keyframes);
+
+  bool valid = (num_frames >= 2 && num_keyframes > 0);
+  for (u32 i = 0; i < num_frames && valid; i++)
+  {
+    u64 offset;
+    valid = (reader.ReadU64(&offset) && offset <= m_data_size);
+    m_frame_offsets[i] = static_cast<size_t>(offset);
+  }
+  for (u32 i = 0; i < num_keyframes && valid; i++)
+  {
+    valid = (reader.ReadU32(&m_keyframes[i]) && m_keyframes[i] < num_frames &&
+             (i == 0 || m_keyframes[i] > m_keyframes[i - 1]));
+  }
+
+  if (!valid || m_keyframes.front() != 0)
+  {
+    WARNING_LOG("Frame index '{}' is corrupted.", Path::GetFileName(path));
+    m_frame_offsets.clear();
+    m_keyframes.clear();
+    return false;
+  }
+
+  DEV_LOG("Loaded {} frames and {} keyframes from index.", m_frame_offsets.size(), m_keyframes.size());
+  return true;
+}
+
+void GPUDump::Player::SaveIndex() const
+{
+  if (EmuFolders::Cache.empty())
+    return;
+
+  Error error;
+  FileSystem::AtomicRenamedFile file = FileSystem::CreateAtomicRenamedFile(GetIndexPath(), &error);
+  if (!file)
+  {
+    ERROR_LOG("Failed to open frame index for writing: {}", error.GetDescription());
+    return;
+  }
+
+  BinaryFileWriter writer(file.get());
+  writer.WriteU32(INDEX_SIGNATURE);
+  writer.WriteU32(INDEX_VERSION);
+  writer.WriteU64(m_file_size);
+  writer.WriteU64(m_file_mtime);
+  writer.WriteU64(m_data_size);
+  writer.WriteU32(static_cast<u32>(m_frame_offsets.size()));
+  writer.WriteU32(static_cast<u32>(m_keyframes.size()));
+
+  for (const size_t offset : m_frame_offsets)
+    writer.WriteU64(offset);
+  for (const u32 keyframe : m_keyframes)
+    writer.WriteU32(keyframe);
+
+  if (!writer.Flush(&error) || !FileSystem::CommitAtomicRenamedFile(file, &error))
+  {
+    ERROR_LOG("Failed to write frame index: {}", error.GetDescription());
+    FileSystem::DiscardAtomicRenamedFile(file);
+  }
+}
+
+bool GPUDump::Player::SeekToFrame(size_t frame, Error* error)
+{
+  if (frame >= m_frame_offsets.size())
+  {
+    Error::SetStringFmt(error, "Frame {} is out of range, dump has {} frames.", frame, m_frame_offsets.size());
+    return false;
+  }
+
+  // keyframe 0 is the header, which contains the initial VRAM and video mode, otherwise start with the contents of
+  // the keyframe packet, which playback would skip
+  const u32 keyframe = *(std::upper_bound(m_keyframes.begin(), m_keyframes.end(), static_cast<u32>(frame)) - 1);
+  m_position = (keyframe == 0) ? m_start_offset : (m_frame_offsets[keyframe] + sizeof(PacketHeader) + sizeof(u32));
+  m_catch_up_offset = m_frame_offsets[frame];
+  m_reset_command_buffer = true;
+  DEV_LOG("Seeking to frame {} from keyframe at frame {}.", frame, keyframe);
   return true;
 }
 
@@ -523,6 +1015,15 @@ void GPUDump::Player::ProcessPacket(const PacketRef& pkt)
     g_gpu.ProcessGPUDumpPacket(pkt.type, pkt.data);
     return;
   }
+
+  if (pkt.type == PacketType::Keyframe)
+  {
+    // state is already current when playing through, only seeking uses the contents
+    if (pkt.data.size() == 1 && pkt.data[0] <= (m_data_size - m_position))
+      m_position += pkt.data[0];
+
+    return;
+  }
 }
 
 void GPUDump::Player::Execute()
@@ -530,15 +1031,41 @@ void GPUDump::Player::Execute()
   if (fastjmp_set(CPU::GetExecutionJmpBuf()) != 0)
     return;
 
+  // drop any partial command from before the seek, keyframes start on a command boundary
+  if (m_reset_command_buffer)
+  {
+    m_reset_command_buffer = false;
+
+    const u32 clear_fifo = static_cast<u32>(GP1Command::ClearFIFO) << 24;
+    g_gpu.ProcessGPUDumpPacket(PacketType::GPUPort1Data, std::span<const u32>(&clear_fifo, 1));
+  }
+
   for (;;)
   {
     const std::optional<PacketRef> packet = GetNextPacket();
     if (!packet.has_value())
     {
+      // a corrupt chunk would otherwise loop forever, or silently restart playback
+      if (m_read_error.IsValid()) [[unlikely]]
+      {
+        System::AbnormalShutdown(fmt::format("Failed to read GPU dump: {}", m_read_error.GetDescription()));
+        return;
+      }
+
       m_position = g_settings.gpu_dump_fast_replay_mode ? m_frame_offsets.front() : m_start_offset;
+      m_catch_up_offset = 0;
       continue;
     }
 
+    // frames between the keyframe and seek target only rebuild VRAM, don't display them
+    if (m_catch_up_offset > 0)
+    {
+      if (packet->type == PacketType::VSyncEvent && m_position <= m_catch_up_offset)
+        continue;
+      else if (m_position >= m_catch_up_offset)
+        m_catch_up_offset = 0;
+    }
+
     ProcessPacket(packet.value());
   }
 }
@@ -5,15 +5,22 @@
 
 #include "gpu_types.h"
 
+#include "util/compress_helpers.h"
+
 #include "common/bitfield.h"
+#include "common/error.h"
 #include "common/file_system.h"
+#include "common/task_queue.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 // Implements the specification from https://github.com/ps1dev/standards/blob/main/GPUDUMP.md
 
-class Error;
-
 namespace GPUDump {
 
 enum class GPUVersion : u8
@@ -35,10 +42,17 @@ enum class PacketType : u8
   GameID = 0x10,
   TextualVideoFormat = 0x11,
   Comment = 0x12,
+
+  // DuckStation extension, not part of the specification. The single word is the size in bytes of the packets which
+  // follow it, which restore VRAM and the video mode. They are skipped during playback and only applied when seeking.
+  Keyframe = 0x20,
 };
 
 inline constexpr u32 MAX_PACKET_LENGTH = ((1u << 24) - 1); // 3 bytes for packet size
 
+/// Number of frames between VRAM keyframes in recorded dumps.
+inline constexpr u32 KEYFRAME_INTERVAL = 300;
+
 union PacketHeader
 {
   // Length0,Length1,Length2,Type
@@ -53,16 +67,22 @@ class Recorder
 public:
   ~Recorder();
 
-  static std::unique_ptr<Recorder> Create(std::string path, std::string_view serial, u32 num_frames, Error* error);
-
-  /// Compresses an already-created dump.
-  static bool Compress(const std::string& source_path, GPUDumpCompressionMode mode, Error* error);
+  /// Creates a dump at path, with the extension for the compression mode appended. Packets are compressed and written
+  /// on a worker thread, so the final file is produced directly without an uncompressed intermediate.
+  static std::unique_ptr<Recorder> Create(std::string path, std::string_view serial, u32 num_frames,
+                                          GPUDumpCompressionMode compress_mode, Error* error);
 
   ALWAYS_INLINE const std::string& GetPath() const { return m_path; }
+  ALWAYS_INLINE bool IsCompressed() const { return (m_compress_type != CompressHelpers::CompressType::Uncompressed); }
 
   /// Returns true if the caller should stop recording data.
   bool IsFinished();
 
+  /// Returns true if a keyframe is due. The caller should only write it when the GPU is idle.
+  ALWAYS_INLINE bool IsKeyframeDue() const { return (m_vsyncs_since_keyframe >= KEYFRAME_INTERVAL); }
+
+  /// Flushes outstanding data and waits for the writer thread. Can be called from any thread, as long as no other
+  /// methods are called concurrently.
   bool Close(Error* error);
 
   void BeginPacket(PacketType packet, u32 minimum_size = 0);
@@ -83,17 +103,60 @@ public:
   void WriteDiscardVRAMRead(u32 width, u32 height);
   void WriteVSync(u64 ticks);
 
+  /// Writes the current VRAM and video mode, so that seeking can start from this frame. g_vram must be up to date.
+  /// Playback skips over keyframes, so they don't overwrite the state of hardware renderers (e.g. upscaled VRAM).
+  void WriteKeyframe();
+
 private:
-  Recorder(FileSystem::AtomicRenamedFile fp, u32 vsyncs_remaining, std::string path);
+  /// Size of each page handed to the writer thread, and of each compressed chunk.
+  static constexpr size_t PAGE_SIZE = CompressHelpers::DEFAULT_CHUNK_SIZE;
+
+  /// Maximum number of pages waiting to be written before the emulation thread blocks.
+  static constexpr size_t MAX_QUEUED_PAGES = 64;
+
+  Recorder(FileSystem::AtomicRenamedFile fp, u32 vsyncs_remaining, std::string path,
+           CompressHelpers::CompressType compress_type, int compress_level);
 
   void WriteHeaders(std::string_view serial);
   void WriteCurrentVRAM();
 
+  void AppendToPage(const void* data, size_t size);
+  void SubmitPage();
+  void StopWriterThread();
+  void WriterThreadEntryPoint();
+  bool WritePages(std::span<CompressHelpers::ByteBuffer> pages, Error* error);
+
   FileSystem::AtomicRenamedFile m_fp;
   std::vector<u32> m_packet_buffer;
   u32 m_vsyncs_remaining = 0;
+  u32 m_vsyncs_since_keyframe = 0;
   PacketType m_current_packet = PacketType::Comment;
-  bool m_write_error = false;
+  std::atomic_bool m_write_error{false};
+
+  // Keyframe packets are staged so the size can be written in front of them.
+  std::vector<u8> m_keyframe_buffer;
+  bool m_staging_keyframe = false;
+
+  CompressHelpers::CompressType m_compress_type;
+  int m_compress_level;
+
+  CompressHelpers::ByteBuffer m_page;
+  size_t m_page_used = 0;
+
+  // Shared with the writer thread.
+  std::thread m_writer_thread;
+  std::mutex m_writer_mutex;
+  std::condition_variable m_writer_work_cv;
+  std::condition_variable m_writer_space_cv;
+  std::deque<CompressHelpers::ByteBuffer> m_queued_pages;
+  Error m_writer_error;
+  bool m_writer_shutdown = false;
+
+  // Only accessed by the writer thread. Batches of pages are compressed in parallel.
+  TaskQueue m_compress_queue;
+  CompressHelpers::SeekTable m_seek_table;
+  size_t m_compressed_size = 0;
+  size_t m_uncompressed_size = 0;
 
   std::string m_path;
 };
@@ -110,10 +173,14 @@ public:
 
   static std::unique_ptr<Player> Open(std::string path, Error* error);
 
+  /// Moves playback to the start of the specified frame. Frames between the closest preceding keyframe and the
+  /// target are replayed without being displayed.
+  bool SeekToFrame(size_t frame, Error* error);
+
   void Execute();
 
 private:
-  Player(std::string path, DynamicHeapArray<u8> data);
+  explicit Player(std::string path);
 
   struct PacketRef
   {
@@ -123,22 +190,55 @@ private:
     std::string_view GetNullTerminatedString() const;
   };
 
+  bool OpenData(Error* error);
+  bool OpenCompressedData(Error* error);
+  const u8* GetData(size_t offset, size_t size);
+  bool LoadChunk(size_t index, Error* error);
+
+  std::optional<PacketHeader> ReadPacketHeader(size_t offset);
   std::optional<PacketRef> GetNextPacket();
 
   bool Preprocess(Error* error);
   bool ProcessHeader(Error* error);
   bool FindFrameStarts(Error* error);
+  bool IsKeyframeAt(size_t offset);
+
+  std::string GetIndexPath() const;
+  bool LoadIndex();
+  void SaveIndex() const;
 
   void ProcessPacket(const PacketRef& pkt);
 
+  u64 m_file_size = 0;
+  u64 m_file_mtime = 0;
+
+  // Uncompressed dumps and compressed seekable dumps are mapped, everything else is decompressed into m_data.
+  const u8* m_mapping = nullptr;
+  size_t m_mapping_size = 0;
   DynamicHeapArray<u8> m_data;
+  const u8* m_data_ptr = nullptr;
+  size_t m_data_size = 0;
+
+  // Seekable dumps are decompressed one chunk at a time.
+  CompressHelpers::SeekTable m_chunks;
+  DynamicHeapArray<u8> m_chunk_buffer;
+  DynamicHeapArray<u8> m_straddle_buffer;
+  size_t m_current_chunk = 0;
+  bool m_chunk_loaded = false;
+
+  // Set when a chunk fails to decompress, so it isn't mistaken for the end of the dump.
+  Error m_read_error;
+
   size_t m_start_offset = 0;
   size_t m_position = 0;
+  size_t m_catch_up_offset = 0;
+  bool m_reset_command_buffer = false;
 
   std::string m_path;
   std::string m_serial;
   ConsoleRegion m_region = ConsoleRegion::NTSC_U;
   std::vector<size_t> m_frame_offsets;
+  std::vector<u32> m_keyframes;
 };
 
 } // namespace GPUDump
@@ -134,27 +134,6 @@ ALWAYS_INLINE static bool IsBlendedTextureFiltering(GPUTextureFilter filter)
   return (filter < GPUTextureFilter::Scale2x && ((static_cast<u8>(filter) & 1u) == 1u));
 }
 
-/// Computes the area affected by a VRAM transfer, including wrap-around of X.
-ALWAYS_INLINE_RELEASE static GSVector4i GetVRAMTransferBounds(u32 x, u32 y, u32 width, u32 height)
-{
-  GSVector4i ret;
-  ret.left = x % VRAM_WIDTH;
-  ret.top = y % VRAM_HEIGHT;
-  ret.right = ret.left + width;
-  ret.bottom = ret.top + height;
-  if (ret.right > static_cast<s32>(VRAM_WIDTH))
-  {
-    ret.left = 0;
-    ret.right = static_cast<s32>(VRAM_WIDTH);
-  }
-  if (ret.bottom > static_cast<s32>(VRAM_HEIGHT))
-  {
-    ret.top = 0;
-    ret.bottom = static_cast<s32>(VRAM_HEIGHT);
-  }
-  return ret;
-}
-
 /// Returns true if the below function should be applied.
 ALWAYS_INLINE static bool ShouldTruncate32To16(const GPUBackendDrawCommand* cmd)
 {
@@ -3929,6 +3908,11 @@ void GPU_HW::DrawingAreaChanged()
   m_drawing_area_changed = true;
 }
 
+void GPU_HW::UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit)
+{
+  GPU_SW_Rasterizer::UpdateCLUT(reg, clut_is_8bit);
+}
+
 void GPU_HW::UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd)
 {
   FlushRender();
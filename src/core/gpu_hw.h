@@ -89,6 +89,7 @@ public:
   void DrawPreciseLine(const GPUBackendDrawPreciseLineCommand* cmd) override;
 
   void DrawingAreaChanged() override;
+  void UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit) override;
   void ClearVRAM() override;
 
   void LoadState(const GPUBackendLoadStateCommand* cmd) override;
@@ -18,14 +18,88 @@
 #include "common/log.h"
 
 #include <algorithm>
+#include <thread>
 
 LOG_CHANNEL(GPU);
 
+ALWAYS_INLINE_RELEASE static void DrawPolygonVertices(const GPUBackendDrawCommand* cmd,
+                                                      const GPUBackendDrawPolygonCommand::Vertex* vertices)
+{
+  const GPU_SW_Rasterizer::DrawTriangleFunction DrawFunction = GPU_SW_Rasterizer::GetDrawTriangleFunction(
+    cmd->shading_enable, cmd->texture_enable, cmd->raw_texture_enable, cmd->transparency_enable);
+
+  DrawFunction(cmd, &vertices[0], &vertices[1], &vertices[2]);
+  if (cmd->num_vertices > 3)
+    DrawFunction(cmd, &vertices[2], &vertices[1], &vertices[3]);
+}
+
+ALWAYS_INLINE_RELEASE static void DrawRectangleCommand(const GPUBackendDrawRectangleCommand* cmd)
+{
+  const GPU_SW_Rasterizer::DrawRectangleFunction DrawFunction =
+    GPU_SW_Rasterizer::GetDrawRectangleFunction(cmd->texture_enable, cmd->raw_texture_enable, cmd->transparency_enable);
+
+  DrawFunction(cmd);
+}
+
+ALWAYS_INLINE_RELEASE static void DrawLineVertices(const GPUBackendDrawCommand* cmd,
+                                                   const GPUBackendDrawLineCommand::Vertex* vertices)
+{
+  const GPU_SW_Rasterizer::DrawLineFunction DrawFunction =
+    GPU_SW_Rasterizer::GetDrawLineFunction(cmd->shading_enable, cmd->transparency_enable);
+
+  for (u16 i = 0; i < cmd->num_vertices; i += 2)
+    DrawFunction(cmd, &vertices[i], &vertices[i + 1]);
+}
+
+/// Rasterizes a queued command, using the clip area of the calling thread.
+static void DrawQueuedCommand(const GPUBackendDrawCommand* cmd)
+{
+  switch (cmd->type)
+  {
+    case GPUBackendCommandType::DrawPolygon:
+      DrawPolygonVertices(cmd, static_cast<const GPUBackendDrawPolygonCommand*>(cmd)->vertices);
+      break;
+
+    case GPUBackendCommandType::DrawRectangle:
+      DrawRectangleCommand(static_cast<const GPUBackendDrawRectangleCommand*>(cmd));
+      break;
+
+    case GPUBackendCommandType::DrawLine:
+      DrawLineVertices(cmd, static_cast<const GPUBackendDrawLineCommand*>(cmd)->vertices);
+      break;
+
+      DefaultCaseIsUnreachable();
+  }
+}
+
+/// Returns the bounding rectangle of a polygon or line, in VRAM coordinates.
+template<typename T, typename F>
+ALWAYS_INLINE_RELEASE static GSVector4i GetVertexBounds(const T* vertices, u32 num_vertices, const F& get_position)
+{
+  GSVector2i min_pos = get_position(vertices[0]);
+  GSVector2i max_pos = min_pos;
+  for (u32 i = 1; i < num_vertices; i++)
+  {
+    const GSVector2i pos = get_position(vertices[i]);
+    min_pos = min_pos.min_s32(pos);
+    max_pos = max_pos.max_s32(pos);
+  }
+
+  // Positions are truncated to 11 bits when rasterizing, so anything outside that range can wrap around.
+  if (min_pos.x < -1024 || min_pos.y < -1024 || max_pos.x > 1023 || max_pos.y > 1023) [[unlikely]]
+    return GSVector4i::cxpr(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+
+  return GSVector4i::xyxy(min_pos, max_pos.add32(GSVector2i::cxpr(1)));
+}
+
 GPU_SW::GPU_SW(GPUPresenter& presenter) : GPUBackend(presenter)
 {
 }
 
-GPU_SW::~GPU_SW() = default;
+GPU_SW::~GPU_SW()
+{
+  FlushBatch();
+}
 
 u32 GPU_SW::GetResolutionScale() const
 {
@@ -56,17 +130,54 @@ bool GPU_SW::Initialize(bool upload_vram, Error* error)
   if (!upload_vram)
     std::memset(g_vram, 0, sizeof(g_vram));
 
+  DrawingAreaChanged();
+  UpdateWorkerThreads();
   return true;
 }
 
+bool GPU_SW::UpdateSettings(const GPUSettings& old_settings, Error* error)
+{
+  if (!GPUBackend::UpdateSettings(old_settings, error))
+    return false;
+
+  if (g_gpu_settings.gpu_sw_threads != old_settings.gpu_sw_threads)
+    UpdateWorkerThreads();
+
+  return true;
+}
+
+void GPU_SW::UpdateWorkerThreads()
+{
+  FlushBatch();
+
+  // The GPU thread rasterizes tiles too, so it counts towards the total.
+  const u32 num_threads = (g_gpu_settings.gpu_sw_threads > 0) ?
+                            g_gpu_settings.gpu_sw_threads :
+                            std::clamp<u32>(std::thread::hardware_concurrency() / 2, 1, MAX_AUTOMATIC_THREADS);
+  const u32 worker_count = num_threads - 1;
+  if (m_worker_count == worker_count)
+    return;
+
+  INFO_LOG("Using {} thread(s) for software rendering.", num_threads);
+  m_worker_queue.SetWorkerCount(worker_count);
+  m_worker_count = worker_count;
+  if (worker_count > 0)
+  {
+    m_batch_primitives.reserve(MAX_BATCH_PRIMITIVES);
+    m_batch_tiles.reserve(NUM_TILES);
+  }
+}
+
 void GPU_SW::ClearVRAM()
 {
+  FlushBatch();
   std::memset(g_vram, 0, sizeof(g_vram));
   std::memset(g_gpu_clut, 0, sizeof(g_gpu_clut));
 }
 
 void GPU_SW::LoadState(const GPUBackendLoadStateCommand* cmd)
 {
+  FlushBatch();
   std::memcpy(g_vram, cmd->vram_data, sizeof(g_vram));
   std::memcpy(g_gpu_clut, cmd->clut_data, sizeof(g_gpu_clut));
 }
@@ -79,6 +190,7 @@ bool GPU_SW::AllocateMemorySaveState(System::MemorySaveState& mss, Error* error)
 
 void GPU_SW::DoMemoryState(StateWrapper& sw, System::MemorySaveState& mss)
 {
+  FlushBatch();
   sw.DoBytes(g_vram, sizeof(g_vram));
   sw.DoBytes(g_gpu_clut, sizeof(g_gpu_clut));
   DebugAssert(!sw.HasError());
@@ -86,38 +198,49 @@ void GPU_SW::DoMemoryState(StateWrapper& sw, System::MemorySaveState& mss)
 
 void GPU_SW::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 {
+  // CPU thread reads VRAM directly.
+  FlushBatch();
 }
 
 void GPU_SW::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, bool interlaced_rendering, u8 active_line_lsb)
 {
+  FlushBatchOnOverlap(GetVRAMTransferBounds(x, y, width, height), true);
   GPU_SW_Rasterizer::FillVRAM(x, y, width, height, color, interlaced_rendering, active_line_lsb);
 }
 
 void GPU_SW::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask)
 {
+  FlushBatchOnOverlap(GetVRAMTransferBounds(x, y, width, height), true);
   GPU_SW_Rasterizer::WriteVRAM(x, y, width, height, data, set_mask, check_mask);
 }
 
 void GPU_SW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height, bool set_mask, bool check_mask)
 {
+  FlushBatchOnOverlap(GetVRAMTransferBounds(src_x, src_y, width, height), false);
+  FlushBatchOnOverlap(GetVRAMTransferBounds(dst_x, dst_y, width, height), true);
   GPU_SW_Rasterizer::CopyVRAM(src_x, src_y, dst_x, dst_y, width, height, set_mask, check_mask);
 }
 
 void GPU_SW::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
 {
-  const GPU_SW_Rasterizer::DrawTriangleFunction DrawFunction = GPU_SW_Rasterizer::GetDrawTriangleFunction(
-    cmd->shading_enable, cmd->texture_enable, cmd->raw_texture_enable, cmd->transparency_enable);
+  if (IsUsingWorkerThreads())
+  {
+    const GSVector4i rect =
+      GetVertexBounds(cmd->vertices, cmd->num_vertices, [](const GPUBackendDrawPolygonCommand::Vertex& v) {
+        return GSVector2i(v.x, v.y);
+      }).rintersect(m_clamped_drawing_area);
+    if (PrepareBatchForPrimitive(cmd, rect, cmd->size))
+    {
+      std::memcpy(QueuePrimitive(cmd, rect, cmd->size), cmd, cmd->size);
+      return;
+    }
+  }
 
-  DrawFunction(cmd, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2]);
-  if (cmd->num_vertices > 3)
-    DrawFunction(cmd, &cmd->vertices[2], &cmd->vertices[1], &cmd->vertices[3]);
+  DrawPolygonVertices(cmd, cmd->vertices);
 }
 
 void GPU_SW::DrawPrecisePolygon(const GPUBackendDrawPrecisePolygonCommand* cmd)
 {
-  const GPU_SW_Rasterizer::DrawTriangleFunction DrawFunction = GPU_SW_Rasterizer::GetDrawTriangleFunction(
-    cmd->shading_enable, cmd->texture_enable, cmd->raw_texture_enable, cmd->transparency_enable);
-
   // Need to cut out the irrelevant bits.
   // TODO: In _theory_ we could use the fixed-point parts here.
   GPUBackendDrawPolygonCommand::Vertex vertices[4];
@@ -128,9 +251,26 @@ void GPU_SW::DrawPrecisePolygon(const GPUBackendDrawPrecisePolygonCommand* cmd)
       .x = src.native_x, .y = src.native_y, .color = src.color, .texcoord = src.texcoord};
   }
 
-  DrawFunction(cmd, &vertices[0], &vertices[1], &vertices[2]);
-  if (cmd->num_vertices > 3)
-    DrawFunction(cmd, &vertices[2], &vertices[1], &vertices[3]);
+  if (IsUsingWorkerThreads())
+  {
+    const GSVector4i rect =
+      GetVertexBounds(vertices, cmd->num_vertices, [](const GPUBackendDrawPolygonCommand::Vertex& v) {
+        return GSVector2i(v.x, v.y);
+      }).rintersect(m_clamped_drawing_area);
+    const u32 size = GPUThreadCommand::AlignCommandSize(sizeof(GPUBackendDrawPolygonCommand) +
+                                                        sizeof(GPUBackendDrawPolygonCommand::Vertex) * cmd->num_vertices);
+    if (PrepareBatchForPrimitive(cmd, rect, size))
+    {
+      GPUBackendDrawPolygonCommand* qcmd = static_cast<GPUBackendDrawPolygonCommand*>(QueuePrimitive(cmd, rect, size));
+      *static_cast<GPUBackendDrawCommand*>(qcmd) = *cmd;
+      qcmd->size = size;
+      qcmd->type = GPUBackendCommandType::DrawPolygon;
+      std::memcpy(qcmd->vertices, vertices, sizeof(GPUBackendDrawPolygonCommand::Vertex) * cmd->num_vertices);
+      return;
+    }
+  }
+
+  DrawPolygonVertices(cmd, vertices);
 }
 
 void GPU_SW::DrawSprite(const GPUBackendDrawRectangleCommand* cmd)
@@ -147,23 +287,58 @@ void GPU_SW::DrawSprite(const GPUBackendDrawRectangleCommand* cmd)
     return;
   }
 
-  const GPU_SW_Rasterizer::DrawRectangleFunction DrawFunction =
-    GPU_SW_Rasterizer::GetDrawRectangleFunction(cmd->texture_enable, cmd->raw_texture_enable, cmd->transparency_enable);
+  if (IsUsingWorkerThreads() && PrepareBatchForPrimitive(cmd, clamped_rect, cmd->size))
+  {
+    std::memcpy(QueuePrimitive(cmd, clamped_rect, cmd->size), cmd, cmd->size);
+    return;
+  }
 
-  DrawFunction(cmd);
+  DrawRectangleCommand(cmd);
 }
 
 void GPU_SW::DrawLine(const GPUBackendDrawLineCommand* cmd)
 {
-  const GPU_SW_Rasterizer::DrawLineFunction DrawFunction =
-    GPU_SW_Rasterizer::GetDrawLineFunction(cmd->shading_enable, cmd->transparency_enable);
+  if (IsUsingWorkerThreads())
+  {
+    const GSVector4i rect =
+      GetVertexBounds(cmd->vertices, cmd->num_vertices, [](const GPUBackendDrawLineCommand::Vertex& v) {
+        return GSVector2i(v.x, v.y);
+      }).rintersect(m_clamped_drawing_area);
+    if (PrepareBatchForPrimitive(cmd, rect, cmd->size))
+    {
+      std::memcpy(QueuePrimitive(cmd, rect, cmd->size), cmd, cmd->size);
+      return;
+    }
+  }
 
-  for (u16 i = 0; i < cmd->num_vertices; i += 2)
-    DrawFunction(cmd, &cmd->vertices[i], &cmd->vertices[i + 1]);
+  DrawLineVertices(cmd, cmd->vertices);
 }
 
 void GPU_SW::DrawPreciseLine(const GPUBackendDrawPreciseLineCommand* cmd)
 {
+  if (IsUsingWorkerThreads())
+  {
+    const GSVector4i rect =
+      GetVertexBounds(cmd->vertices, cmd->num_vertices, [](const GPUBackendDrawPreciseLineCommand::Vertex& v) {
+        return GSVector2i(v.native_x, v.native_y);
+      }).rintersect(m_clamped_drawing_area);
+    const u32 size = GPUThreadCommand::AlignCommandSize(sizeof(GPUBackendDrawLineCommand) +
+                                                        sizeof(GPUBackendDrawLineCommand::Vertex) * cmd->num_vertices);
+    if (PrepareBatchForPrimitive(cmd, rect, size))
+    {
+      GPUBackendDrawLineCommand* qcmd = static_cast<GPUBackendDrawLineCommand*>(QueuePrimitive(cmd, rect, size));
+      *static_cast<GPUBackendDrawCommand*>(qcmd) = *cmd;
+      qcmd->size = size;
+      qcmd->type = GPUBackendCommandType::DrawLine;
+      for (u32 i = 0; i < cmd->num_vertices; i++)
+      {
+        const GPUBackendDrawPreciseLineCommand::Vertex& src = cmd->vertices[i];
+        qcmd->vertices[i].Set(src.native_x, src.native_y, src.color);
+      }
+      return;
+    }
+  }
+
   const GPU_SW_Rasterizer::DrawLineFunction DrawFunction =
     GPU_SW_Rasterizer::GetDrawLineFunction(cmd->shading_enable, cmd->transparency_enable);
 
@@ -185,6 +360,170 @@ void GPU_SW::DrawPreciseLine(const GPUBackendDrawPreciseLineCommand* cmd)
 void GPU_SW::DrawingAreaChanged()
 {
   // GPU_SW_Rasterizer::g_drawing_area set by base class.
+  // Areas extending past the edge of VRAM wrap around vertically, so they can't be split into tiles.
+  m_drawing_area_wraps = (GPU_SW_Rasterizer::g_drawing_area.right >= VRAM_WIDTH ||
+                          GPU_SW_Rasterizer::g_drawing_area.bottom >= VRAM_HEIGHT);
+}
+
+void GPU_SW::UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit)
+{
+  // Queued primitives read the CLUT when they are rasterized, and the new CLUT can come from pending primitives.
+  if (m_batch_uses_palette ||
+      GetPaletteRect(reg, clut_is_8bit ? GPUTextureMode::Palette8Bit : GPUTextureMode::Palette4Bit)
+        .rintersects(m_batch_write_rect))
+  {
+    FlushBatch();
+  }
+
+  GPU_SW_Rasterizer::UpdateCLUT(reg, clut_is_8bit);
+}
+
+bool GPU_SW::PrepareBatchForPrimitive(const GPUBackendDrawCommand* cmd, const GSVector4i rect, u32 size)
+{
+  if (m_drawing_area_wraps) [[unlikely]]
+  {
+    FlushBatch();
+    return false;
+  }
+
+  // Culled primitives don't write anything, so they don't need to be ordered.
+  if (rect.rempty())
+    return false;
+
+  // Earlier primitives in other tiles may not have sampled from this area yet.
+  if (rect.rintersects(m_batch_read_rect))
+    FlushBatch();
+
+  if (cmd->texture_enable)
+  {
+    const GSVector4i texture_rect = GetTextureRect(cmd->draw_mode.texture_page, cmd->draw_mode.texture_mode);
+    if (texture_rect.rintersects(m_batch_write_rect))
+      FlushBatch();
+
+    // Sampling its own output depends on the order pixels are drawn in, so it can't be split into tiles.
+    if (texture_rect.rintersects(rect))
+    {
+      FlushBatch();
+      return false;
+    }
+  }
+
+  if (m_batch_primitives.size() == MAX_BATCH_PRIMITIVES ||
+      (m_batch_command_size + size) > BATCH_COMMAND_BUFFER_SIZE) [[unlikely]]
+  {
+    FlushBatch();
+  }
+
+  return true;
+}
+
+void* GPU_SW::QueuePrimitive(const GPUBackendDrawCommand* cmd, const GSVector4i rect, u32 size)
+{
+  const u32 index = static_cast<u32>(m_batch_primitives.size());
+  m_batch_primitives.push_back(BatchPrimitive{m_batch_command_size, GPU_SW_Rasterizer::g_drawing_area});
+  void* const ptr = &m_batch_commands[m_batch_command_size];
+  m_batch_command_size += size;
+
+  const u32 start_tile_x = static_cast<u32>(rect.left) >> TILE_WIDTH_SHIFT;
+  const u32 start_tile_y = static_cast<u32>(rect.top) >> TILE_HEIGHT_SHIFT;
+  const u32 end_tile_x = static_cast<u32>(rect.right - 1) >> TILE_WIDTH_SHIFT;
+  const u32 end_tile_y = static_cast<u32>(rect.bottom - 1) >> TILE_HEIGHT_SHIFT;
+  for (u32 tile_y = start_tile_y; tile_y <= end_tile_y; tile_y++)
+  {
+    for (u32 tile_x = start_tile_x; tile_x <= end_tile_x; tile_x++)
+    {
+      const u32 tile = tile_y * TILES_X + tile_x;
+      std::vector<u32>& tile_primitives = m_tile_primitives[tile];
+      if (tile_primitives.empty())
+        m_batch_tiles.push_back(tile);
+      tile_primitives.push_back(index);
+    }
+  }
+
+  m_batch_write_rect = m_batch_write_rect.runion(rect);
+  if (cmd->texture_enable)
+  {
+    m_batch_read_rect =
+      m_batch_read_rect.runion(GetTextureRect(cmd->draw_mode.texture_page, cmd->draw_mode.texture_mode));
+    m_batch_uses_palette |= cmd->draw_mode.IsUsingPalette();
+  }
+
+  return ptr;
+}
+
+void GPU_SW::FlushBatchOnOverlap(const GSVector4i rect, bool include_reads)
+{
+  if (m_batch_write_rect.rintersects(rect) || (include_reads && m_batch_read_rect.rintersects(rect)))
+    FlushBatch();
+}
+
+void GPU_SW::FlushBatch()
+{
+  if (m_batch_primitives.empty())
+    return;
+
+  if (m_batch_tiles.size() > 1 && m_batch_primitives.size() >= MIN_PRIMITIVES_FOR_WORKERS)
+  {
+    // The GPU thread executes tasks while waiting, so it needs a task as well.
+    const u32 num_tasks = std::min(m_worker_count + 1, static_cast<u32>(m_batch_tiles.size()));
+    m_next_batch_tile.store(0, std::memory_order_relaxed);
+    for (u32 i = 0; i < num_tasks; i++)
+      m_worker_queue.SubmitTask([this]() { RasterizeTiles(); });
+    m_worker_queue.WaitForAll();
+  }
+  else
+  {
+    // Not worth waking the workers, draw everything in submission order.
+    for (const BatchPrimitive& prim : m_batch_primitives)
+    {
+      GPU_SW_Rasterizer::g_clip_area = prim.drawing_area;
+      DrawQueuedCommand(reinterpret_cast<const GPUBackendDrawCommand*>(&m_batch_commands[prim.command_offset]));
+    }
+  }
+
+  GPU_SW_Rasterizer::g_clip_area = GPU_SW_Rasterizer::g_drawing_area;
+
+  for (const u32 tile : m_batch_tiles)
+    m_tile_primitives[tile].clear();
+  m_batch_tiles.clear();
+  m_batch_primitives.clear();
+  m_batch_command_size = 0;
+  m_batch_write_rect = INVALID_RECT;
+  m_batch_read_rect = INVALID_RECT;
+  m_batch_uses_palette = false;
+}
+
+void GPU_SW::RasterizeTiles()
+{
+  for (;;)
+  {
+    const u32 index = m_next_batch_tile.fetch_add(1, std::memory_order_relaxed);
+    if (index >= m_batch_tiles.size())
+      break;
+
+    RasterizeTile(m_batch_tiles[index]);
+  }
+}
+
+void GPU_SW::RasterizeTile(u32 tile)
+{
+  const u32 tile_left = (tile % TILES_X) * TILE_WIDTH;
+  const u32 tile_top = (tile / TILES_X) * TILE_HEIGHT;
+  const u32 tile_right = tile_left + (TILE_WIDTH - 1);
+  const u32 tile_bottom = tile_top + (TILE_HEIGHT - 1);
+
+  // Primitives in the tile are drawn in submission order, so blending and mask testing see the same VRAM contents.
+  for (const u32 index : m_tile_primitives[tile])
+  {
+    const BatchPrimitive& prim = m_batch_primitives[index];
+    GPU_SW_Rasterizer::g_clip_area = {
+      .left = std::max(prim.drawing_area.left, tile_left),
+      .top = std::max(prim.drawing_area.top, tile_top),
+      .right = std::min(prim.drawing_area.right, tile_right),
+      .bottom = std::min(prim.drawing_area.bottom, tile_bottom),
+    };
+    DrawQueuedCommand(reinterpret_cast<const GPUBackendDrawCommand*>(&m_batch_commands[prim.command_offset]));
+  }
 }
 
 void GPU_SW::ClearCache()
@@ -197,6 +536,7 @@ void GPU_SW::OnBufferSwapped()
 
 void GPU_SW::FlushRender()
 {
+  FlushBatch();
 }
 
 void GPU_SW::RestoreDeviceContext()
@@ -383,6 +723,8 @@ bool GPU_SW::CopyOut(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u3
 
 void GPU_SW::UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd)
 {
+  FlushBatch();
+
   if (!g_gpu_settings.gpu_show_vram)
   {
     if (cmd->display_disabled)
@@ -9,8 +9,13 @@
 #include "util/gpu_device.h"
 
 #include "common/heap_array.h"
+#include "common/task_queue.h"
 
+#include <array>
+#include <atomic>
+#include <limits>
 #include <memory>
+#include <vector>
 
 // TODO: Move to cpp
 // TODO: Rename to GPUSWBackend, preserved to avoid conflicts.
@@ -21,6 +26,7 @@ public:
   ~GPU_SW() override;
 
   bool Initialize(bool upload_vram, Error* error) override;
+  bool UpdateSettings(const GPUSettings& old_settings, Error* error) override;
 
   void RestoreDeviceContext() override;
   void FlushRender() override;
@@ -39,6 +45,7 @@ public:
   void DrawPreciseLine(const GPUBackendDrawPreciseLineCommand* cmd) override;
   void DrawSprite(const GPUBackendDrawRectangleCommand* cmd) override;
   void DrawingAreaChanged() override;
+  void UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit) override;
   void ClearCache() override;
   void OnBufferSwapped() override;
 
@@ -54,6 +61,48 @@ public:
 private:
   static constexpr GPUTexture::Format FORMAT_FOR_24BIT = GPUTexture::Format::RGBA8; // RGBA8 always supported.
 
+  // When using worker threads, primitives are binned into VRAM tiles, and each tile is rasterized in order by one
+  // thread. Anything that reads VRAM written by pending primitives flushes the batch first.
+  static constexpr u32 TILE_WIDTH_SHIFT = 7;
+  static constexpr u32 TILE_HEIGHT_SHIFT = 5;
+  static constexpr u32 TILE_WIDTH = 1u << TILE_WIDTH_SHIFT;
+  static constexpr u32 TILE_HEIGHT = 1u << TILE_HEIGHT_SHIFT;
+  static constexpr u32 TILES_X = VRAM_WIDTH / TILE_WIDTH;
+  static constexpr u32 TILES_Y = VRAM_HEIGHT / TILE_HEIGHT;
+  static constexpr u32 NUM_TILES = TILES_X * TILES_Y;
+  static constexpr u32 MAX_BATCH_PRIMITIVES = 4096;
+  static constexpr u32 BATCH_COMMAND_BUFFER_SIZE = 512 * 1024;
+  static constexpr u32 MIN_PRIMITIVES_FOR_WORKERS = 16;
+  static constexpr u32 MAX_AUTOMATIC_THREADS = 8;
+  static constexpr GSVector4i INVALID_RECT =
+    GSVector4i::cxpr(std::numeric_limits<s32>::max(), std::numeric_limits<s32>::max(), std::numeric_limits<s32>::min(),
+                     std::numeric_limits<s32>::min());
+
+  struct BatchPrimitive
+  {
+    u32 command_offset;
+    GPUDrawingArea drawing_area;
+  };
+
+  ALWAYS_INLINE bool IsUsingWorkerThreads() const { return (m_worker_count > 0); }
+
+  void UpdateWorkerThreads();
+
+  /// Flushes the batch if the primitive depends on it. Returns false if it has to be drawn immediately instead.
+  bool PrepareBatchForPrimitive(const GPUBackendDrawCommand* cmd, const GSVector4i rect, u32 size);
+
+  /// Bins a primitive covering rect, returning space for its command in the batch.
+  void* QueuePrimitive(const GPUBackendDrawCommand* cmd, const GSVector4i rect, u32 size);
+
+  /// Flushes the batch if it writes to the specified rectangle, and optionally, if it reads from it.
+  void FlushBatchOnOverlap(const GSVector4i rect, bool include_reads);
+
+  /// Rasterizes all queued primitives, and waits for completion.
+  void FlushBatch();
+
+  void RasterizeTiles();
+  void RasterizeTile(u32 tile);
+
   template<GPUTexture::Format display_format>
   bool CopyOut15Bit(u32 src_x, u32 src_y, u32 width, u32 height, u32 line_skip);
 
@@ -66,4 +115,19 @@ private:
   FixedHeapArray<u8, GPU_MAX_DISPLAY_WIDTH * GPU_MAX_DISPLAY_HEIGHT * sizeof(u32)> m_upload_buffer;
   GPUTexture::Format m_16bit_display_format = GPUTexture::Format::Unknown;
   std::unique_ptr<GPUTexture> m_upload_texture;
+
+  TaskQueue m_worker_queue;
+  u32 m_worker_count = 0;
+
+  // Queued primitive state, only used with worker threads.
+  FixedHeapArray<u8, BATCH_COMMAND_BUFFER_SIZE, 16> m_batch_commands;
+  u32 m_batch_command_size = 0;
+  std::vector<BatchPrimitive> m_batch_primitives;
+  std::array<std::vector<u32>, NUM_TILES> m_tile_primitives;
+  std::vector<u32> m_batch_tiles;
+  std::atomic<u32> m_next_batch_tile{0};
+  GSVector4i m_batch_write_rect = INVALID_RECT;
+  GSVector4i m_batch_read_rect = INVALID_RECT;
+  bool m_batch_uses_palette = false;
+  bool m_drawing_area_wraps = false;
 };
@@ -36,6 +36,7 @@ FillVRAMFunction FillVRAM = nullptr;
 WriteVRAMFunction WriteVRAM = nullptr;
 CopyVRAMFunction CopyVRAM = nullptr;
 GPUDrawingArea g_drawing_area = {};
+constinit thread_local GPUDrawingArea g_clip_area = {};
 } // namespace GPU_SW_Rasterizer
 
 void GPU_SW_Rasterizer::UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit)
@@ -105,10 +106,9 @@ void GPU_SW_Rasterizer::SelectImplementation()
 #if defined(CPU_ARCH_SSE) || defined(CPU_ARCH_NEON)
   const char* use_isa = std::getenv("SW_USE_ISA");
 
-  // AVX2/256-bit path still has issues, and I need to make sure that it's not ODR'ing any shared
-  // symbols on top of the base symbols.
-#if defined(CPU_ARCH_SSE) && defined(_MSC_VER) && 0
-  if (cpuinfo_has_x86_avx2() && (!use_isa || StringUtil::Strcasecmp(use_isa, "AVX2") == 0))
+#ifdef GPU_SW_RASTERIZER_HAS_AVX2
+  // AVX2 is opt-in for now, set SW_USE_ISA=AVX2 to use it.
+  if (use_isa && StringUtil::Strcasecmp(use_isa, "AVX2") == 0 && cpuinfo_has_x86_avx2())
   {
     SELECT_IMPLEMENTATION(AVX2);
     return;
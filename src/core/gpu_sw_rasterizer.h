@@ -22,6 +22,10 @@ extern const DitherLUT g_dither_lut;
 // TODO: Pack in struct
 extern GPUDrawingArea g_drawing_area;
 
+// Area that primitives are clipped to on the calling thread. Normally equal to the drawing area, tile workers narrow it
+// down to the tile they are rasterizing.
+extern constinit thread_local GPUDrawingArea g_clip_area;
+
 extern void UpdateCLUT(GPUTexturePaletteReg reg, bool clut_is_8bit);
 
 using DrawRectangleFunction = void (*)(const GPUBackendDrawRectangleCommand* cmd);
@@ -75,10 +79,18 @@ ALWAYS_INLINE DrawTriangleFunction GetDrawTriangleFunction(bool shading_enable,
   extern const DrawRectangleFunctionTable DrawRectangleFunctions;                                                      \
   extern const DrawTriangleFunctionTable DrawTriangleFunctions;                                                        \
   extern const DrawLineFunctionTable DrawLineFunctions;                                                                \
+  void FillVRAMImpl(u32 x, u32 y, u32 width, u32 height, u32 color, bool interlaced, u8 active_line_lsb);              \
+  void WriteVRAMImpl(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask);           \
+  void CopyVRAMImpl(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height, bool set_mask,                  \
+                    bool check_mask);                                                                                  \
   }
 
 // Have to define the symbols globally, because clang won't include them otherwise.
-#if defined(CPU_ARCH_SSE) && 0
+// GSVector lives in an ISA-specific inline namespace, and the rasterizer functions in the AVX2 translation unit are
+// static, so it only shares integer-only helpers with other translation units. Debug builds are still left out, because
+// they emit out-of-line copies of every helper.
+#if defined(CPU_ARCH_X64) && defined(CPU_ARCH_SSE) && !defined(_DEBUG)
+#define GPU_SW_RASTERIZER_HAS_AVX2 1
 #define ALTERNATIVE_RASTERIZER_LIST() DECLARE_ALTERNATIVE_RASTERIZER(AVX2)
 #else
 #define ALTERNATIVE_RASTERIZER_LIST()
@@ -236,7 +236,7 @@ static void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
   for (u32 offset_y = 0; offset_y < cmd->height; offset_y++)
   {
     const s32 y = origin_y + static_cast<s32>(offset_y);
-    if (y < static_cast<s32>(g_drawing_area.top) || y > static_cast<s32>(g_drawing_area.bottom) ||
+    if (y < static_cast<s32>(g_clip_area.top) || y > static_cast<s32>(g_clip_area.bottom) ||
         (cmd->interlaced_rendering &&
          cmd->active_line_lsb == ConvertToBoolUnchecked(Truncate8(static_cast<u32>(y)) & 1u)))
     {
@@ -249,7 +249,7 @@ static void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
     for (u32 offset_x = 0; offset_x < cmd->width; offset_x++)
     {
       const s32 x = origin_x + static_cast<s32>(offset_x);
-      if (x < static_cast<s32>(g_drawing_area.left) || x > static_cast<s32>(g_drawing_area.right))
+      if (x < static_cast<s32>(g_clip_area.left) || x > static_cast<s32>(g_clip_area.right))
         continue;
 
       const u8 texcoord_x = Truncate8(ZeroExtend32(origin_texcoord_x) + offset_x);
@@ -331,26 +331,26 @@ ALWAYS_INLINE_RELEASE static GSVector8i LoadVector(u32 x, u32 y)
   }
 }
 
-ALWAYS_INLINE_RELEASE static void StoreVector(u32 x, u32 y, GSVector8i color)
+ALWAYS_INLINE_RELEASE static void StoreVector(u32 x, u32 y, GSVector8i color, GSVector8i skip_mask)
 {
   // TODO: Split into high/low
   const GSVector4i packed = color.low128().pu32(color.high128());
-  if (x <= (VRAM_WIDTH - 8))
+  if (x <= (VRAM_WIDTH - 8) && skip_mask.allfalse())
   {
     GSVector4i::store<false>(&g_vram[y * VRAM_WIDTH + x], packed);
   }
   else
   {
-    // TODO: Avoid stores for masked pixels if a contiguous region is masked
+    alignas(VECTOR_ALIGNMENT) u16 pixels[8];
+    GSVector4i::store<true>(pixels, packed);
+
     u16* line = &g_vram[y * VRAM_WIDTH];
-    line[(x++) & VRAM_WIDTH_MASK] = Truncate16(packed.extract16<0>());
-    line[(x++) & VRAM_WIDTH_MASK] = Truncate16(packed.extract16<1>());
-    line[(x++) & VRAM_WIDTH_MASK] = Truncate16(packed.extract16<2>());
-    line[(x++) & VRAM_WIDTH_MASK] = Truncate16(packed.extract16<3>());
-    line[(x++) & VRAM_WIDTH_MASK] = Truncate16(packed.extract16<4>());
-    line[(x++) & VRAM_WIDTH_MASK] = Truncate16(packed.extract16<5>());
-    line[(x++) & VRAM_WIDTH_MASK] = Truncate16(packed.extract16<6>());
-    line[(x++) & VRAM_WIDTH_MASK] = Truncate16(packed.extract16<7>());
+    const u32 skip_bits = skip_mask.mask();
+    for (u32 i = 0; i < 8; i++)
+    {
+      if (!(skip_bits & (1u << (i * 4))))
+        line[(x + i) & VRAM_WIDTH_MASK] = pixels[i];
+    }
   }
 }
 
@@ -413,20 +413,25 @@ ALWAYS_INLINE_RELEASE static GSVector4i LoadVector(u32 x, u32 y)
   }
 }
 
-ALWAYS_INLINE_RELEASE static void StoreVector(u32 x, u32 y, GSVector4i color)
+ALWAYS_INLINE_RELEASE static void StoreVector(u32 x, u32 y, GSVector4i color, GSVector4i skip_mask)
 {
   const GSVector4i packed_color = color.pu32();
-  if (x <= (VRAM_WIDTH - 4))
+  if (x <= (VRAM_WIDTH - 4) && skip_mask.allfalse())
   {
     GSVector4i::storel<false>(&g_vram[y * VRAM_WIDTH + x], packed_color);
   }
   else
   {
+    alignas(VECTOR_ALIGNMENT) u16 pixels[8];
+    GSVector4i::store<true>(pixels, packed_color);
+
     u16* line = &g_vram[y * VRAM_WIDTH];
-    line[(x++) & VRAM_WIDTH_MASK] = Truncate16(packed_color.extract16<0>());
-    line[(x++) & VRAM_WIDTH_MASK] = Truncate16(packed_color.extract16<1>());
-    line[(x++) & VRAM_WIDTH_MASK] = Truncate16(packed_color.extract16<2>());
-    line[x & VRAM_WIDTH_MASK] = Truncate16(packed_color.extract16<3>());
+    const u32 skip_bits = static_cast<u32>(skip_mask.mask());
+    for (u32 i = 0; i < 4; i++)
+    {
+      if (!(skip_bits & (1u << (i * 4))))
+        line[(x + i) & VRAM_WIDTH_MASK] = pixels[i];
+    }
   }
 }
 
@@ -486,8 +491,8 @@ struct PixelVectors
 
   PixelVectors(const GPUBackendDrawCommand* cmd)
   {
-    clip_left = GSVectorNi(g_drawing_area.left);
-    clip_right = GSVectorNi(g_drawing_area.right);
+    clip_left = GSVectorNi(g_clip_area.left);
+    clip_right = GSVectorNi(g_clip_area.right);
 
     mask_and = GSVectorNi(cmd->GetMaskAND());
     mask_or = GSVectorNi(cmd->GetMaskOR());
@@ -515,6 +520,9 @@ ALWAYS_INLINE_RELEASE static void ShadePixel(const PixelVectors<texture_enable>&
   static constexpr GSVectorNi coord_mask_x = GSVectorNi::cxpr(VRAM_WIDTH_MASK);
   static constexpr GSVectorNi coord_mask_y = GSVectorNi::cxpr(VRAM_HEIGHT_MASK);
 
+  // Lanes outside the span or clip area aren't stored at all, another tile worker can be drawing those pixels.
+  const GSVectorNi skip_mask = preserve_mask;
+
   GSVectorNi color;
 
   if constexpr (texture_enable)
@@ -700,7 +708,7 @@ ALWAYS_INLINE_RELEASE static void ShadePixel(const PixelVectors<texture_enable>&
     color = color | bg_color;
   }
 
-  StoreVector(start_x, y, color);
+  StoreVector(start_x, y, color, skip_mask);
 }
 
 template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
@@ -730,7 +738,7 @@ static void DrawRectangle(const GPUBackendDrawRectangleCommand* RESTRICT cmd)
   for (u32 offset_y = 0; offset_y < cmd->height; offset_y++)
   {
     const s32 y = origin_y + static_cast<s32>(offset_y);
-    if (y >= static_cast<s32>(g_drawing_area.top) && y <= static_cast<s32>(g_drawing_area.bottom) &&
+    if (y >= static_cast<s32>(g_clip_area.top) && y <= static_cast<s32>(g_clip_area.bottom) &&
         (!cmd->interlaced_rendering ||
          cmd->active_line_lsb != ConvertToBoolUnchecked(Truncate8(static_cast<u32>(y)) & 1u)))
     {
@@ -834,8 +842,8 @@ static void DrawLine(const GPUBackendDrawCommand* RESTRICT cmd, const GPUBackend
 
     if ((!cmd->interlaced_rendering ||
          cmd->active_line_lsb != ConvertToBoolUnchecked(Truncate8(static_cast<u32>(y)) & 1u)) &&
-        x >= static_cast<s32>(g_drawing_area.left) && x <= static_cast<s32>(g_drawing_area.right) &&
-        y >= static_cast<s32>(g_drawing_area.top) && y <= static_cast<s32>(g_drawing_area.bottom))
+        x >= static_cast<s32>(g_clip_area.left) && x <= static_cast<s32>(g_clip_area.right) &&
+        y >= static_cast<s32>(g_clip_area.top) && y <= static_cast<s32>(g_clip_area.bottom))
     {
       const u8 r = shading_enable ? unfp_rgb(curr) : p0->r;
       const u8 g = shading_enable ? unfp_rgb(curg) : p0->g;
@@ -991,16 +999,16 @@ static void DrawSpan(const GPUBackendDrawCommand* RESTRICT cmd, s32 y, s32 x_sta
   s32 current_x = TruncateGPUVertexPosition(x_start);
 
   // Skip pixels outside of the scissor rectangle.
-  if (current_x < static_cast<s32>(g_drawing_area.left))
+  if (current_x < static_cast<s32>(g_clip_area.left))
   {
-    const s32 delta = static_cast<s32>(g_drawing_area.left) - current_x;
+    const s32 delta = static_cast<s32>(g_clip_area.left) - current_x;
     x_start += delta;
     current_x += delta;
     width -= delta;
   }
 
-  if ((current_x + width) > (static_cast<s32>(g_drawing_area.right) + 1))
-    width = static_cast<s32>(g_drawing_area.right) + 1 - current_x;
+  if ((current_x + width) > (static_cast<s32>(g_clip_area.right) + 1))
+    width = static_cast<s32>(g_clip_area.right) + 1 - current_x;
 
   if (width <= 0)
     return;
@@ -1058,7 +1066,7 @@ ALWAYS_INLINE_RELEASE static void DrawTrianglePart(const GPUBackendDrawCommand*
       right_x -= right_x_step;
 
       const s32 y = TruncateGPUVertexPosition(current_y);
-      if (y < static_cast<s32>(g_drawing_area.top))
+      if (y < static_cast<s32>(g_clip_area.top))
         break;
 
       // Opposite direction means we need to subtract when stepping instead of adding.
@@ -1067,7 +1075,7 @@ ALWAYS_INLINE_RELEASE static void DrawTrianglePart(const GPUBackendDrawCommand*
       if constexpr (shading_enable)
         lrgb.StepY<true>(rgbstep);
 
-      if (y > static_cast<s32>(g_drawing_area.bottom) ||
+      if (y > static_cast<s32>(g_clip_area.bottom) ||
           (cmd->interlaced_rendering &&
            cmd->active_line_lsb == ConvertToBoolUnchecked(static_cast<u32>(current_y) & 1u)))
       {
@@ -1095,11 +1103,11 @@ ALWAYS_INLINE_RELEASE static void DrawTrianglePart(const GPUBackendDrawCommand*
     {
       const s32 y = TruncateGPUVertexPosition(current_y);
 
-      if (y > static_cast<s32>(g_drawing_area.bottom))
+      if (y > static_cast<s32>(g_clip_area.bottom))
       {
         break;
       }
-      if (y >= static_cast<s32>(g_drawing_area.top) &&
+      if (y >= static_cast<s32>(g_clip_area.top) &&
           (!cmd->interlaced_rendering ||
            cmd->active_line_lsb != ConvertToBoolUnchecked(static_cast<u32>(current_y) & 1u)))
       {
@@ -1173,16 +1181,16 @@ ALWAYS_INLINE_RELEASE static void DrawSpan(const GPUBackendDrawCommand* RESTRICT
   s32 current_x = TruncateGPUVertexPosition(x_start);
 
   // Skip pixels outside of the scissor rectangle.
-  if (current_x < static_cast<s32>(g_drawing_area.left))
+  if (current_x < static_cast<s32>(g_clip_area.left))
   {
-    const s32 delta = static_cast<s32>(g_drawing_area.left) - current_x;
+    const s32 delta = static_cast<s32>(g_clip_area.left) - current_x;
     x_start += delta;
     current_x += delta;
     width -= delta;
   }
 
-  if ((current_x + width) > (static_cast<s32>(g_drawing_area.right) + 1))
-    width = static_cast<s32>(g_drawing_area.right) + 1 - current_x;
+  if ((current_x + width) > (static_cast<s32>(g_clip_area.right) + 1))
+    width = static_cast<s32>(g_clip_area.right) + 1 - current_x;
 
   if (width <= 0)
     return;
@@ -1309,7 +1317,7 @@ ALWAYS_INLINE_RELEASE static void DrawTrianglePart(const GPUBackendDrawCommand*
       right_x -= right_x_step;
 
       const s32 y = TruncateGPUVertexPosition(current_y);
-      if (y < static_cast<s32>(g_drawing_area.top))
+      if (y < static_cast<s32>(g_clip_area.top))
         break;
 
       // Opposite direction means we need to subtract when stepping instead of adding.
@@ -1318,7 +1326,7 @@ ALWAYS_INLINE_RELEASE static void DrawTrianglePart(const GPUBackendDrawCommand*
       if constexpr (shading_enable)
         lrgb.StepY<true>(rgbstep);
 
-      if (y > static_cast<s32>(g_drawing_area.bottom) ||
+      if (y > static_cast<s32>(g_clip_area.bottom) ||
           (cmd->interlaced_rendering &&
            cmd->active_line_lsb == ConvertToBoolUnchecked(static_cast<u32>(current_y) & 1u)))
       {
@@ -1348,11 +1356,11 @@ ALWAYS_INLINE_RELEASE static void DrawTrianglePart(const GPUBackendDrawCommand*
     {
       const s32 y = TruncateGPUVertexPosition(current_y);
 
-      if (y > static_cast<s32>(g_drawing_area.bottom))
+      if (y > static_cast<s32>(g_clip_area.bottom))
       {
         break;
       }
-      if (y >= static_cast<s32>(g_drawing_area.top) &&
+      if (y >= static_cast<s32>(g_clip_area.top) &&
           (!cmd->interlaced_rendering ||
            cmd->active_line_lsb != ConvertToBoolUnchecked(static_cast<u32>(current_y) & 1u)))
       {
@@ -1544,7 +1552,7 @@ constinit const DrawTriangleFunctionTable DrawTriangleFunctions = {
    {{&DrawTriangle<true, true, false, false>, &DrawTriangle<true, true, false, true>},
     {&DrawTriangle<true, true, true, false>, &DrawTriangle<true, true, true, true>}}}};
 
-static void FillVRAMImpl(u32 x, u32 y, u32 width, u32 height, u32 color, bool interlaced, u8 active_line_lsb)
+void FillVRAMImpl(u32 x, u32 y, u32 width, u32 height, u32 color, bool interlaced, u8 active_line_lsb)
 {
 #ifdef USE_VECTOR
   const u16 color16 = VRAMRGBA8888ToRGBA5551(color);
@@ -1662,8 +1670,7 @@ static void FillVRAMImpl(u32 x, u32 y, u32 width, u32 height, u32 color, bool in
 #endif
 }
 
-static void WriteVRAMImpl(u32 x, u32 y, u32 width, u32 height, const void* RESTRICT data, bool set_mask,
-                          bool check_mask)
+void WriteVRAMImpl(u32 x, u32 y, u32 width, u32 height, const void* RESTRICT data, bool set_mask, bool check_mask)
 {
   // Fast path when the copy is not oversized.
   if ((x + width) <= VRAM_WIDTH && (y + height) <= VRAM_HEIGHT && !set_mask && !check_mask)
@@ -1730,16 +1737,18 @@ static void WriteVRAMImpl(u32 x, u32 y, u32 width, u32 height, const void* RESTR
       for (; col < width;)
       {
         // TODO: Handle unaligned reads...
+        // Source pixels are consumed even when masked, otherwise the remainder of the row would shift.
         u16* RESTRICT pixel_ptr = &dst_row_ptr[(x + col++) % VRAM_WIDTH];
+        const u16 src_pixel = *(src_ptr++);
         if (((*pixel_ptr) & mask_and) == 0)
-          *pixel_ptr = *(src_ptr++) | mask_or;
+          *pixel_ptr = src_pixel | mask_or;
       }
     }
   }
 }
 
-static void CopyVRAMImpl(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height, bool set_mask,
-                         bool check_mask)
+void CopyVRAMImpl(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height, bool set_mask,
+                  bool check_mask)
 {
   // Break up oversized copies. This behavior has not been verified on console.
   if ((src_x + width) > VRAM_WIDTH || (dst_x + width) > VRAM_WIDTH)
@@ -6,7 +6,18 @@
 #include "common/assert.h"
 #include "common/gsvector.h"
 
+// Compiled with AVX2 enabled, so GSVectorNi is 256 bits wide and spans are shaded eight pixels at a time.
+// Only the function tables and VRAM functions declared in gpu_sw_rasterizer.h have external linkage.
+#ifdef GPU_SW_RASTERIZER_HAS_AVX2
+
+#ifndef CPU_ARCH_AVX2
+#error This file must be compiled with AVX2 enabled.
+#endif
+
 namespace GPU_SW_Rasterizer::AVX2 {
 #define USE_VECTOR 1
 #include "gpu_sw_rasterizer.inl"
-}
+#undef USE_VECTOR
+} // namespace GPU_SW_Rasterizer::AVX2
+
+#endif // GPU_SW_RASTERIZER_HAS_AVX2
@@ -42,8 +42,12 @@ enum : u32
 {
   COMMAND_QUEUE_SIZE = 16 * 1024 * 1024,
   THRESHOLD_TO_WAKE_GPU = 65536,
+  THRESHOLD_TO_PUBLISH_BATCH = 65536,
+  MAX_COALESCED_LINE_VERTICES = 128,
 };
 
+static constexpr u32 NO_COALESCE_COMMAND = 0xFFFFFFFFu;
+
 static constexpr s32 THREAD_WAKE_COUNT_CPU_THREAD_IS_WAITING = 0x40000000; // CPU thread needs waking
 static constexpr s32 THREAD_WAKE_COUNT_SLEEPING = -1;
 
@@ -54,6 +58,11 @@ static constexpr u32 THREAD_SPIN_TIME_US = 50;
 static constexpr u32 THREAD_SPIN_TIME_US = 200;
 #endif
 
+// Spin times adapt to the waits that are actually observed, within these limits.
+static constexpr u32 MIN_THREAD_SPIN_TIME_US = THREAD_SPIN_TIME_US / 10;
+static constexpr u32 MAX_THREAD_SPIN_TIME_US = THREAD_SPIN_TIME_US * 4;
+static constexpr u32 MAX_IDLE_SPIN_TIME_US = THREAD_SPIN_TIME_US;
+
 static bool Reconfigure(std::optional<GPURenderer> renderer, bool upload_vram, std::optional<bool> fullscreen,
                         std::optional<bool> start_fullscreen_ui, bool recreate_device, Error* error);
 
@@ -64,11 +73,18 @@ template<class T, typename... Args>
 T* AllocateCommand(GPUBackendCommandType type, Args... args);
 
 static u32 GetPendingCommandSize();
+static u32 GetUnpublishedCommandSize();
 static void ResetCommandFIFO();
 static bool IsCommandFIFOEmpty();
+static void PublishCommands();
+static bool TryCoalesceCommand(GPUThreadCommand* cmd);
 static void WakeGPUThread();
 static void WakeGPUThreadIfSleeping();
+static void WaitForGPUThread(bool spin);
+static void UpdateSyncSpinTime(Timer::Value wait_time);
 static bool SleepGPUThread(bool allow_sleep);
+static bool SpinForCommands();
+static void RecordIdlePeriod(Timer::Value idle_time);
 
 static bool CreateDeviceOnThread(RenderAPI api, bool fullscreen, bool clear_fsui_state_on_failure, Error* error);
 static void DestroyDeviceOnThread(bool clear_fsui_state);
@@ -96,6 +112,13 @@ struct ALIGN_TO_CACHE_LINE State
 {
   // Owned by CPU thread.
   ALIGN_TO_CACHE_LINE Timer::Value thread_spin_time = 0;
+  Timer::Value min_thread_spin_time = 0;
+  Timer::Value max_thread_spin_time = 0;
+  Timer::Value sync_wait_average = 0;
+  u32 command_fifo_write_pos = 0;     // End of written commands, ahead of command_fifo_write_ptr in a batch.
+  u32 command_fifo_published_pos = 0; // Last value stored to command_fifo_write_ptr.
+  u32 last_command_pos = NO_COALESCE_COMMAND;
+  u32 command_batch_depth = 0;
   Threading::ThreadHandle gpu_thread;
   Common::unique_aligned_ptr<u8[]> command_fifo_data;
   WindowInfo render_window_info;
@@ -112,6 +135,11 @@ struct ALIGN_TO_CACHE_LINE State
   ALIGN_TO_CACHE_LINE std::unique_ptr<GPUBackend> gpu_backend;
   std::unique_ptr<GPUPresenter> gpu_presenter;
   std::atomic<u32> command_fifo_read_ptr{0};
+  Timer::Value idle_spin_time = 0;
+  Timer::Value max_idle_spin_time = 0;
+  Timer::Value short_idle_ticks = 0;
+  u32 short_idle_count = 0;
+  u32 long_idle_count = 0;
   u8 run_idle_reasons = 0;
   bool run_idle_flag = false;
   GPUVSyncMode requested_vsync = GPUVSyncMode::Disabled;
@@ -138,13 +166,21 @@ void GPUThread::ResetCommandFIFO()
 {
   Assert(!s_state.run_idle_flag && s_state.command_fifo_read_ptr.load(std::memory_order_acquire) ==
                                      s_state.command_fifo_write_ptr.load(std::memory_order_relaxed));
+  DebugAssert(GetUnpublishedCommandSize() == 0);
   s_state.command_fifo_write_ptr.store(0, std::memory_order_release);
   s_state.command_fifo_read_ptr.store(0, std::memory_order_release);
+  s_state.command_fifo_write_pos = 0;
+  s_state.command_fifo_published_pos = 0;
+  s_state.last_command_pos = NO_COALESCE_COMMAND;
 }
 
 void GPUThread::Internal::ProcessStartup()
 {
   s_state.thread_spin_time = Timer::ConvertNanosecondsToValue(THREAD_SPIN_TIME_US * 1000.0);
+  s_state.min_thread_spin_time = Timer::ConvertNanosecondsToValue(MIN_THREAD_SPIN_TIME_US * 1000.0);
+  s_state.max_thread_spin_time = Timer::ConvertNanosecondsToValue(MAX_THREAD_SPIN_TIME_US * 1000.0);
+  s_state.sync_wait_average = s_state.thread_spin_time / 2;
+  s_state.max_idle_spin_time = Timer::ConvertNanosecondsToValue(MAX_IDLE_SPIN_TIME_US * 1000.0);
   s_state.command_fifo_data = Common::make_unique_aligned_for_overwrite<u8[]>(HOST_CACHE_LINE_SIZE, COMMAND_QUEUE_SIZE);
   s_state.use_gpu_thread = g_settings.gpu_use_thread;
   s_state.run_idle_reasons = static_cast<u8>(RunIdleReason::NoGPUBackend);
@@ -167,15 +203,24 @@ GPUThreadCommand* GPUThread::AllocateCommand(GPUBackendCommandType command, u32
   for (;;)
   {
     u32 read_ptr = s_state.command_fifo_read_ptr.load(std::memory_order_acquire);
-    u32 write_ptr = s_state.command_fifo_write_ptr.load(std::memory_order_relaxed);
+    const u32 write_ptr = s_state.command_fifo_write_pos;
     if (read_ptr > write_ptr) [[unlikely]]
     {
       u32 available_size = read_ptr - write_ptr;
-      while (available_size < (size + sizeof(GPUBackendCommandType)))
+      if (available_size < (size + sizeof(GPUBackendCommandType)))
       {
-        WakeGPUThreadIfSleeping();
-        read_ptr = s_state.command_fifo_read_ptr.load(std::memory_order_acquire);
-        available_size = (read_ptr > write_ptr) ? (read_ptr - write_ptr) : (COMMAND_QUEUE_SIZE - write_ptr);
+        // GPU thread can't make progress on commands it can't see.
+        PublishCommands();
+
+        const Timer::Value start_time = Timer::GetCurrentValue();
+        do
+        {
+          WakeGPUThreadIfSleeping();
+          MultiPause();
+          read_ptr = s_state.command_fifo_read_ptr.load(std::memory_order_acquire);
+          available_size = (read_ptr > write_ptr) ? (read_ptr - write_ptr) : (COMMAND_QUEUE_SIZE - write_ptr);
+        } while (available_size < (size + sizeof(GPUBackendCommandType)));
+        PerformanceCounters::RecordGPUThreadProducerStall(Timer::GetCurrentValue() - start_time);
       }
     }
     else
@@ -187,18 +232,23 @@ GPUThreadCommand* GPUThread::AllocateCommand(GPUBackendCommandType command, u32
         if (read_ptr == 0) [[unlikely]]
         {
           DEV_LOG("Buffer full and unprocessed, spinning");
+          PublishCommands();
+          const Timer::Value start_time = Timer::GetCurrentValue();
           do
           {
             WakeGPUThreadIfSleeping();
+            MultiPause();
             read_ptr = s_state.command_fifo_read_ptr.load(std::memory_order_acquire);
           } while (read_ptr == 0);
+          PerformanceCounters::RecordGPUThreadProducerStall(Timer::GetCurrentValue() - start_time);
         }
 
         // allocate a dummy command to wrap the buffer around
         GPUThreadCommand* dummy_cmd = reinterpret_cast<GPUThreadCommand*>(&s_state.command_fifo_data[write_ptr]);
         dummy_cmd->type = GPUBackendCommandType::Wraparound;
         dummy_cmd->size = available_size;
-        s_state.command_fifo_write_ptr.store(0, std::memory_order_release);
+        s_state.command_fifo_write_pos = 0;
+        PublishCommands();
         continue;
       }
     }
@@ -239,6 +289,13 @@ u32 GPUThread::GetPendingCommandSize()
   return (write_ptr >= read_ptr) ? (write_ptr - read_ptr) : (COMMAND_QUEUE_SIZE - read_ptr + write_ptr);
 }
 
+u32 GPUThread::GetUnpublishedCommandSize()
+{
+  const u32 write_pos = s_state.command_fifo_write_pos;
+  const u32 published_pos = s_state.command_fifo_published_pos;
+  return (write_pos >= published_pos) ? (write_pos - published_pos) : (COMMAND_QUEUE_SIZE - published_pos + write_pos);
+}
+
 bool GPUThread::IsCommandFIFOEmpty()
 {
   const u32 read_ptr = s_state.command_fifo_read_ptr.load(std::memory_order_acquire);
@@ -246,6 +303,62 @@ bool GPUThread::IsCommandFIFOEmpty()
   return (read_ptr == write_ptr);
 }
 
+void GPUThread::PublishCommands()
+{
+  // Only the CPU thread writes the pointer, so a plain store is enough. The release makes the commands visible.
+  s_state.last_command_pos = NO_COALESCE_COMMAND;
+  if (s_state.command_fifo_published_pos == s_state.command_fifo_write_pos)
+    return;
+
+  s_state.command_fifo_published_pos = s_state.command_fifo_write_pos;
+  s_state.command_fifo_write_ptr.store(s_state.command_fifo_write_pos, std::memory_order_release);
+}
+
+bool GPUThread::TryCoalesceCommand(GPUThreadCommand* cmd)
+{
+  // Line commands already hold multiple segments, so consecutive lines with the same state can share one command.
+  // Polygons and rectangles are a single primitive per command in all backends.
+  if (cmd->type != GPUBackendCommandType::DrawLine || s_state.last_command_pos == NO_COALESCE_COMMAND)
+    return false;
+
+  u8* const command_fifo_data = s_state.command_fifo_data.get();
+  GPUBackendDrawLineCommand* const prev =
+    reinterpret_cast<GPUBackendDrawLineCommand*>(&command_fifo_data[s_state.last_command_pos]);
+  GPUBackendDrawLineCommand* const lcmd = static_cast<GPUBackendDrawLineCommand*>(cmd);
+  if (prev->type != GPUBackendCommandType::DrawLine ||
+      (prev->num_vertices + lcmd->num_vertices) > MAX_COALESCED_LINE_VERTICES || !prev->HasSameState(*lcmd))
+  {
+    return false;
+  }
+
+  // The merged command is never larger than the two separate commands, so the vertices can just be moved down over
+  // the new command's header.
+  DebugAssert((s_state.last_command_pos + prev->size) == s_state.command_fifo_write_pos);
+  std::memmove(&prev->vertices[prev->num_vertices], lcmd->vertices,
+               sizeof(GPUBackendDrawLineCommand::Vertex) * lcmd->num_vertices);
+  prev->num_vertices += lcmd->num_vertices;
+  prev->size = GPUThreadCommand::AlignCommandSize(sizeof(GPUBackendDrawLineCommand) +
+                                                  sizeof(GPUBackendDrawLineCommand::Vertex) * prev->num_vertices);
+  s_state.command_fifo_write_pos = s_state.last_command_pos + prev->size;
+  return true;
+}
+
+void GPUThread::BeginCommandBatch()
+{
+  s_state.command_batch_depth++;
+}
+
+void GPUThread::EndCommandBatch()
+{
+  DebugAssert(s_state.command_batch_depth > 0);
+  if (--s_state.command_batch_depth > 0 || GetUnpublishedCommandSize() == 0)
+    return;
+
+  PublishCommands();
+  if (GetPendingCommandSize() >= THRESHOLD_TO_WAKE_GPU)
+    WakeGPUThread();
+}
+
 void GPUThread::PushCommand(GPUThreadCommand* cmd)
 {
   if (!s_state.use_gpu_thread) [[unlikely]]
@@ -255,9 +368,27 @@ void GPUThread::PushCommand(GPUThreadCommand* cmd)
     return;
   }
 
-  const u32 new_write_ptr = s_state.command_fifo_write_ptr.fetch_add(cmd->size, std::memory_order_release) + cmd->size;
-  DebugAssert(new_write_ptr <= COMMAND_QUEUE_SIZE);
-  UNREFERENCED_VARIABLE(new_write_ptr);
+  DebugAssert(reinterpret_cast<u8*>(cmd) == &s_state.command_fifo_data[s_state.command_fifo_write_pos]);
+  if (s_state.command_batch_depth > 0)
+  {
+    if (!TryCoalesceCommand(cmd))
+    {
+      s_state.last_command_pos = s_state.command_fifo_write_pos;
+      s_state.command_fifo_write_pos += cmd->size;
+      DebugAssert(s_state.command_fifo_write_pos <= COMMAND_QUEUE_SIZE);
+    }
+
+    // Don't leave the GPU thread idle for the whole of a long burst.
+    if (GetUnpublishedCommandSize() < THRESHOLD_TO_PUBLISH_BATCH)
+      return;
+  }
+  else
+  {
+    s_state.command_fifo_write_pos += cmd->size;
+    DebugAssert(s_state.command_fifo_write_pos <= COMMAND_QUEUE_SIZE);
+  }
+
+  PublishCommands();
   if (GetPendingCommandSize() >= THRESHOLD_TO_WAKE_GPU) // TODO:FIXME: maybe purge this?
     WakeGPUThread();
 }
@@ -271,9 +402,9 @@ void GPUThread::PushCommandAndWakeThread(GPUThreadCommand* cmd)
     return;
   }
 
-  const u32 new_write_ptr = s_state.command_fifo_write_ptr.fetch_add(cmd->size, std::memory_order_release) + cmd->size;
-  DebugAssert(new_write_ptr <= COMMAND_QUEUE_SIZE);
-  UNREFERENCED_VARIABLE(new_write_ptr);
+  s_state.command_fifo_write_pos += cmd->size;
+  DebugAssert(s_state.command_fifo_write_pos <= COMMAND_QUEUE_SIZE);
+  PublishCommands();
   WakeGPUThread();
 }
 
@@ -286,9 +417,9 @@ void GPUThread::PushCommandAndSync(GPUThreadCommand* cmd, bool spin)
     return;
   }
 
-  const u32 new_write_ptr = s_state.command_fifo_write_ptr.fetch_add(cmd->size, std::memory_order_release) + cmd->size;
-  DebugAssert(new_write_ptr <= COMMAND_QUEUE_SIZE);
-  UNREFERENCED_VARIABLE(new_write_ptr);
+  s_state.command_fifo_write_pos += cmd->size;
+  DebugAssert(s_state.command_fifo_write_pos <= COMMAND_QUEUE_SIZE);
+  PublishCommands();
   WakeGPUThread();
   SyncGPUThread(spin);
 }
@@ -322,6 +453,24 @@ void GPUThread::SyncGPUThread(bool spin)
   if (!s_state.use_gpu_thread)
     return;
 
+  // Anything batched has to be visible before we can wait for it.
+  if (GetUnpublishedCommandSize() > 0)
+  {
+    PublishCommands();
+    WakeGPUThread();
+  }
+
+  const Timer::Value start_time = Timer::GetCurrentValue();
+  WaitForGPUThread(spin);
+
+  const Timer::Value wait_time = Timer::GetCurrentValue() - start_time;
+  PerformanceCounters::RecordGPUThreadProducerStall(wait_time);
+  if (spin)
+    UpdateSyncSpinTime(wait_time);
+}
+
+void GPUThread::WaitForGPUThread(bool spin)
+{
   if (spin)
   {
     // Check if the GPU thread is done/sleeping.
@@ -347,6 +496,11 @@ void GPUThread::SyncGPUThread(bool spin)
         continue;
       }
 
+      // The GPU thread may be spinning for more commands rather than sleeping, in which case it's done when the FIFO
+      // is empty, since the read pointer is only updated after the commands have executed.
+      if (IsCommandFIFOEmpty())
+        return;
+
       // Hopefully ought to be enough.
       MultiPause();
 
@@ -373,36 +527,131 @@ void GPUThread::SyncGPUThread(bool spin)
   s_state.thread_is_done_semaphore.Wait();
 }
 
+void GPUThread::UpdateSyncSpinTime(Timer::Value wait_time)
+{
+  // Spin for a bit longer than a typical sync takes. If the GPU thread is usually busy for longer than we're willing
+  // to spin, park straight away instead of burning a core.
+  s_state.sync_wait_average = s_state.sync_wait_average - (s_state.sync_wait_average / 8) + (wait_time / 8);
+  s_state.thread_spin_time =
+    (s_state.sync_wait_average <= s_state.max_thread_spin_time) ?
+      std::clamp(s_state.sync_wait_average * 2, s_state.min_thread_spin_time, s_state.max_thread_spin_time) :
+      s_state.min_thread_spin_time;
+}
+
 bool GPUThread::SleepGPUThread(bool allow_sleep)
 {
   DebugAssert(!allow_sleep || s_state.thread_wake_count.load(std::memory_order_relaxed) >= 0);
+  bool allow_spin = (allow_sleep && s_state.idle_spin_time > 0);
+  Timer::Value idle_start_time = 0;
   for (;;)
   {
     // Acknowledge any work that has been queued, but preserve the waiting flag if there is any, since we're not done
-    // yet.
+    // yet. Stay awake while spinning, so the CPU thread doesn't need to post the semaphore. If the CPU thread is
+    // waiting, it may modify the FIFO once we're done, so go straight to sleep instead of spinning.
     s32 old_state, new_state;
     do
     {
       old_state = s_state.thread_wake_count.load(std::memory_order_relaxed);
-      new_state = (GetThreadWakeCount(old_state) > 0) ? (old_state & THREAD_WAKE_COUNT_CPU_THREAD_IS_WAITING) :
-                                                        (allow_sleep ? THREAD_WAKE_COUNT_SLEEPING : 0);
+      new_state = (GetThreadWakeCount(old_state) > 0) ?
+                    (old_state & THREAD_WAKE_COUNT_CPU_THREAD_IS_WAITING) :
+                    ((allow_sleep && (!allow_spin || (old_state & THREAD_WAKE_COUNT_CPU_THREAD_IS_WAITING))) ?
+                       THREAD_WAKE_COUNT_SLEEPING :
+                       0);
     } while (!s_state.thread_wake_count.compare_exchange_weak(old_state, new_state, std::memory_order_acq_rel,
                                                               std::memory_order_relaxed));
 
     // Are we not done yet?
     if (GetThreadWakeCount(old_state) > 0)
+    {
+      if (idle_start_time != 0)
+        RecordIdlePeriod(Timer::GetCurrentValue() - idle_start_time);
       return true;
+    }
 
     // We're done, so wake the CPU thread if it's waiting.
     if (old_state & THREAD_WAKE_COUNT_CPU_THREAD_IS_WAITING)
+    {
       s_state.thread_is_done_semaphore.Post();
+      allow_spin = false;
+    }
+
+    if (!allow_sleep)
+      return false;
+
+    if (idle_start_time == 0)
+      idle_start_time = Timer::GetCurrentValue();
+
+    // Commands usually arrive shortly after we run out? Spin for a bit, before going to sleep.
+    if (allow_spin)
+    {
+      if (SpinForCommands())
+      {
+        RecordIdlePeriod(Timer::GetCurrentValue() - idle_start_time);
+        return true;
+      }
+
+      allow_spin = false;
+      continue;
+    }
 
     // Sleep until more work is queued.
-    if (allow_sleep)
-      s_state.thread_wake_semaphore.Wait();
-    else
+    s_state.thread_wake_semaphore.Wait();
+  }
+}
+
+bool GPUThread::SpinForCommands()
+{
+  const Timer::Value start_time = Timer::GetCurrentValue();
+  do
+  {
+    MultiPause();
+
+    // Stop early if the CPU thread is waiting for us, it needs the done semaphore posted.
+    const s32 state = s_state.thread_wake_count.load(std::memory_order_acquire);
+    if (GetThreadWakeCount(state) > 0 || !IsCommandFIFOEmpty())
+      return true;
+    else if (state & THREAD_WAKE_COUNT_CPU_THREAD_IS_WAITING)
       return false;
+  } while ((Timer::GetCurrentValue() - start_time) < s_state.idle_spin_time);
+
+  return false;
+}
+
+void GPUThread::RecordIdlePeriod(Timer::Value idle_time)
+{
+  PerformanceCounters::RecordGPUThreadConsumerIdle(idle_time);
+
+  // Gaps short enough to spin through are what the idle spin is tuned for, longer ones are waiting for the next frame.
+  if (idle_time <= s_state.max_idle_spin_time)
+  {
+    s_state.short_idle_ticks += idle_time;
+    s_state.short_idle_count++;
   }
+  else
+  {
+    s_state.long_idle_count++;
+  }
+}
+
+void GPUThread::Internal::UpdateIdleSpinTime()
+{
+  // If most gaps in the last frame were short, spin for twice the typical gap. Otherwise the CPU thread isn't keeping
+  // us busy, so back off, and eventually sleep as soon as the FIFO is empty.
+  if (s_state.short_idle_count > s_state.long_idle_count)
+  {
+    const Timer::Value average_gap = s_state.short_idle_ticks / s_state.short_idle_count;
+    s_state.idle_spin_time = std::clamp(average_gap * 2, s_state.min_thread_spin_time, s_state.max_idle_spin_time);
+  }
+  else
+  {
+    s_state.idle_spin_time /= 2;
+    if (s_state.idle_spin_time < s_state.min_thread_spin_time)
+      s_state.idle_spin_time = 0;
+  }
+
+  s_state.short_idle_ticks = 0;
+  s_state.short_idle_count = 0;
+  s_state.long_idle_count = 0;
 }
 
 void GPUThread::Internal::GPUThreadEntryPoint()
@@ -431,6 +680,9 @@ void GPUThread::Internal::GPUThreadEntryPoint()
       }
     }
 
+    PerformanceCounters::RecordGPUThreadQueueDepth((write_ptr >= read_ptr) ? (write_ptr - read_ptr) :
+                                                                           (COMMAND_QUEUE_SIZE - read_ptr + write_ptr));
+
     write_ptr = (write_ptr < read_ptr) ? COMMAND_QUEUE_SIZE : write_ptr;
     while (read_ptr < write_ptr)
     {
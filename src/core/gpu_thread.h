@@ -98,6 +98,11 @@ void PushCommandAndWakeThread(GPUThreadCommand* cmd);
 void PushCommandAndSync(GPUThreadCommand* cmd, bool spin);
 void SyncGPUThread(bool spin);
 
+/// Commands pushed between these calls are written to the FIFO, but only made visible to the GPU thread when the batch
+/// ends, or a large amount of data has been queued. Consecutive draws with the same state may be merged. Can be nested.
+void BeginCommandBatch();
+void EndCommandBatch();
+
 namespace Internal {
 const Threading::ThreadHandle& GetThreadHandle();
 void ProcessStartup();
@@ -105,6 +110,9 @@ void DoRunIdle();
 void RequestShutdown();
 void GPUThreadEntryPoint();
 bool PresentFrameAndRestoreContext();
+
+/// Adjusts how long the GPU thread spins for commands before sleeping, based on the gaps seen in the last frame.
+void UpdateIdleSpinTime();
 } // namespace Internal
 } // namespace GPUThread
 
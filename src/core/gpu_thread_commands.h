@@ -55,6 +55,8 @@ enum class GPUBackendCommandType : u8
   DrawPreciseLine,
 };
 
+inline constexpr size_t NUM_GPU_BACKEND_COMMAND_TYPES = static_cast<size_t>(GPUBackendCommandType::DrawPreciseLine) + 1;
+
 struct GPUThreadCommand
 {
   u32 size;
@@ -263,6 +265,18 @@ struct GPUBackendDrawCommand : public GPUThreadCommand
   GPUDrawModeReg draw_mode;
   GPUTexturePaletteReg palette;
   GPUTextureWindow window;
+
+  /// Returns true if everything except the vertices matches, i.e. the draws can be merged into one command.
+  ALWAYS_INLINE bool HasSameState(const GPUBackendDrawCommand& rhs) const
+  {
+    return (interlaced_rendering == rhs.interlaced_rendering && active_line_lsb == rhs.active_line_lsb &&
+            set_mask_while_drawing == rhs.set_mask_while_drawing &&
+            check_mask_before_draw == rhs.check_mask_before_draw && texture_enable == rhs.texture_enable &&
+            raw_texture_enable == rhs.raw_texture_enable && transparency_enable == rhs.transparency_enable &&
+            shading_enable == rhs.shading_enable && quad_polygon == rhs.quad_polygon &&
+            dither_enable == rhs.dither_enable && valid_w == rhs.valid_w && draw_mode.bits == rhs.draw_mode.bits &&
+            palette.bits == rhs.palette.bits && window == rhs.window);
+  }
 };
 
 struct GPUBackendDrawPolygonCommand : public GPUBackendDrawCommand
@@ -354,7 +354,7 @@ union GPUVertexPosition
 };
 
 // Sprites/rectangles should be clipped to 11 bits before drawing.
-inline constexpr s32 TruncateGPUVertexPosition(s32 x)
+ALWAYS_INLINE constexpr s32 TruncateGPUVertexPosition(s32 x)
 {
   return SignExtendN<11, s32>(x);
 }
@@ -526,6 +526,27 @@ ALWAYS_INLINE constexpr GSVector4i GetTextureRectWithoutWrap(u32 pn, GPUTextureM
   return GSVector4i::cxpr(left, top, right, bottom);
 }
 
+/// Computes the area affected by a VRAM transfer, including wrap-around of X.
+ALWAYS_INLINE GSVector4i GetVRAMTransferBounds(u32 x, u32 y, u32 width, u32 height)
+{
+  GSVector4i ret;
+  ret.left = x % VRAM_WIDTH;
+  ret.top = y % VRAM_HEIGHT;
+  ret.right = ret.left + width;
+  ret.bottom = ret.top + height;
+  if (ret.right > static_cast<s32>(VRAM_WIDTH))
+  {
+    ret.left = 0;
+    ret.right = static_cast<s32>(VRAM_WIDTH);
+  }
+  if (ret.bottom > static_cast<s32>(VRAM_HEIGHT))
+  {
+    ret.top = 0;
+    ret.bottom = static_cast<s32>(VRAM_HEIGHT);
+  }
+  return ret;
+}
+
 /// Returns the maximum index for a paletted texture.
 ALWAYS_INLINE constexpr u32 GetPaletteWidth(GPUTextureMode mode)
 {
@@ -99,6 +99,8 @@ struct DebugWindowInfo
 } // namespace
 
 static void FormatProcessorStat(SmallStringBase& text, double usage, double time);
+static void FormatHistogramPercentile(SmallStringBase& text, const PerformanceCounters::GPUThreadHistogram& histogram,
+                                      float fraction, std::string_view unit);
 static void SetStatusIndicatorIcons(SmallStringBase& text, bool paused);
 static void DrawPerformanceOverlay(const GPUBackend* gpu, float& position_y, float scale, float margin, float spacing);
 static void DrawMediaCaptureOverlay(float& position_y, float scale, float margin, float spacing);
@@ -265,6 +267,20 @@ void ImGuiManager::FormatProcessorStat(SmallStringBase& text, double usage, doub
     text.append_format("{:.1f}% ({:.2f}ms)", usage, time);
 }
 
+void ImGuiManager::FormatHistogramPercentile(SmallStringBase& text,
+                                             const PerformanceCounters::GPUThreadHistogram& histogram, float fraction,
+                                             std::string_view unit)
+{
+  // Buckets are powers of two, so only the upper bound is known. The last bucket is open-ended.
+  const u32 bucket = PerformanceCounters::GetHistogramPercentileBucket(histogram, fraction);
+  if (bucket == 0)
+    text.append_format("0{}", unit);
+  else if (bucket == (PerformanceCounters::NUM_GPU_THREAD_HISTOGRAM_BUCKETS - 1))
+    text.append_format(">={}{}", u32(1) << (bucket - 1), unit);
+  else
+    text.append_format("<{}{}", u32(1) << bucket, unit);
+}
+
 void ImGuiManager::SetStatusIndicatorIcons(SmallStringBase& text, bool paused)
 {
   text.clear();
@@ -428,6 +444,25 @@ void ImGuiManager::DrawPerformanceOverlay(const GPUBackend* gpu, float& position
       DrawPerformanceStat(dl, position_y, fixed_font, fixed_font_size, FIXED_BOLD_WEIGHT, 0, shadow_offset, rbound,
                           text);
       position_y += spacing;
+
+      if (g_gpu_settings.gpu_use_thread)
+      {
+        // Median and 99th percentile of each histogram, with the totals for the last update interval.
+        const PerformanceCounters::GPUThreadQueueStats& qs = PerformanceCounters::GetGPUThreadQueueStats();
+        text.assign("\x02"
+                    "FIFO: \x01");
+        FormatHistogramPercentile(text, qs.queue_depth, 0.5f, "KiB");
+        text.append("/");
+        FormatHistogramPercentile(text, qs.queue_depth, 0.99f, "KiB");
+        text.append_format(" \x02Stall: \x01{:.2f}ms (", qs.producer_stall_ms);
+        FormatHistogramPercentile(text, qs.producer_stall_time, 0.99f, "us");
+        text.append_format(") \x02Idle: \x01{:.2f}ms (", qs.consumer_idle_ms);
+        FormatHistogramPercentile(text, qs.consumer_idle_time, 0.99f, "us");
+        text.append(")");
+        DrawPerformanceStat(dl, position_y, fixed_font, fixed_font_size, FIXED_BOLD_WEIGHT, 0, shadow_offset, rbound,
+                            text);
+        position_y += spacing;
+      }
     }
 
     if (g_gpu_settings.display_show_resolution)
@@ -15,11 +15,16 @@
 #include "common/fifo_queue.h"
 #include "common/gsvector.h"
 #include "common/log.h"
+#include "common/threading.h"
+#include "common/timer.h"
 
 #include "imgui.h"
 
 #include <array>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 LOG_CHANNEL(MDEC);
 
@@ -115,6 +120,12 @@ static bool DecodeColoredMacroblock();
 static void ScheduleBlockCopyOut(TickCount ticks);
 static void CopyOutBlock(void* param, TickCount ticks, TickCount ticks_late);
 
+static void TransformMacroblock(u32 first_block, bool mono, bool use_old_routines);
+static void TransformPendingBlocks();
+static void StartMacroblockTransform(u32 first_block, bool mono);
+static void WaitForMacroblockTransform();
+static void WorkerThreadEntryPoint();
+
 static bool DecodeRLE_Old(s16* blk, const u8* qt);
 static void IDCT_Old(s16* blk);
 static void YUVToRGB_Old(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
@@ -151,31 +162,80 @@ struct MDECState
   u32 current_block = 0;        // block (0-5)
   u32 current_coefficient = 64; // k (in block)
   u16 current_q_scale = 0;
+  u32 transformed_blocks = 0; // blocks which have already had the IDCT applied
 
   alignas(VECTOR_ALIGNMENT) std::array<u32, 256> block_rgb{};
   TimingEvent block_copy_out_event{"MDEC Block Copy Out", 1, 1, &MDEC::CopyOutBlock, nullptr};
 
 #if defined(_DEBUG) || defined(_DEVEL)
   u32 total_blocks_decoded = 0;
+  u32 total_worker_waits = 0;
+  u64 total_worker_wait_ticks = 0;
 #endif
 };
+
+// Only one macroblock can be in flight, the next one isn't decoded until the current one has been copied out, since
+// the output FIFO has to be empty. That limits the overlap to one macroblock's worth of copy out delay, which is why
+// the worker is off by default. The debug window shows how often the CPU thread still ends up waiting on it.
+struct WorkerThreadState
+{
+  std::thread thread;
+  std::mutex mutex;
+  std::condition_variable work_cv;
+  std::condition_variable done_cv;
+  u32 first_block = 0;
+  bool mono = false;
+  bool use_old_routines = false;
+  bool work_pending = false;
+  bool shutdown = false;
+};
 } // namespace
 
 ALIGN_TO_CACHE_LINE static MDECState s_state;
+static WorkerThreadState s_worker;
 } // namespace MDEC
 
 void MDEC::Initialize()
 {
 #if defined(_DEBUG) || defined(_DEVEL)
   s_state.total_blocks_decoded = 0;
+  s_state.total_worker_waits = 0;
+  s_state.total_worker_wait_ticks = 0;
 #endif
   s_state.active_frame_count = 0;
   Reset();
+  SetUseWorkerThread(g_settings.mdec_use_worker_thread);
 }
 
 void MDEC::Shutdown()
 {
   s_state.block_copy_out_event.Deactivate();
+  SetUseWorkerThread(false);
+}
+
+void MDEC::SetUseWorkerThread(bool enabled)
+{
+  if (s_worker.thread.joinable() == enabled)
+    return;
+
+  if (enabled)
+  {
+    s_worker.shutdown = false;
+    s_worker.thread = std::thread(&MDEC::WorkerThreadEntryPoint);
+    INFO_LOG("MDEC worker thread started");
+  }
+  else
+  {
+    WaitForMacroblockTransform();
+
+    {
+      std::unique_lock lock(s_worker.mutex);
+      s_worker.shutdown = true;
+      s_worker.work_cv.notify_one();
+    }
+
+    s_worker.thread.join();
+  }
 }
 
 void MDEC::Reset()
@@ -187,6 +247,11 @@ void MDEC::Reset()
 
 bool MDEC::DoState(StateWrapper& sw)
 {
+  // Blocks of a partially-decoded macroblock are stored after the IDCT.
+  WaitForMacroblockTransform();
+  if (!sw.IsReading())
+    TransformPendingBlocks();
+
   sw.Do(&s_state.status.bits);
   sw.Do(&s_state.enable_dma_in);
   sw.Do(&s_state.enable_dma_out);
@@ -220,6 +285,7 @@ bool MDEC::DoState(StateWrapper& sw)
   {
     s_state.block_copy_out_event.SetState(block_copy_out_pending);
     s_state.active_frame_count = 0;
+    s_state.transformed_blocks = s_state.current_block;
   }
 
   return !sw.HasError();
@@ -329,6 +395,8 @@ bool MDEC::HasPendingBlockCopyOut()
 
 void MDEC::SoftReset()
 {
+  WaitForMacroblockTransform();
+
   s_state.status.bits = 0;
   s_state.enable_dma_in = false;
   s_state.enable_dma_out = false;
@@ -348,6 +416,7 @@ void MDEC::ResetDecoder()
   s_state.current_block = 0;
   s_state.current_coefficient = 64;
   s_state.current_q_scale = 0;
+  s_state.transformed_blocks = 0;
 }
 
 void MDEC::UpdateStatus()
@@ -558,22 +627,18 @@ bool MDEC::DecodeMonoMacroblock()
   {
     if (!DecodeRLE_Old(s_state.blocks[0].data(), s_state.iq_y.data()))
       return false;
-
-    IDCT_Old(s_state.blocks[0].data());
   }
   else
   {
     if (!DecodeRLE_New(s_state.blocks[0].data(), s_state.iq_y.data()))
       return false;
-
-    IDCT_New(s_state.blocks[0].data());
   }
 
   DEBUG_LOG("Decoded mono macroblock, {} words remaining", s_state.remaining_halfwords / 2);
   ResetDecoder();
   s_state.state = State::WritingMacroblock;
 
-  YUVToMono(s_state.blocks[0]);
+  StartMacroblockTransform(0, true);
 
   ScheduleBlockCopyOut(TICKS_PER_BLOCK * 6);
 
@@ -585,24 +650,66 @@ bool MDEC::DecodeMonoMacroblock()
 
 bool MDEC::DecodeColoredMacroblock()
 {
-  if (g_settings.mdec_use_old_routines) [[unlikely]]
+  // The IDCT is deferred until all blocks are decoded, so it can be done along with the colour conversion.
+  for (; s_state.current_block < NUM_BLOCKS; s_state.current_block++)
   {
-    for (; s_state.current_block < NUM_BLOCKS; s_state.current_block++)
+    const u8* qt = (s_state.current_block >= 2) ? s_state.iq_y.data() : s_state.iq_uv.data();
+    if (g_settings.mdec_use_old_routines) [[unlikely]]
     {
-      if (!DecodeRLE_Old(s_state.blocks[s_state.current_block].data(),
-                         (s_state.current_block >= 2) ? s_state.iq_y.data() : s_state.iq_uv.data()))
+      if (!DecodeRLE_Old(s_state.blocks[s_state.current_block].data(), qt))
+        return false;
+    }
+    else
+    {
+      if (!DecodeRLE_New(s_state.blocks[s_state.current_block].data(), qt))
         return false;
-
-      IDCT_Old(s_state.blocks[s_state.current_block].data());
     }
+  }
 
-    if (!s_state.data_out_fifo.IsEmpty())
-      return false;
+  if (!s_state.data_out_fifo.IsEmpty())
+    return false;
 
-    // done decoding
-    DEBUG_LOG("Decoded colored macroblock, {} words remaining", s_state.remaining_halfwords / 2);
-    ResetDecoder();
-    s_state.state = State::WritingMacroblock;
+  // done decoding
+  DEBUG_LOG("Decoded colored macroblock, {} words remaining", s_state.remaining_halfwords / 2);
+  const u32 first_block = s_state.transformed_blocks;
+  ResetDecoder();
+  s_state.state = State::WritingMacroblock;
+
+  StartMacroblockTransform(first_block, false);
+
+#if defined(_DEBUG) || defined(_DEVEL)
+  s_state.total_blocks_decoded += 4;
+#endif
+
+  ScheduleBlockCopyOut(TICKS_PER_BLOCK * 6);
+  return true;
+}
+
+void MDEC::ScheduleBlockCopyOut(TickCount ticks)
+{
+  DebugAssert(!HasPendingBlockCopyOut());
+  DEBUG_LOG("Scheduling block copy out in {} ticks", ticks);
+
+  s_state.block_copy_out_event.SetIntervalAndSchedule(ticks);
+}
+
+void MDEC::TransformMacroblock(u32 first_block, bool mono, bool use_old_routines)
+{
+  if (mono)
+  {
+    if (use_old_routines) [[unlikely]]
+      IDCT_Old(s_state.blocks[0].data());
+    else
+      IDCT_New(s_state.blocks[0].data());
+
+    YUVToMono(s_state.blocks[0]);
+    return;
+  }
+
+  if (use_old_routines) [[unlikely]]
+  {
+    for (u32 i = first_block; i < NUM_BLOCKS; i++)
+      IDCT_Old(s_state.blocks[i].data());
 
     YUVToRGB_Old(0, 0, s_state.blocks[0], s_state.blocks[1], s_state.blocks[2]);
     YUVToRGB_Old(8, 0, s_state.blocks[0], s_state.blocks[1], s_state.blocks[3]);
@@ -611,49 +718,91 @@ bool MDEC::DecodeColoredMacroblock()
   }
   else
   {
-    for (; s_state.current_block < NUM_BLOCKS; s_state.current_block++)
-    {
-      if (!DecodeRLE_New(s_state.blocks[s_state.current_block].data(),
-                         (s_state.current_block >= 2) ? s_state.iq_y.data() : s_state.iq_uv.data()))
-        return false;
-
-      IDCT_New(s_state.blocks[s_state.current_block].data());
-    }
-
-    if (!s_state.data_out_fifo.IsEmpty())
-      return false;
-
-    // done decoding
-    DEBUG_LOG("Decoded colored macroblock, {} words remaining", s_state.remaining_halfwords / 2);
-    ResetDecoder();
-    s_state.state = State::WritingMacroblock;
+    for (u32 i = first_block; i < NUM_BLOCKS; i++)
+      IDCT_New(s_state.blocks[i].data());
 
     YUVToRGB_New(0, 0, s_state.blocks[0], s_state.blocks[1], s_state.blocks[2]);
     YUVToRGB_New(8, 0, s_state.blocks[0], s_state.blocks[1], s_state.blocks[3]);
     YUVToRGB_New(0, 8, s_state.blocks[0], s_state.blocks[1], s_state.blocks[4]);
     YUVToRGB_New(8, 8, s_state.blocks[0], s_state.blocks[1], s_state.blocks[5]);
   }
+}
+
+void MDEC::TransformPendingBlocks()
+{
+  // Only colour macroblocks advance current_block while decoding.
+  for (; s_state.transformed_blocks < s_state.current_block; s_state.transformed_blocks++)
+  {
+    if (g_settings.mdec_use_old_routines) [[unlikely]]
+      IDCT_Old(s_state.blocks[s_state.transformed_blocks].data());
+    else
+      IDCT_New(s_state.blocks[s_state.transformed_blocks].data());
+  }
+}
 
+void MDEC::StartMacroblockTransform(u32 first_block, bool mono)
+{
+  if (!s_worker.thread.joinable())
+  {
+    TransformMacroblock(first_block, mono, g_settings.mdec_use_old_routines);
+    return;
+  }
+
+  // The worker owns the blocks and RGB output until the copy out event, the output format bits which it reads from
+  // the status register can't change until then either.
+  std::unique_lock lock(s_worker.mutex);
+  DebugAssert(!s_worker.work_pending);
+  s_worker.first_block = first_block;
+  s_worker.mono = mono;
+  s_worker.use_old_routines = g_settings.mdec_use_old_routines;
+  s_worker.work_pending = true;
+  s_worker.work_cv.notify_one();
+}
+
+void MDEC::WaitForMacroblockTransform()
+{
+  if (!s_worker.thread.joinable())
+    return;
+
+  std::unique_lock lock(s_worker.mutex);
 #if defined(_DEBUG) || defined(_DEVEL)
-  s_state.total_blocks_decoded += 4;
+  if (s_worker.work_pending)
+  {
+    const Timer::Value start_time = Timer::GetCurrentValue();
+    s_worker.done_cv.wait(lock, []() { return !s_worker.work_pending; });
+    s_state.total_worker_waits++;
+    s_state.total_worker_wait_ticks += Timer::GetCurrentValue() - start_time;
+  }
+#else
+  s_worker.done_cv.wait(lock, []() { return !s_worker.work_pending; });
 #endif
-
-  ScheduleBlockCopyOut(TICKS_PER_BLOCK * 6);
-  return true;
 }
 
-void MDEC::ScheduleBlockCopyOut(TickCount ticks)
+void MDEC::WorkerThreadEntryPoint()
 {
-  DebugAssert(!HasPendingBlockCopyOut());
-  DEBUG_LOG("Scheduling block copy out in {} ticks", ticks);
+  Threading::SetNameOfCurrentThread("MDEC Worker");
 
-  s_state.block_copy_out_event.SetIntervalAndSchedule(ticks);
+  std::unique_lock lock(s_worker.mutex);
+  for (;;)
+  {
+    s_worker.work_cv.wait(lock, []() { return (s_worker.work_pending || s_worker.shutdown); });
+    if (s_worker.shutdown)
+      break;
+
+    lock.unlock();
+    TransformMacroblock(s_worker.first_block, s_worker.mono, s_worker.use_old_routines);
+    lock.lock();
+
+    s_worker.work_pending = false;
+    s_worker.done_cv.notify_one();
+  }
 }
 
 void MDEC::CopyOutBlock(void* param, TickCount ticks, TickCount ticks_late)
 {
   Assert(s_state.state == State::WritingMacroblock);
   s_state.block_copy_out_event.Deactivate();
+  WaitForMacroblockTransform();
 
   switch (s_state.status.data_output_depth)
   {
@@ -1167,6 +1316,11 @@ void MDEC::DrawDebugStateWindow(float scale)
 
 #if defined(_DEBUG) || defined(_DEVEL)
   ImGui::Text("Blocks Decoded: %u", s_state.total_blocks_decoded);
+  if (s_worker.thread.joinable())
+  {
+    ImGui::Text("Worker Waits: %u (%.2f ms)", s_state.total_worker_waits,
+                Timer::ConvertValueToMilliseconds(s_state.total_worker_wait_ticks));
+  }
 #endif
   ImGui::Text("Data-In FIFO Size: %u (%u bytes)", s_state.data_in_fifo.GetSize(), s_state.data_in_fifo.GetSize() * 4);
   ImGui::Text("Data-Out FIFO Size: %u (%u bytes)", s_state.data_out_fifo.GetSize(),
@@ -6,16 +6,48 @@
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 
+#include "common/assert.h"
+#include "common/bitutils.h"
 #include "common/error.h"
 #include "common/file_system.h"
+#include "common/gsvector.h"
 #include "common/log.h"
 #include "common/path.h"
 #include "common/ryml_helpers.h"
+#include "common/task_queue.h"
 
 #include "fmt/format.h"
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <thread>
+
 LOG_CHANNEL(Cheats);
 
+/// Scannable regions all start and end on a piece boundary.
+static constexpr u32 SCAN_PIECE_SIZE = 1024;
+
+/// Elements are compared sixteen at a time, which is four steps per bitmap word.
+static constexpr u32 ELEMENTS_PER_WORD = 64;
+static constexpr u32 ELEMENTS_PER_STEP = 16;
+
+/// Filtering is split into tasks of this many bitmap words when using multiple threads.
+static constexpr u32 WORDS_PER_FILTER_TASK = 2048;
+static constexpr u32 MAX_FILTER_THREADS = 8;
+
+namespace {
+struct VectorCompare
+{
+  GSVector4i bias;
+  GSVector4i comp;
+  bool use_eq;
+  bool swap;
+  bool invert;
+  bool against_last;
+};
+} // namespace
+
 static bool IsValidScanAddress(VirtualMemoryAddress address)
 {
   if ((address & CPU::SCRATCHPAD_ADDR_MASK) == CPU::SCRATCHPAD_ADDR &&
@@ -38,153 +70,471 @@ MemoryScan::MemoryScan() = default;
 
 MemoryScan::~MemoryScan() = default;
 
-void MemoryScan::ResetSearch()
+template<u32 SIZE>
+ALWAYS_INLINE static GSVector4i CompareLanes(const GSVector4i& a, const GSVector4i& b, bool use_eq)
 {
-  m_results.clear();
+  if constexpr (SIZE == 1)
+    return use_eq ? a.eq8(b) : a.gt8(b);
+  else if constexpr (SIZE == 2)
+    return use_eq ? a.eq16(b) : a.gt16(b);
+  else
+    return use_eq ? a.eq32(b) : a.gt32(b);
 }
 
-void MemoryScan::Search()
+template<u32 SIZE>
+ALWAYS_INLINE static u64 CompareWord(const u8* values, const u8* last_values, const VectorCompare& vc)
+{
+  u64 bits = 0;
+  for (u32 step = 0; step < (ELEMENTS_PER_WORD / ELEMENTS_PER_STEP); step++)
+  {
+    GSVector4i res[SIZE];
+    for (u32 i = 0; i < SIZE; i++)
+    {
+      const u32 offset = (step * ELEMENTS_PER_STEP * SIZE) + (i * sizeof(GSVector4i));
+      const GSVector4i a = GSVector4i::load<false>(values + offset) ^ vc.bias;
+      const GSVector4i b = vc.against_last ? (GSVector4i::load<false>(last_values + offset) ^ vc.bias) : vc.comp;
+      res[i] = vc.swap ? CompareLanes<SIZE>(b, a, vc.use_eq) : CompareLanes<SIZE>(a, b, vc.use_eq);
+    }
+
+    // Narrow the lanes down to bytes, so there's one mask bit per element.
+    u32 mask;
+    if constexpr (SIZE == 1)
+      mask = static_cast<u32>(res[0].mask());
+    else if constexpr (SIZE == 2)
+      mask = static_cast<u32>(res[0].ps16(res[1]).mask());
+    else
+      mask = static_cast<u32>(res[0].ps32(res[1]).ps16(res[2].ps32(res[3])).mask());
+
+    bits |= static_cast<u64>(mask & 0xFFFFu) << (step * ELEMENTS_PER_STEP);
+  }
+
+  return vc.invert ? ~bits : bits;
+}
+
+static bool GetVectorCompare(MemoryScan::Operator op, u32 comp_value, u32 size, bool is_signed, VectorCompare* vc)
 {
-  m_results.clear();
+  using Operator = MemoryScan::Operator;
 
-  switch (m_size)
+  // Everything is expressed as equal or greater than, optionally with the operands swapped and/or result inverted.
+  // Differences need the values widened to 32 bits, so they go through the scalar path.
+  vc->against_last = false;
+  switch (op)
   {
-    case MemoryAccessSize::Byte:
-      SearchBytes();
+    case Operator::EqualLast:
+      vc->against_last = true;
+      [[fallthrough]];
+    case Operator::Equal:
+      vc->use_eq = true;
+      vc->swap = false;
+      vc->invert = false;
       break;
 
-    case MemoryAccessSize::HalfWord:
-      SearchHalfwords();
+    case Operator::NotEqualLast:
+      vc->against_last = true;
+      [[fallthrough]];
+    case Operator::NotEqual:
+      vc->use_eq = true;
+      vc->swap = false;
+      vc->invert = true;
       break;
 
-    case MemoryAccessSize::Word:
-      SearchWords();
+    case Operator::GreaterThanLast:
+      vc->against_last = true;
+      [[fallthrough]];
+    case Operator::GreaterThan:
+      vc->use_eq = false;
+      vc->swap = false;
+      vc->invert = false;
       break;
 
-    default:
+    case Operator::LessEqualLast:
+      vc->against_last = true;
+      [[fallthrough]];
+    case Operator::LessEqual:
+      vc->use_eq = false;
+      vc->swap = false;
+      vc->invert = true;
+      break;
+
+    case Operator::LessThanLast:
+      vc->against_last = true;
+      [[fallthrough]];
+    case Operator::LessThan:
+      vc->use_eq = false;
+      vc->swap = true;
+      vc->invert = false;
       break;
+
+    case Operator::GreaterEqualLast:
+      vc->against_last = true;
+      [[fallthrough]];
+    case Operator::GreaterEqual:
+      vc->use_eq = false;
+      vc->swap = true;
+      vc->invert = true;
+      break;
+
+    default:
+      return false;
   }
+
+  // Comparison values which don't fit in the element would give different results when truncated.
+  const u32 bits = size * 8;
+  if (!vc->against_last && bits < 32)
+  {
+    const s32 signed_comp_value = static_cast<s32>(comp_value);
+    if (is_signed ? (signed_comp_value < -(1 << (bits - 1)) || signed_comp_value >= (1 << (bits - 1))) :
+                    (comp_value >= (1u << bits)))
+    {
+      return false;
+    }
+  }
+
+  // Unsigned comparisons flip the sign bit, so the signed compare instructions can be used.
+  const u32 sign_bits = is_signed ? 0u : ((size == 1) ? 0x80808080u : ((size == 2) ? 0x80008000u : 0x80000000u));
+  const u32 comp_lanes = (size == 1) ? ((comp_value & 0xFFu) * 0x01010101u) :
+                         ((size == 2) ? ((comp_value & 0xFFFFu) * 0x00010001u) : comp_value);
+  vc->bias = GSVector4i(static_cast<s32>(sign_bits));
+  vc->comp = GSVector4i(static_cast<s32>(comp_lanes ^ sign_bits));
+  return true;
 }
 
-void MemoryScan::SearchBytes()
+static u32 LoadElement(const u8* data, u32 element, u32 size, bool is_signed)
 {
-  for (PhysicalMemoryAddress address = m_start_address; address < m_end_address; address++)
+  switch (size)
   {
-    if (!IsValidScanAddress(address))
-      continue;
-
-    u8 bvalue = 0;
-    if (!CPU::SafeReadMemoryByte(address, &bvalue)) [[unlikely]]
-      continue;
+    case 1:
+    {
+      const u8 value = data[element];
+      return is_signed ? SignExtend32(value) : ZeroExtend32(value);
+    }
 
-    Result res;
-    res.address = address;
-    res.value = m_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
-    res.last_value = res.value;
-    res.first_value = res.value;
-    res.value_changed = false;
+    case 2:
+    {
+      u16 value;
+      std::memcpy(&value, data + element * sizeof(u16), sizeof(value));
+      return is_signed ? SignExtend32(value) : ZeroExtend32(value);
+    }
 
-    if (res.Filter(m_operator, m_value, m_signed))
-      m_results.push_back(res);
+    default:
+    {
+      u32 value;
+      std::memcpy(&value, data + element * sizeof(u32), sizeof(value));
+      return value;
+    }
   }
 }
 
-void MemoryScan::SearchHalfwords()
+template<u32 SIZE>
+static void FilterWords(const u8* values, const u8* last_values, MemoryScan::Operator op, u32 comp_value,
+                        bool is_signed, const VectorCompare* vc, u32 element_count, u64* bitmap,
+                        const u64* mask_bitmap, u32 start_word, u32 end_word)
 {
-  for (PhysicalMemoryAddress address = m_start_address; address < m_end_address; address += 2)
+  for (u32 word = start_word; word < end_word; word++)
   {
-    if (!IsValidScanAddress(address))
+    const u64 mask = mask_bitmap[word];
+    if (mask == 0)
+    {
+      bitmap[word] = 0;
       continue;
+    }
 
-    u16 bvalue = 0;
-    if (!CPU::SafeReadMemoryHalfWord(address, &bvalue)) [[unlikely]]
+    const u32 first_element = word * ELEMENTS_PER_WORD;
+    if (vc && (first_element + ELEMENTS_PER_WORD) <= element_count)
+    {
+      bitmap[word] = mask & CompareWord<SIZE>(values + first_element * SIZE, last_values + first_element * SIZE, *vc);
       continue;
+    }
 
-    Result res;
-    res.address = address;
-    res.value = m_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
-    res.last_value = res.value;
-    res.first_value = res.value;
-    res.value_changed = false;
+    u64 bits = 0;
+    for (u64 remaining = mask; remaining != 0; remaining &= (remaining - 1))
+    {
+      const u32 bit = CountTrailingZeros(remaining);
+      MemoryScan::Result res = {};
+      res.value = LoadElement(values, first_element + bit, SIZE, is_signed);
+      res.last_value = LoadElement(last_values, first_element + bit, SIZE, is_signed);
+      if (res.Filter(op, comp_value, is_signed))
+        bits |= u64(1) << bit;
+    }
 
-    if (res.Filter(m_operator, m_value, m_signed))
-      m_results.push_back(res);
+    bitmap[word] = bits;
   }
 }
 
-void MemoryScan::SearchWords()
+void MemoryScan::ResetSearch()
 {
-  for (PhysicalMemoryAddress address = m_start_address; address < m_end_address; address += 4)
-  {
-    if (!IsValidScanAddress(address))
-      continue;
+  m_spans.clear();
+  m_element_size = 0;
+  m_values.clear();
+  m_last_values.clear();
+  m_first_values.clear();
+  m_result_bitmap.clear();
+  m_changed_bitmap.clear();
+  m_result_ranks.clear();
+  m_result_count = 0;
+}
 
-    u32 bvalue = 0;
-    if (!CPU::SafeReadMemoryWord(address, &bvalue)) [[unlikely]]
-      continue;
+void MemoryScan::Search()
+{
+  ResetSearch();
+  BuildSpans();
 
-    Result res;
-    res.address = address;
-    res.value = bvalue;
-    res.last_value = res.value;
-    res.first_value = res.value;
-    res.value_changed = false;
+  const u32 element_count = GetElementCount();
+  if (element_count == 0)
+    return;
 
-    if (res.Filter(m_operator, m_value, m_signed))
-      m_results.push_back(res);
-  }
+  ReadValues(m_values);
+  m_last_values = m_values;
+  m_first_values = m_values;
+
+  const u32 word_count = (element_count + ELEMENTS_PER_WORD - 1) / ELEMENTS_PER_WORD;
+  m_result_bitmap.resize(word_count, ~u64(0));
+  if ((element_count % ELEMENTS_PER_WORD) != 0)
+    m_result_bitmap.back() = (u64(1) << (element_count % ELEMENTS_PER_WORD)) - 1;
+  m_changed_bitmap.resize(word_count, 0);
+
+  if (m_operator != Operator::Any)
+    FilterElements(m_values, m_last_values, m_operator, m_value, m_signed, m_result_bitmap, m_result_bitmap, true);
+
+  UpdateResultRanks();
 }
 
 void MemoryScan::SearchAgain()
 {
-  ResultVector new_results;
-  new_results.reserve(m_results.size());
-  for (Result& res : m_results)
+  if (m_result_count == 0)
+    return;
+
+  UpdateChangedValues(true);
+
+  if (m_operator != Operator::Any)
+    FilterElements(m_values, m_last_values, m_operator, m_value, m_signed, m_result_bitmap, m_result_bitmap, true);
+
+  m_last_values = m_values;
+  UpdateResultRanks();
+}
+
+void MemoryScan::UpdateResultsValues()
+{
+  if (m_result_count == 0)
+    return;
+
+  // Periodic refresh from the UI, not worth waking the filter threads for.
+  UpdateChangedValues(false);
+}
+
+MemoryScan::Result MemoryScan::GetResult(u32 index) const
+{
+  DebugAssert(index < m_result_count);
+
+  const u32 element = GetResultElement(index);
+  Result res;
+  res.address = GetElementAddress(element);
+  res.value = GetElementValue(m_values, element);
+  res.last_value = GetElementValue(m_last_values, element);
+  res.first_value = GetElementValue(m_first_values, element);
+  res.value_changed = ConvertToBoolUnchecked((m_changed_bitmap[element / ELEMENTS_PER_WORD] >>
+                                              (element % ELEMENTS_PER_WORD)) &
+                                             1u);
+  return res;
+}
+
+void MemoryScan::SetResultValue(u32 index, u32 value)
+{
+  if (index >= m_result_count)
+    return;
+
+  const u32 element = GetResultElement(index);
+  if (GetElementValue(m_values, element) == value)
+    return;
+
+  const PhysicalMemoryAddress address = GetElementAddress(element);
+  u8* const ptr = &m_values[element * m_element_size];
+  switch (m_element_size)
   {
-    res.UpdateValue(m_size, m_signed);
+    case 1:
+    {
+      const u8 bvalue = Truncate8(value);
+      CPU::SafeWriteMemoryByte(address, bvalue);
+      std::memcpy(ptr, &bvalue, sizeof(bvalue));
+    }
+    break;
 
-    if (res.Filter(m_operator, m_value, m_signed))
+    case 2:
     {
-      res.last_value = res.value;
-      new_results.push_back(res);
+      const u16 hvalue = Truncate16(value);
+      CPU::SafeWriteMemoryHalfWord(address, hvalue);
+      std::memcpy(ptr, &hvalue, sizeof(hvalue));
     }
+    break;
+
+    default:
+    {
+      CPU::SafeWriteMemoryWord(address, value);
+      std::memcpy(ptr, &value, sizeof(value));
+    }
+    break;
   }
 
-  m_results.swap(new_results);
+  m_changed_bitmap[element / ELEMENTS_PER_WORD] |= u64(1) << (element % ELEMENTS_PER_WORD);
 }
 
-void MemoryScan::UpdateResultsValues()
+u32 MemoryScan::GetElementCount() const
 {
-  for (Result& res : m_results)
-    res.UpdateValue(m_size, m_signed);
+  return m_spans.empty() ? 0 : (m_spans.back().first_element + m_spans.back().element_count);
 }
 
-void MemoryScan::SetResultValue(u32 index, u32 value)
+u32 MemoryScan::GetResultElement(u32 index) const
 {
-  if (index >= m_results.size())
-    return;
+  // Find the last word which starts at or before this result, then skip over the earlier bits in the word.
+  const auto it = std::upper_bound(m_result_ranks.begin(), m_result_ranks.end(), index);
+  const u32 word = static_cast<u32>(std::distance(m_result_ranks.begin(), it)) - 1;
+  u64 bits = m_result_bitmap[word];
+  for (u32 i = index - m_result_ranks[word]; i > 0; i--)
+    bits &= (bits - 1);
+
+  return (word * ELEMENTS_PER_WORD) + CountTrailingZeros(bits);
+}
+
+PhysicalMemoryAddress MemoryScan::GetElementAddress(u32 element) const
+{
+  const auto it = std::upper_bound(m_spans.begin(), m_spans.end(), element,
+                                   [](u32 element, const Span& span) { return (element < span.first_element); });
+  const Span& span = *(it - 1);
+  return span.address + ((element - span.first_element) * m_element_size);
+}
+
+u32 MemoryScan::GetElementValue(const std::vector<u8>& values, u32 element) const
+{
+  return LoadElement(values.data(), element, m_element_size, m_signed);
+}
+
+void MemoryScan::BuildSpans()
+{
+  m_spans.clear();
+  m_element_size = (m_size == MemoryAccessSize::Byte) ? 1 : ((m_size == MemoryAccessSize::HalfWord) ? 2 : 4);
+
+  // Scannable regions are all aligned to pieces, so only the start of each piece needs to be checked.
+  u32 element_count = 0;
+  const u64 end_address = m_end_address;
+  for (u64 address = (m_start_address & ~(m_element_size - 1)); address < end_address;)
+  {
+    const u64 piece_end = std::min<u64>((address & ~u64(SCAN_PIECE_SIZE - 1)) + SCAN_PIECE_SIZE, end_address);
+    const u32 piece_elements = static_cast<u32>((piece_end - address + m_element_size - 1) / m_element_size);
+    if (IsValidScanAddress(static_cast<VirtualMemoryAddress>(address)))
+    {
+      if (!m_spans.empty() &&
+          (u64(m_spans.back().address) + (u64(m_spans.back().element_count) * m_element_size)) == address)
+      {
+        m_spans.back().element_count += piece_elements;
+      }
+      else
+      {
+        m_spans.push_back(Span{static_cast<PhysicalMemoryAddress>(address), element_count, piece_elements});
+      }
+
+      element_count += piece_elements;
+    }
+
+    address += u64(piece_elements) * m_element_size;
+  }
+}
+
+void MemoryScan::ReadValues(std::vector<u8>& values) const
+{
+  values.resize(GetElementCount() * m_element_size);
+
+  for (const Span& span : m_spans)
+  {
+    // Read piece by piece, a span can cover several RAM mirrors, which would miss the fast path.
+    u8* dest = &values[span.first_element * m_element_size];
+    const u64 span_end = u64(span.address) + (u64(span.element_count) * m_element_size);
+    for (u64 address = span.address; address < span_end;)
+    {
+      const u32 length = static_cast<u32>(
+        std::min<u64>((address & ~u64(SCAN_PIECE_SIZE - 1)) + SCAN_PIECE_SIZE, span_end) - address);
+      if (!CPU::SafeReadMemoryBytes(static_cast<VirtualMemoryAddress>(address), dest, length)) [[unlikely]]
+        std::memset(dest, 0, length);
+
+      dest += length;
+      address += length;
+    }
+  }
+}
 
-  Result& res = m_results[index];
-  if (res.value == value)
+void MemoryScan::FilterElements(const std::vector<u8>& values, const std::vector<u8>& last_values, Operator op,
+                                u32 comp_value, bool is_signed, std::vector<u64>& bitmap,
+                                const std::vector<u64>& mask_bitmap, bool multithreaded)
+{
+  VectorCompare vc;
+  const VectorCompare* vcp = GetVectorCompare(op, comp_value, m_element_size, is_signed, &vc) ? &vc : nullptr;
+  const u32 element_count = GetElementCount();
+  const u32 word_count = static_cast<u32>(bitmap.size());
+  const auto filter_words = [&](u32 start_word, u32 end_word) {
+    switch (m_element_size)
+    {
+      case 1:
+        FilterWords<1>(values.data(), last_values.data(), op, comp_value, is_signed, vcp, element_count,
+                       bitmap.data(), mask_bitmap.data(), start_word, end_word);
+        break;
+
+      case 2:
+        FilterWords<2>(values.data(), last_values.data(), op, comp_value, is_signed, vcp, element_count,
+                       bitmap.data(), mask_bitmap.data(), start_word, end_word);
+        break;
+
+      default:
+        FilterWords<4>(values.data(), last_values.data(), op, comp_value, is_signed, vcp, element_count,
+                       bitmap.data(), mask_bitmap.data(), start_word, end_word);
+        break;
+    }
+  };
+
+  const u32 num_tasks = (word_count + WORDS_PER_FILTER_TASK - 1) / WORDS_PER_FILTER_TASK;
+  const u32 num_threads = std::clamp<u32>(std::thread::hardware_concurrency(), 1, MAX_FILTER_THREADS);
+  if (!multithreaded || num_tasks <= 1 || num_threads <= 1)
+  {
+    filter_words(0, word_count);
     return;
+  }
 
-  switch (m_size)
+  if (!m_filter_queue)
   {
-    case MemoryAccessSize::Byte:
-      CPU::SafeWriteMemoryByte(res.address, Truncate8(value));
-      break;
+    m_filter_queue = std::make_unique<TaskQueue>();
+    m_filter_queue->SetWorkerCount(num_threads - 1);
+  }
 
-    case MemoryAccessSize::HalfWord:
-      CPU::SafeWriteMemoryHalfWord(res.address, Truncate16(value));
-      break;
+  // Calling thread also filters while waiting. Each task only touches its own bitmap words.
+  for (u32 start_word = 0; start_word < word_count; start_word += WORDS_PER_FILTER_TASK)
+  {
+    m_filter_queue->SubmitTask(
+      [&filter_words, start_word, end_word = std::min(start_word + WORDS_PER_FILTER_TASK, word_count)]() {
+        filter_words(start_word, end_word);
+      });
+  }
+  m_filter_queue->WaitForAll();
+}
 
-    case MemoryAccessSize::Word:
-      CPU::SafeWriteMemoryWord(res.address, value);
-      break;
+void MemoryScan::UpdateChangedValues(bool multithreaded)
+{
+  std::vector<u8> new_values;
+  ReadValues(new_values);
+  FilterElements(new_values, m_values, Operator::NotEqualLast, 0, false, m_changed_bitmap, m_result_bitmap,
+                 multithreaded);
+  m_values = std::move(new_values);
+}
+
+void MemoryScan::UpdateResultRanks()
+{
+  m_result_ranks.resize(m_result_bitmap.size());
+
+  u32 count = 0;
+  for (size_t i = 0; i < m_result_bitmap.size(); i++)
+  {
+    m_result_ranks[i] = count;
+    count += static_cast<u32>(std::popcount(m_result_bitmap[i]));
   }
 
-  res.value = value;
-  res.value_changed = true;
+  m_result_count = count;
 }
 
 bool MemoryScan::Result::Filter(Operator op, u32 comp_value, bool is_signed) const
@@ -279,38 +629,6 @@ bool MemoryScan::Result::Filter(Operator op, u32 comp_value, bool is_signed) con
   }
 }
 
-void MemoryScan::Result::UpdateValue(MemoryAccessSize size, bool is_signed)
-{
-  const u32 old_value = value;
-
-  switch (size)
-  {
-    case MemoryAccessSize::Byte:
-    {
-      u8 bvalue = 0;
-      if (CPU::SafeReadMemoryByte(address, &bvalue)) [[likely]]
-        value = is_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
-    }
-    break;
-
-    case MemoryAccessSize::HalfWord:
-    {
-      u16 bvalue = 0;
-      if (CPU::SafeReadMemoryHalfWord(address, &bvalue)) [[likely]]
-        value = is_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
-    }
-    break;
-
-    case MemoryAccessSize::Word:
-    {
-      CPU::SafeReadMemoryWord(address, &value);
-    }
-    break;
-  }
-
-  value_changed = (value != old_value);
-}
-
 MemoryWatchList::MemoryWatchList() = default;
 
 MemoryWatchList::~MemoryWatchList() = default;
@@ -5,12 +5,14 @@
 
 #include "types.h"
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
 class Error;
+class TaskQueue;
 
 class MemoryScan
 {
@@ -44,11 +46,8 @@ public:
     bool value_changed;
 
     bool Filter(Operator op, u32 comp_value, bool is_signed) const;
-    void UpdateValue(MemoryAccessSize size, bool is_signed);
   };
 
-  using ResultVector = std::vector<Result>;
-
   MemoryScan();
   ~MemoryScan();
 
@@ -58,9 +57,8 @@ public:
   Operator GetOperator() const { return m_operator; }
   PhysicalMemoryAddress GetStartAddress() const { return m_start_address; }
   PhysicalMemoryAddress GetEndAddress() const { return m_end_address; }
-  const ResultVector& GetResults() const { return m_results; }
-  const Result& GetResult(u32 index) const { return m_results[index]; }
-  u32 GetResultCount() const { return static_cast<u32>(m_results.size()); }
+  u32 GetResultCount() const { return m_result_count; }
+  Result GetResult(u32 index) const;
 
   void SetValue(u32 value) { m_value = value; }
   void SetValueSigned(bool s) { m_signed = s; }
@@ -77,17 +75,47 @@ public:
   void SetResultValue(u32 index, u32 value);
 
 private:
-  void SearchBytes();
-  void SearchHalfwords();
-  void SearchWords();
+  /// Contiguous run of scannable addresses, elements are numbered across all spans.
+  struct Span
+  {
+    PhysicalMemoryAddress address;
+    u32 first_element;
+    u32 element_count;
+  };
+
+  u32 GetElementCount() const;
+  u32 GetResultElement(u32 index) const;
+  PhysicalMemoryAddress GetElementAddress(u32 element) const;
+  u32 GetElementValue(const std::vector<u8>& values, u32 element) const;
+
+  void BuildSpans();
+  void ReadValues(std::vector<u8>& values) const;
+  void FilterElements(const std::vector<u8>& values, const std::vector<u8>& last_values, Operator op, u32 comp_value,
+                      bool is_signed, std::vector<u64>& bitmap, const std::vector<u64>& mask_bitmap,
+                      bool multithreaded);
+  void UpdateChangedValues(bool multithreaded);
+  void UpdateResultRanks();
 
   u32 m_value = 0;
   MemoryAccessSize m_size = MemoryAccessSize::HalfWord;
   Operator m_operator = Operator::Any;
   PhysicalMemoryAddress m_start_address = 0;
   PhysicalMemoryAddress m_end_address = 0x200000;
-  ResultVector m_results;
   bool m_signed = false;
+
+  // Values are stored as raw snapshots of every scanned element, results are a bitmap over the elements.
+  std::vector<Span> m_spans;
+  u32 m_element_size = 0;
+  std::vector<u8> m_values;
+  std::vector<u8> m_last_values;
+  std::vector<u8> m_first_values;
+  std::vector<u64> m_result_bitmap;
+  std::vector<u64> m_changed_bitmap;
+  std::vector<u32> m_result_ranks; // number of results before each bitmap word
+  u32 m_result_count = 0;
+
+  // Created on the first large filter and kept for the lifetime of the scan, so searches don't spawn threads.
+  std::unique_ptr<TaskQueue> m_filter_queue;
 };
 
 class MemoryWatchList
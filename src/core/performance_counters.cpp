@@ -7,6 +7,7 @@
 #include "gpu_thread.h"
 #include "system.h"
 #include "system_private.h"
+#include "timing_event.h"
 
 #include "util/media_capture.h"
 
@@ -14,6 +15,9 @@
 #include "common/threading.h"
 #include "common/timer.h"
 
+#include <atomic>
+#include <bit>
+#include <cmath>
 #include <utility>
 
 LOG_CHANNEL(PerfMon);
@@ -55,15 +59,36 @@ struct State
   float accumulated_gpu_time;
   float gpu_usage;
 
+  GlobalTicks last_global_tick_counter;
+  u64 last_event_reschedule_count;
+  float event_reschedules_per_second;
+
   alignas(VECTOR_ALIGNMENT) FrameTimeHistory frame_time_history;
   u32 frame_time_history_pos;
+
+  GPUThreadQueueStats gpu_thread_queue_stats;
+};
+
+// Accumulated between updates. Producer stalls come from the CPU thread, so they're kept on a separate cache line.
+struct GPUThreadQueueAccumulators
+{
+  GPUThreadHistogram queue_depth;
+  GPUThreadHistogram consumer_idle_time;
+  u64 consumer_idle_ticks;
+
+  ALIGN_TO_CACHE_LINE std::array<std::atomic<u32>, NUM_GPU_THREAD_HISTOGRAM_BUCKETS> producer_stall_time;
+  std::atomic<u64> producer_stall_ticks;
 };
 
 } // namespace
 
+static u32 GetHistogramBucket(u64 value);
+static void UpdateGPUThreadQueueStats();
+
 static constexpr const float PERFORMANCE_COUNTER_UPDATE_INTERVAL = 1.0f;
 
 ALIGN_TO_CACHE_LINE State s_state = {};
+ALIGN_TO_CACHE_LINE GPUThreadQueueAccumulators s_gpu_thread_queue = {};
 
 } // namespace PerformanceCounters
 
@@ -127,6 +152,11 @@ float PerformanceCounters::GetGPUAverageTime()
   return s_state.average_gpu_time;
 }
 
+float PerformanceCounters::GetEventReschedulesPerSecond()
+{
+  return s_state.event_reschedules_per_second;
+}
+
 const PerformanceCounters::FrameTimeHistory& PerformanceCounters::GetFrameTimeHistory()
 {
   return s_state.frame_time_history;
@@ -137,9 +167,21 @@ u32 PerformanceCounters::GetFrameTimeHistoryPos()
   return s_state.frame_time_history_pos;
 }
 
+const PerformanceCounters::GPUThreadQueueStats& PerformanceCounters::GetGPUThreadQueueStats()
+{
+  return s_state.gpu_thread_queue_stats;
+}
+
 void PerformanceCounters::Clear()
 {
   s_state = {};
+
+  s_gpu_thread_queue.queue_depth = {};
+  s_gpu_thread_queue.consumer_idle_time = {};
+  s_gpu_thread_queue.consumer_idle_ticks = 0;
+  for (std::atomic<u32>& count : s_gpu_thread_queue.producer_stall_time)
+    count.store(0, std::memory_order_relaxed);
+  s_gpu_thread_queue.producer_stall_ticks.store(0, std::memory_order_relaxed);
 }
 
 void PerformanceCounters::Reset()
@@ -153,6 +195,8 @@ void PerformanceCounters::Reset()
   s_state.last_internal_frame_number = System::GetInternalFrameNumber();
   s_state.last_cpu_time = System::GetCPUThreadHandle().GetCPUTime();
   s_state.last_gpu_thread_time = GPUThread::Internal::GetThreadHandle().GetCPUTime();
+  s_state.last_global_tick_counter = TimingEvents::GetGlobalTickCounter();
+  s_state.last_event_reschedule_count = TimingEvents::GetRescheduleCount();
 
   s_state.average_frame_time_accumulator = 0.0f;
   s_state.minimum_frame_time_accumulator = 0.0f;
@@ -227,12 +271,27 @@ void PerformanceCounters::Update(GPUBackend* gpu, u32 frame_number, u32 internal
   s_state.accumulated_gpu_time = 0.0f;
   s_state.presents_since_last_update = 0;
 
+  // Per emulated second rather than host second, so it doesn't depend on the speed limiter.
+  const GlobalTicks global_ticks = TimingEvents::GetGlobalTickCounter();
+  const u64 reschedule_count = TimingEvents::GetRescheduleCount();
+  const GlobalTicks ticks_run = global_ticks - std::exchange(s_state.last_global_tick_counter, global_ticks);
+  const u64 reschedules = reschedule_count - std::exchange(s_state.last_event_reschedule_count, reschedule_count);
+  s_state.event_reschedules_per_second =
+    (ticks_run > 0) ? static_cast<float>(static_cast<double>(reschedules) * static_cast<double>(System::MASTER_CLOCK) /
+                                         static_cast<double>(ticks_run)) :
+                      0.0f;
+
   if (g_settings.display_show_gpu_stats)
     gpu->UpdateStatistics(frames_run);
 
-  VERBOSE_LOG("FPS: {:.2f} VPS: {:.2f} CPU: {:.2f} RNDR: {:.2f} GPU: {:.2f} Avg: {:.2f}ms Min: {:.2f}ms Max: {:.2f}ms",
+  UpdateGPUThreadQueueStats();
+
+  VERBOSE_LOG("FPS: {:.2f} VPS: {:.2f} CPU: {:.2f} RNDR: {:.2f} GPU: {:.2f} Avg: {:.2f}ms Min: {:.2f}ms Max: {:.2f}ms "
+              "Stall: {:.2f}ms Idle: {:.2f}ms Resched: {:.0f}/s",
               s_state.fps, s_state.vps, s_state.cpu_thread_usage, s_state.gpu_thread_usage, s_state.gpu_usage,
-              s_state.average_frame_time, s_state.minimum_frame_time, s_state.maximum_frame_time);
+              s_state.average_frame_time, s_state.minimum_frame_time, s_state.maximum_frame_time,
+              s_state.gpu_thread_queue_stats.producer_stall_ms, s_state.gpu_thread_queue_stats.consumer_idle_ms,
+              s_state.event_reschedules_per_second);
 
   Host::OnPerformanceCountersUpdated(gpu);
 }
@@ -242,3 +301,61 @@ void PerformanceCounters::AccumulateGPUTime()
   s_state.accumulated_gpu_time += g_gpu_device->GetAndResetAccumulatedGPUTime();
   s_state.presents_since_last_update++;
 }
+
+u32 PerformanceCounters::GetHistogramBucket(u64 value)
+{
+  return std::min<u32>(static_cast<u32>(std::bit_width(value)), NUM_GPU_THREAD_HISTOGRAM_BUCKETS - 1);
+}
+
+u32 PerformanceCounters::GetHistogramPercentileBucket(const GPUThreadHistogram& histogram, float fraction)
+{
+  u64 total = 0;
+  for (const u32 count : histogram)
+    total += count;
+  if (total == 0)
+    return 0;
+
+  const u64 target = std::max<u64>(static_cast<u64>(std::ceil(static_cast<double>(total) * fraction)), 1);
+  u64 running = 0;
+  for (u32 i = 0; i < NUM_GPU_THREAD_HISTOGRAM_BUCKETS; i++)
+  {
+    running += histogram[i];
+    if (running >= target)
+      return i;
+  }
+
+  return NUM_GPU_THREAD_HISTOGRAM_BUCKETS - 1;
+}
+
+void PerformanceCounters::RecordGPUThreadQueueDepth(u32 bytes)
+{
+  s_gpu_thread_queue.queue_depth[GetHistogramBucket(bytes / 1024)]++;
+}
+
+void PerformanceCounters::RecordGPUThreadProducerStall(u64 ticks)
+{
+  const u64 us = static_cast<u64>(Timer::ConvertValueToNanoseconds(ticks) / 1000.0);
+  s_gpu_thread_queue.producer_stall_time[GetHistogramBucket(us)].fetch_add(1, std::memory_order_relaxed);
+  s_gpu_thread_queue.producer_stall_ticks.fetch_add(ticks, std::memory_order_relaxed);
+}
+
+void PerformanceCounters::RecordGPUThreadConsumerIdle(u64 ticks)
+{
+  const u64 us = static_cast<u64>(Timer::ConvertValueToNanoseconds(ticks) / 1000.0);
+  s_gpu_thread_queue.consumer_idle_time[GetHistogramBucket(us)]++;
+  s_gpu_thread_queue.consumer_idle_ticks += ticks;
+}
+
+void PerformanceCounters::UpdateGPUThreadQueueStats()
+{
+  GPUThreadQueueStats& stats = s_state.gpu_thread_queue_stats;
+  stats.queue_depth = std::exchange(s_gpu_thread_queue.queue_depth, {});
+  stats.consumer_idle_time = std::exchange(s_gpu_thread_queue.consumer_idle_time, {});
+  for (u32 i = 0; i < NUM_GPU_THREAD_HISTOGRAM_BUCKETS; i++)
+    stats.producer_stall_time[i] = s_gpu_thread_queue.producer_stall_time[i].exchange(0, std::memory_order_relaxed);
+
+  stats.producer_stall_ms = static_cast<float>(
+    Timer::ConvertValueToMilliseconds(s_gpu_thread_queue.producer_stall_ticks.exchange(0, std::memory_order_relaxed)));
+  stats.consumer_idle_ms =
+    static_cast<float>(Timer::ConvertValueToMilliseconds(std::exchange(s_gpu_thread_queue.consumer_idle_ticks, 0)));
+}
@@ -12,6 +12,20 @@ namespace PerformanceCounters {
 inline constexpr u32 NUM_FRAME_TIME_SAMPLES = 152;
 using FrameTimeHistory = std::array<float, NUM_FRAME_TIME_SAMPLES>;
 
+/// Histograms are bucketed by powers of two, i.e. bucket N counts values in [2^(N-1), 2^N).
+inline constexpr u32 NUM_GPU_THREAD_HISTOGRAM_BUCKETS = 16;
+using GPUThreadHistogram = std::array<u32, NUM_GPU_THREAD_HISTOGRAM_BUCKETS>;
+
+/// GPU thread command FIFO statistics over the last update interval.
+struct GPUThreadQueueStats
+{
+  GPUThreadHistogram queue_depth;         // KiB pending when the GPU thread picks up work
+  GPUThreadHistogram producer_stall_time; // microseconds the CPU thread waited on the GPU thread
+  GPUThreadHistogram consumer_idle_time;  // microseconds the GPU thread waited for commands
+  float producer_stall_ms;
+  float consumer_idle_ms;
+};
+
 float GetFPS();
 float GetVPS();
 float GetEmulationSpeed();
@@ -24,12 +38,23 @@ float GetGPUThreadUsage();
 float GetGPUThreadAverageTime();
 float GetGPUUsage();
 float GetGPUAverageTime();
+float GetEventReschedulesPerSecond();
 const FrameTimeHistory& GetFrameTimeHistory();
 u32 GetFrameTimeHistoryPos();
+const GPUThreadQueueStats& GetGPUThreadQueueStats();
+
+/// Returns the bucket which the given fraction (0-1) of samples falls at or below, or 0 for an empty histogram.
+u32 GetHistogramPercentileBucket(const GPUThreadHistogram& histogram, float fraction);
 
 void Clear();
 void Reset();
 void Update(GPUBackend* gpu, u32 frame_number, u32 internal_frame_number);
 void AccumulateGPUTime();
 
+/// Stall times are in Timer ticks. Producer stalls can be recorded from the CPU thread, everything else from the GPU
+/// thread only.
+void RecordGPUThreadQueueDepth(u32 bytes);
+void RecordGPUThreadProducerStall(u64 ticks);
+void RecordGPUThreadConsumerIdle(u64 ticks);
+
 } // namespace PerformanceCounters
@@ -57,6 +57,7 @@ struct GPUSettings
   s8 display_line_end_offset = 0;
 
   u8 gpu_max_queued_frames = DEFAULT_GPU_MAX_QUEUED_FRAMES;
+  u8 gpu_sw_threads = 1; // 0 = automatic
   bool gpu_use_thread : 1 = true;
   bool gpu_use_software_renderer_for_readbacks : 1 = false;
   bool gpu_use_debug_device : 1 = false;
@@ -256,10 +257,14 @@ struct Settings : public GPUSettings
   bool cpu_recompiler_memory_exceptions : 1 = false;
   bool cpu_recompiler_block_linking : 1 = true;
   bool cpu_recompiler_icache : 1 = false;
+  bool cpu_recompiler_block_cache : 1 = false;
+  bool cpu_recompiler_deferred_compilation : 1 = false;
+  bool cpu_recompiler_superblocks : 1 = false;
   bool cpu_enable_8mb_ram : 1 = false;
 
   bool mdec_use_old_routines : 1 = false;
   bool mdec_disable_cdrom_speedup : 1 = false;
+  bool mdec_use_worker_thread : 1 = false;
 
   bool pcdrv_enable : 1 = false;
   bool pcdrv_enable_writes : 1 = false;
@@ -285,6 +290,7 @@ struct Settings : public GPUSettings
   bool bios_fast_forward_boot : 1 = false;
 
   bool rewind_enable : 1 = false;
+  bool rewind_compression : 1 = false;
   bool runahead_for_analog_input : 1 = false;
 
   bool apply_compatibility_settings : 1 = true;
@@ -16,10 +16,12 @@
 #include "util/state_wrapper.h"
 #include "util/wav_reader_writer.h"
 
+#include "common/align.h"
 #include "common/bitfield.h"
 #include "common/bitutils.h"
 #include "common/error.h"
 #include "common/fifo_queue.h"
+#include "common/gsvector.h"
 #include "common/log.h"
 #include "common/path.h"
 
@@ -64,7 +66,10 @@ enum : u32
   CAPTURE_BUFFER_SIZE_PER_CHANNEL = 0x400,
   MINIMUM_TICKS_BETWEEN_KEY_ON_OFF = 2,
   NUM_REVERB_REGS = 32,
-  FIFO_SIZE_IN_HALFWORDS = 32
+  FIFO_SIZE_IN_HALFWORDS = 32,
+  MIX_BATCH_FRAMES = 32,
+  ADPCM_CACHE_BLOCK_SHIFT = 4,
+  NUM_ADPCM_CACHE_BLOCKS = RAM_SIZE >> ADPCM_CACHE_BLOCK_SHIFT,
 };
 enum : TickCount
 {
@@ -213,6 +218,13 @@ struct ADPCMBlock
   u8 GetNibble(u32 index) const { return (data[index / 2] >> ((index % 2) * 4)) & 0x0F; }
 };
 
+// Decoded samples for a 16-byte aligned block of SPU RAM.
+struct ADPCMCacheEntry
+{
+  std::array<s16, NUM_SAMPLES_PER_ADPCM_BLOCK> samples;
+  std::array<s16, 2> input_samples; // filter history the block was decoded with
+};
+
 struct VolumeEnvelope
 {
   static constexpr s32 MIN_VOLUME = -32768;
@@ -275,7 +287,7 @@ struct Voice
   void KeyOff();
   void ForceOff();
 
-  void DecodeBlock(const ADPCMBlock& block);
+  void DecodeBlock(const ADPCMBlock& block, u16 address);
   s32 Interpolate() const;
 
   // Switches to the specified phase, filling in target.
@@ -341,11 +353,16 @@ static bool CheckRAMIRQ(u32 address);
 static void TriggerRAMIRQ();
 static void CheckForLateRAMIRQs();
 
+static void InvalidateADPCMCache(u32 ram_address);
+static void InvalidateAllADPCMCache();
+
 static void WriteToCaptureBuffer(u32 index, s16 value);
 static void IncrementCaptureBufferPosition();
 
 static void ReadADPCMBlock(u16 address, ADPCMBlock* block);
-static std::tuple<s32, s32> SampleVoice(u32 voice_index);
+static std::tuple<s32, s32> SampleVoice(u32 voice_index, s32 noise_level, s32 prev_voice_volume);
+static bool CanMixVoicesInBatch();
+static void MixFrames(s16* output_frame, u32 count);
 
 static void UpdateNoise();
 
@@ -442,6 +459,8 @@ struct SPUState
 
 ALIGN_TO_CACHE_LINE static SPUState s_state;
 ALIGN_TO_CACHE_LINE static std::array<u8, RAM_SIZE> s_ram{};
+ALIGN_TO_CACHE_LINE static std::array<ADPCMCacheEntry, NUM_ADPCM_CACHE_BLOCKS> s_adpcm_cache;
+static std::array<u64, NUM_ADPCM_CACHE_BLOCKS / 64> s_adpcm_cache_valid{};
 ALIGN_TO_CACHE_LINE static std::array<s16, (44100 / 60) * 2> s_muted_output_buffer{};
 
 } // namespace SPU
@@ -610,6 +629,7 @@ void SPU::Reset()
   s_state.transfer_event.Deactivate();
   s_state.transfer_fifo.Clear();
   s_ram.fill(0);
+  InvalidateAllADPCMCache();
   UpdateEventInterval();
 }
 
@@ -729,6 +749,7 @@ bool SPU::DoCompatibleState(StateWrapper& sw)
 
   if (sw.IsReading())
   {
+    InvalidateAllADPCMCache();
     UpdateEventInterval();
     UpdateTransferEvent();
   }
@@ -1362,6 +1383,7 @@ void SPU::WriteToCaptureBuffer(u32 index, s16 value)
   const u32 ram_address = (index * CAPTURE_BUFFER_SIZE_PER_CHANNEL) | ZeroExtend16(s_state.capture_buffer_position);
   // Log_DebugFmt("write to capture buffer {} (0x{:08X}) <- 0x{:04X}", index, ram_address, u16(value));
   std::memcpy(&s_ram[ram_address], &value, sizeof(value));
+  InvalidateADPCMCache(ram_address);
   if (IsRAMIRQTriggerable() && CheckRAMIRQ(ram_address))
   {
     DEBUG_LOG("Trigger IRQ @ {:08X} ({:04X}) from capture buffer", ram_address, ram_address / 8);
@@ -1401,6 +1423,7 @@ ALWAYS_INLINE_RELEASE void SPU::ExecuteFIFOWriteToRAM(TickCount& ticks)
   {
     u16 value = s_state.transfer_fifo.Pop();
     std::memcpy(&s_ram[s_state.transfer_address], &value, sizeof(u16));
+    InvalidateADPCMCache(s_state.transfer_address);
     s_state.transfer_address = (s_state.transfer_address + sizeof(u16)) & RAM_MASK;
     ticks -= TRANSFER_TICKS_PER_HALFWORD;
 
@@ -1478,6 +1501,7 @@ void SPU::ManualTransferWrite(u16 value)
   }
 
   std::memcpy(&s_ram[s_state.transfer_address], &value, sizeof(u16));
+  InvalidateADPCMCache(s_state.transfer_address);
   s_state.transfer_address = (s_state.transfer_address + sizeof(u16)) & RAM_MASK;
 
   if (IsRAMIRQTriggerable() && CheckRAMIRQ(s_state.transfer_address))
@@ -1662,9 +1686,22 @@ const std::array<u8, SPU::RAM_SIZE>& SPU::GetRAM()
 
 std::array<u8, SPU::RAM_SIZE>& SPU::GetWritableRAM()
 {
+  // Caller can modify anything, so any decoded blocks may be stale.
+  InvalidateAllADPCMCache();
   return s_ram;
 }
 
+void SPU::InvalidateADPCMCache(u32 ram_address)
+{
+  const u32 index = ram_address >> ADPCM_CACHE_BLOCK_SHIFT;
+  s_adpcm_cache_valid[index / 64] &= ~(u64(1) << (index % 64));
+}
+
+void SPU::InvalidateAllADPCMCache()
+{
+  s_adpcm_cache_valid.fill(0);
+}
+
 bool SPU::IsAudioOutputMuted()
 {
   return s_state.audio_output_muted;
@@ -1906,7 +1943,7 @@ void SPU::Voice::TickADSR()
   }
 }
 
-void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
+void SPU::Voice::DecodeBlock(const ADPCMBlock& block, u16 address)
 {
   static constexpr std::array<s8, 16> filter_table_pos = {{0, 60, 115, 98, 122, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
   static constexpr std::array<s8, 16> filter_table_neg = {{0, 0, -52, -55, -60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
@@ -1921,6 +1958,26 @@ void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
   const u8 filter_index = block.GetFilter();
   const s32 filter_pos = filter_table_pos[filter_index];
   const s32 filter_neg = filter_table_neg[filter_index];
+  current_block_flags.bits = block.flags.bits;
+
+  // Blocks are cached by RAM location, odd addresses straddle two cache blocks and always get decoded. The filter
+  // feeds back the last two samples of the previous block, so unless it ignores them, the cached samples can only be
+  // used when they were decoded from the same history.
+  const u32 ram_address = (ZeroExtend32(address) * 8) & RAM_MASK;
+  const u32 cache_index = ram_address >> ADPCM_CACHE_BLOCK_SHIFT;
+  const u64 cache_valid_bit = u64(1) << (cache_index % 64);
+  const bool cacheable = ((address & 1u) == 0);
+  ADPCMCacheEntry& cache_entry = s_adpcm_cache[cache_index];
+  if (cacheable && (s_adpcm_cache_valid[cache_index / 64] & cache_valid_bit) &&
+      ((filter_pos == 0 && filter_neg == 0) || cache_entry.input_samples == adpcm_last_samples))
+  {
+    std::copy(cache_entry.samples.begin(), cache_entry.samples.end(),
+              &current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK]);
+    adpcm_last_samples[0] = cache_entry.samples[NUM_SAMPLES_PER_ADPCM_BLOCK - 1];
+    adpcm_last_samples[1] = cache_entry.samples[NUM_SAMPLES_PER_ADPCM_BLOCK - 2];
+    return;
+  }
+
   s16 last_samples[2] = {adpcm_last_samples[0], adpcm_last_samples[1]};
 
   // samples
@@ -1935,8 +1992,15 @@ void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
     current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + i] = last_samples[0] = static_cast<s16>(Clamp16(sample));
   }
 
+  if (cacheable)
+  {
+    cache_entry.input_samples = adpcm_last_samples;
+    std::copy_n(&current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK], NUM_SAMPLES_PER_ADPCM_BLOCK,
+                cache_entry.samples.begin());
+    s_adpcm_cache_valid[cache_index / 64] |= cache_valid_bit;
+  }
+
   std::copy(last_samples, last_samples + countof(last_samples), adpcm_last_samples.begin());
-  current_block_flags.bits = block.flags.bits;
 }
 
 s32 SPU::Voice::Interpolate() const
@@ -2045,7 +2109,8 @@ void SPU::ReadADPCMBlock(u16 address, ADPCMBlock* block)
   }
 }
 
-ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
+ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index, s32 noise_level,
+                                                             s32 prev_voice_volume)
 {
   Voice& voice = s_state.voices[voice_index];
   if (!voice.IsOn() && !s_state.SPUCNT.irq9_enable)
@@ -2067,7 +2132,7 @@ ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
   {
     ADPCMBlock block;
     ReadADPCMBlock(voice.current_address, &block);
-    voice.DecodeBlock(block);
+    voice.DecodeBlock(block, voice.current_address);
     voice.has_samples = true;
 
     if (voice.current_block_flags.loop_start && !voice.ignore_loop_address)
@@ -2084,7 +2149,7 @@ ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
     // interpolate/sample and apply ADSR volume
     s32 sample;
     if (IsVoiceNoiseEnabled(voice_index))
-      sample = GetVoiceNoiseLevel();
+      sample = noise_level;
     else
       sample = voice.Interpolate();
 
@@ -2104,7 +2169,7 @@ ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
   u16 step = voice.regs.adpcm_sample_rate;
   if (IsPitchModulationEnabled(voice_index))
   {
-    const s32 factor = std::clamp<s32>(s_state.voices[voice_index - 1].last_volume, -0x8000, 0x7FFF) + 0x8000;
+    const s32 factor = std::clamp<s32>(prev_voice_volume, -0x8000, 0x7FFF) + 0x8000;
     step = Truncate16(static_cast<u32>((SignExtend32(step) * factor) >> 15));
   }
   step = std::min<u16>(step, 0x3FFF);
@@ -2222,6 +2287,7 @@ void SPU::ReverbWrite(u32 address, s16 data)
   // TODO: This should check interrupts.
   const u32 real_address = ReverbMemoryAddress(address << 2);
   std::memcpy(&s_ram[real_address], &data, sizeof(data));
+  InvalidateADPCMCache(real_address);
 }
 
 void SPU::ProcessReverb(s32 left_in, s32 right_in, s32* left_out, s32* right_out)
@@ -2387,6 +2453,163 @@ void SPU::ProcessReverb(s32 left_in, s32 right_in, s32* left_out, s32* right_out
 #endif
 }
 
+bool SPU::CanMixVoicesInBatch()
+{
+  // Voices are sampled a whole batch at a time, but the capture buffers and reverb still write RAM once per frame.
+  // If any voice could decode a block from those regions during the batch, it has to be interleaved with the writes.
+  // At most four samples are consumed per frame, and loops only jump back to addresses that have already been read.
+  static constexpr u32 CAPTURE_BUFFER_END = CAPTURE_BUFFER_SIZE_PER_CHANNEL * 4;
+  static constexpr u32 READ_WINDOW =
+    ((MIX_BATCH_FRAMES * 4) / NUM_SAMPLES_PER_ADPCM_BLOCK + 2) * static_cast<u32>(sizeof(ADPCMBlock));
+  const u32 reverb_start = s_state.SPUCNT.reverb_master_enable ? (s_state.reverb_base_address * 2) : RAM_SIZE;
+  const auto overlaps_written_ram = [reverb_start](u16 address) {
+    // Windows which wrap around the end of RAM also cover the capture buffers.
+    const u32 start = ZeroExtend32(address) * 8;
+    return (start < CAPTURE_BUFFER_END || (start + READ_WINDOW) > reverb_start);
+  };
+
+  for (const Voice& voice : s_state.voices)
+  {
+    if (!voice.IsOn() && !s_state.SPUCNT.irq9_enable)
+      continue;
+
+    if (overlaps_written_ram(voice.current_address) || overlaps_written_ram(voice.regs.adpcm_repeat_address))
+      return false;
+  }
+
+  return true;
+}
+
+void SPU::MixFrames(s16* output_frame, u32 count)
+{
+  DebugAssert(count > 0 && count <= MIX_BATCH_FRAMES);
+
+  // Voice outputs are accumulated four frames at a time, so pad the batch out to a full vector.
+  const u32 aligned_count = Common::AlignUpPow2(count, 4);
+
+  alignas(VECTOR_ALIGNMENT) std::array<s32, MIX_BATCH_FRAMES> mixed_left = {};
+  alignas(VECTOR_ALIGNMENT) std::array<s32, MIX_BATCH_FRAMES> mixed_right = {};
+  alignas(VECTOR_ALIGNMENT) std::array<s32, MIX_BATCH_FRAMES> mixed_reverb_left = {};
+  alignas(VECTOR_ALIGNMENT) std::array<s32, MIX_BATCH_FRAMES> mixed_reverb_right = {};
+  alignas(VECTOR_ALIGNMENT) std::array<s32, MIX_BATCH_FRAMES> voice_left = {};
+  alignas(VECTOR_ALIGNMENT) std::array<s32, MIX_BATCH_FRAMES> voice_right = {};
+  std::array<s32, MIX_BATCH_FRAMES> voice_volumes = {};
+  std::array<s32, MIX_BATCH_FRAMES> capture_voice1;
+  std::array<s32, MIX_BATCH_FRAMES> capture_voice3;
+  std::array<s32, MIX_BATCH_FRAMES> noise_levels;
+
+  // Noise only depends on its own state, and is updated once per frame after the voices are sampled.
+  for (u32 i = 0; i < count; i++)
+  {
+    noise_levels[i] = GetVoiceNoiseLevel();
+    UpdateNoise();
+  }
+
+  u32 reverb_on_register = s_state.reverb_on_register;
+  for (u32 voice = 0; voice < NUM_VOICES; voice++)
+  {
+    // Pitch modulation uses the previous voice's volume from the same frame, which is still in voice_volumes.
+    for (u32 i = 0; i < count; i++)
+    {
+      const auto [left, right] = SampleVoice(voice, noise_levels[i], voice_volumes[i]);
+      voice_volumes[i] = s_state.voices[voice].last_volume;
+      voice_left[i] = left;
+      voice_right[i] = right;
+    }
+
+    if (voice == 1)
+      capture_voice1 = voice_volumes;
+    else if (voice == 3)
+      capture_voice3 = voice_volumes;
+
+    const bool reverb = (reverb_on_register & 1u);
+    reverb_on_register >>= 1;
+    for (u32 i = 0; i < aligned_count; i += 4)
+    {
+      const GSVector4i left = GSVector4i::load<true>(&voice_left[i]);
+      const GSVector4i right = GSVector4i::load<true>(&voice_right[i]);
+      GSVector4i::store<true>(&mixed_left[i], GSVector4i::load<true>(&mixed_left[i]).add32(left));
+      GSVector4i::store<true>(&mixed_right[i], GSVector4i::load<true>(&mixed_right[i]).add32(right));
+      if (reverb)
+      {
+        GSVector4i::store<true>(&mixed_reverb_left[i], GSVector4i::load<true>(&mixed_reverb_left[i]).add32(left));
+        GSVector4i::store<true>(&mixed_reverb_right[i], GSVector4i::load<true>(&mixed_reverb_right[i]).add32(right));
+      }
+    }
+  }
+
+  for (u32 i = 0; i < count; i++)
+  {
+    s32 left_sum = mixed_left[i];
+    s32 right_sum = mixed_right[i];
+    s32 reverb_in_left = mixed_reverb_left[i];
+    s32 reverb_in_right = mixed_reverb_right[i];
+
+    if (!s_state.SPUCNT.mute_n)
+    {
+      left_sum = 0;
+      right_sum = 0;
+      reverb_in_left = 0;
+      reverb_in_right = 0;
+    }
+
+    // Mix in CD audio.
+    const auto [cd_audio_left, cd_audio_right] = CDROM::GetAudioFrame();
+    if (s_state.SPUCNT.cd_audio_enable)
+    {
+      const s32 cd_audio_volume_left = ApplyVolume(s32(cd_audio_left), s_state.cd_audio_volume_left);
+      const s32 cd_audio_volume_right = ApplyVolume(s32(cd_audio_right), s_state.cd_audio_volume_right);
+
+      left_sum += cd_audio_volume_left;
+      right_sum += cd_audio_volume_right;
+
+      if (s_state.SPUCNT.cd_audio_reverb)
+      {
+        reverb_in_left += cd_audio_volume_left;
+        reverb_in_right += cd_audio_volume_right;
+      }
+
+#ifdef SPU_ENABLE_VU_METER
+      if (IsVUMeterActive())
+        UpdateDebugPeaks(s_state.cd_audio_peaks, cd_audio_volume_left, cd_audio_volume_right);
+#endif
+    }
+
+    // Compute reverb.
+    s32 reverb_out_left, reverb_out_right;
+    ProcessReverb(Clamp16(reverb_in_left), Clamp16(reverb_in_right), &reverb_out_left, &reverb_out_right);
+
+    // Mix in reverb.
+    left_sum += reverb_out_left;
+    right_sum += reverb_out_right;
+
+    // Apply main volume after clamping. A maximum volume should not overflow here because both are 16-bit values.
+#ifdef SPU_ENABLE_VU_METER
+    const s16 final_left = static_cast<s16>(ApplyVolume(Clamp16(left_sum), s_state.main_volume_left.current_level));
+    const s16 final_right =
+      static_cast<s16>(ApplyVolume(Clamp16(right_sum), s_state.main_volume_right.current_level));
+    *(output_frame++) = final_left;
+    *(output_frame++) = final_right;
+
+    if (IsVUMeterActive())
+      UpdateDebugPeaks(s_state.output_peaks, final_left, final_right);
+#else
+    *(output_frame++) = static_cast<s16>(ApplyVolume(Clamp16(left_sum), s_state.main_volume_left.current_level));
+    *(output_frame++) = static_cast<s16>(ApplyVolume(Clamp16(right_sum), s_state.main_volume_right.current_level));
+#endif
+
+    s_state.main_volume_left.Tick();
+    s_state.main_volume_right.Tick();
+
+    // Write to capture buffers.
+    WriteToCaptureBuffer(0, cd_audio_left);
+    WriteToCaptureBuffer(1, cd_audio_right);
+    WriteToCaptureBuffer(2, static_cast<s16>(Clamp16(capture_voice1[i])));
+    WriteToCaptureBuffer(3, static_cast<s16>(Clamp16(capture_voice3[i])));
+    IncrementCaptureBufferPosition();
+  }
+}
+
 void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
 {
   u32 remaining_frames;
@@ -2422,97 +2645,18 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
 
     s16* output_frame = output_frame_start;
     const u32 frames_in_this_batch = std::min(remaining_frames, output_frame_space);
-    for (u32 i = 0; i < frames_in_this_batch; i++)
-    {
-      s32 left_sum = 0;
-      s32 right_sum = 0;
-      s32 reverb_in_left = 0;
-      s32 reverb_in_right = 0;
-
-      u32 reverb_on_register = s_state.reverb_on_register;
-
-      for (u32 voice = 0; voice < NUM_VOICES; voice++)
-      {
-        const auto [left, right] = SampleVoice(voice);
-        left_sum += left;
-        right_sum += right;
-
-        if (reverb_on_register & 1u)
-        {
-          reverb_in_left += left;
-          reverb_in_right += right;
-        }
-        reverb_on_register >>= 1;
-      }
-
-      if (!s_state.SPUCNT.mute_n)
-      {
-        left_sum = 0;
-        right_sum = 0;
-        reverb_in_left = 0;
-        reverb_in_right = 0;
-      }
-
-      // Update noise once per frame.
-      UpdateNoise();
-
-      // Mix in CD audio.
-      const auto [cd_audio_left, cd_audio_right] = CDROM::GetAudioFrame();
-      if (s_state.SPUCNT.cd_audio_enable)
-      {
-        const s32 cd_audio_volume_left = ApplyVolume(s32(cd_audio_left), s_state.cd_audio_volume_left);
-        const s32 cd_audio_volume_right = ApplyVolume(s32(cd_audio_right), s_state.cd_audio_volume_right);
-
-        left_sum += cd_audio_volume_left;
-        right_sum += cd_audio_volume_right;
-
-        if (s_state.SPUCNT.cd_audio_reverb)
-        {
-          reverb_in_left += cd_audio_volume_left;
-          reverb_in_right += cd_audio_volume_right;
-        }
-
-#ifdef SPU_ENABLE_VU_METER
-        if (IsVUMeterActive())
-          UpdateDebugPeaks(s_state.cd_audio_peaks, cd_audio_volume_left, cd_audio_volume_right);
-#endif
-      }
-
-      // Compute reverb.
-      s32 reverb_out_left, reverb_out_right;
-      ProcessReverb(Clamp16(reverb_in_left), Clamp16(reverb_in_right), &reverb_out_left, &reverb_out_right);
-
-      // Mix in reverb.
-      left_sum += reverb_out_left;
-      right_sum += reverb_out_right;
-
-      // Apply main volume after clamping. A maximum volume should not overflow here because both are 16-bit values.
-#ifdef SPU_ENABLE_VU_METER
-      const s16 final_left = static_cast<s16>(ApplyVolume(Clamp16(left_sum), s_state.main_volume_left.current_level));
-      const s16 final_right =
-        static_cast<s16>(ApplyVolume(Clamp16(right_sum), s_state.main_volume_right.current_level));
-      *(output_frame++) = final_left;
-      *(output_frame++) = final_right;
-
-      if (IsVUMeterActive())
-        UpdateDebugPeaks(s_state.output_peaks, final_left, final_right);
-#else
-      *(output_frame++) = static_cast<s16>(ApplyVolume(Clamp16(left_sum), s_state.main_volume_left.current_level));
-      *(output_frame++) = static_cast<s16>(ApplyVolume(Clamp16(right_sum), s_state.main_volume_right.current_level));
-#endif
-
-      s_state.main_volume_left.Tick();
-      s_state.main_volume_right.Tick();
-
-      // Write to capture buffers.
-      WriteToCaptureBuffer(0, cd_audio_left);
-      WriteToCaptureBuffer(1, cd_audio_right);
-      WriteToCaptureBuffer(2, static_cast<s16>(Clamp16(s_state.voices[1].last_volume)));
-      WriteToCaptureBuffer(3, static_cast<s16>(Clamp16(s_state.voices[3].last_volume)));
-      IncrementCaptureBufferPosition();
-
-      // Key off/on voices after the first frame.
-      if (i == 0 && (s_state.key_off_register != 0 || s_state.key_on_register != 0))
+    for (u32 i = 0; i < frames_in_this_batch;)
+    {
+      // Key off/on voices after the first frame, so that frame has to be mixed on its own.
+      const bool key_on_off = (i == 0 && (s_state.key_off_register != 0 || s_state.key_on_register != 0));
+      const u32 frames_to_mix = (key_on_off || !CanMixVoicesInBatch()) ?
+                                  1 :
+                                  std::min(frames_in_this_batch - i, static_cast<u32>(MIX_BATCH_FRAMES));
+      MixFrames(output_frame, frames_to_mix);
+      output_frame += frames_to_mix * 2;
+      i += frames_to_mix;
+
+      if (key_on_off)
       {
         u32 key_off_register = s_state.key_off_register;
         s_state.key_off_register = 0;
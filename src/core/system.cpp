@@ -57,6 +57,7 @@
 
 #include "common/align.h"
 #include "common/binary_reader_writer.h"
+#include "common/bitutils.h"
 #include "common/dynamic_library.h"
 #include "common/error.h"
 #include "common/file_system.h"
@@ -85,6 +86,7 @@
 #include <cinttypes>
 #include <cmath>
 #include <cstdio>
+#include <deque>
 #include <limits>
 #include <thread>
 
@@ -143,6 +145,15 @@ struct UndoSaveStateBuffer : public SaveStateBuffer
   time_t timestamp;
 };
 
+struct PendingSaveState
+{
+  std::string path;
+  std::string osd_key;
+  SaveStateBuffer buffer;
+  SaveStateCompressionMode compression;
+  bool backup_existing_save;
+};
+
 } // namespace
 
 static void CheckCacheLineSize();
@@ -220,6 +231,8 @@ static bool SaveStateBufferToFile(const SaveStateBuffer& buffer, std::FILE* fp,
                                   SaveStateCompressionMode compression_mode);
 static u32 CompressAndWriteStateData(std::FILE* fp, std::span<const u8> src, SaveStateCompressionMode method,
                                      u32* header_type, Error* error);
+static void WritePendingSaveState(PendingSaveState& pss);
+static void ProcessSaveStateQueue();
 static bool DoState(StateWrapper& sw, bool update_display);
 static void DoMemoryState(StateWrapper& sw, MemorySaveState& mss, bool update_display);
 
@@ -302,6 +315,8 @@ struct ALIGN_TO_CACHE_LINE StateVars
   std::vector<MemorySaveState> memory_save_states;
   u32 memory_save_state_front = 0;
   u32 memory_save_state_count = 0;
+  bool memory_save_state_compression = false;
+  std::atomic<size_t> memory_save_state_delta_size{0};
 
   const BIOS::ImageInfo* bios_image_info = nullptr;
   BIOS::ImageInfo::Hash bios_hash = {};
@@ -332,6 +347,12 @@ struct ALIGN_TO_CACHE_LINE StateVars
   // internal async task counters
   std::atomic_uint32_t outstanding_save_state_tasks{0};
 
+  // save states are compressed and written in order on a worker thread, one at a time
+  std::mutex save_state_queue_mutex;
+  std::deque<PendingSaveState> save_state_queue;
+  DynamicHeapArray<u8> save_state_spare_buffer;
+  bool save_state_queue_active = false;
+
   // async task pool
   TaskQueue async_task_queue;
 
@@ -562,6 +583,7 @@ void System::CPUThreadShutdown()
   InputManager::CloseSources();
 
   s_state.async_task_queue.SetWorkerCount(0);
+  s_state.save_state_spare_buffer.deallocate();
   s_state.cpu_thread_handle = {};
 
 #ifdef _WIN32
@@ -657,6 +679,22 @@ size_t System::GetGPUDumpFrameCount()
   return s_state.gpu_dump_player ? s_state.gpu_dump_player->GetFrameCount() : 0;
 }
 
+bool System::SeekGPUDump(size_t frame, Error* error)
+{
+  if (!s_state.gpu_dump_player)
+  {
+    Error::SetStringView(error, "Not replaying a GPU dump.");
+    return false;
+  }
+
+  if (!s_state.gpu_dump_player->SeekToFrame(frame, error))
+    return false;
+
+  // player position has been changed, toss call stack
+  InterruptExecution();
+  return true;
+}
+
 bool System::IsStartupCancelled()
 {
   return s_state.startup_cancelled.load(std::memory_order_acquire);
@@ -2605,6 +2643,9 @@ System::MemorySaveState& System::GetFirstMemoryState()
   const u32 max_count = static_cast<u32>(s_state.memory_save_states.size());
   DebugAssert(s_state.memory_save_state_count > 0);
 
+  // Older states are deltas against newer states when compression is enabled, and can't be loaded directly.
+  DebugAssert(!s_state.memory_save_state_compression || s_state.memory_save_state_count == 1);
+
   const s32 front =
     static_cast<s32>(s_state.memory_save_state_front) - static_cast<s32>(s_state.memory_save_state_count);
   const u32 idx = static_cast<u32>((front < 0) ? (front + static_cast<s32>(max_count)) : front);
@@ -2619,7 +2660,29 @@ System::MemorySaveState& System::PopMemoryState()
 
   const s32 front = static_cast<s32>(s_state.memory_save_state_front) - 1;
   s_state.memory_save_state_front = static_cast<u32>((front < 0) ? (front + static_cast<s32>(max_count)) : front);
-  return s_state.memory_save_states[s_state.memory_save_state_front];
+  MemorySaveState& ret = s_state.memory_save_states[s_state.memory_save_state_front];
+
+  // The state before this one becomes the newest, so it has to be reconstructed from the state we're popping.
+  if (s_state.memory_save_state_compression && s_state.memory_save_state_count > 0)
+  {
+    MemorySaveState& prev =
+      s_state.memory_save_states[(s_state.memory_save_state_front + max_count - 1) % max_count];
+    s_state.memory_save_state_delta_size.fetch_sub(prev.state_delta.size(), std::memory_order_relaxed);
+    DecodeMemoryStateDelta(prev.state_data, prev.state_size, GetMaxMemorySaveStateSize(), prev.state_delta,
+                           ret.state_data.cspan(0, ret.state_size));
+
+    // GPU state is only touched on the GPU thread, queue it behind any pending save of the state we're popping.
+    GPUThread::RunOnThread([&ret, &prev]() {
+      if (!prev.gpu_state_data.empty() || prev.gpu_state_capacity == 0)
+        return;
+
+      s_state.memory_save_state_delta_size.fetch_sub(prev.gpu_state_delta.size(), std::memory_order_relaxed);
+      DecodeMemoryStateDelta(prev.gpu_state_data, prev.gpu_state_size, prev.gpu_state_capacity, prev.gpu_state_delta,
+                             ret.gpu_state_data.cspan(0, ret.gpu_state_size));
+    });
+  }
+
+  return ret;
 }
 
 bool System::AllocateMemoryStates(size_t state_count, bool recycle_old_textures)
@@ -2638,9 +2701,11 @@ bool System::AllocateMemoryStates(size_t state_count, bool recycle_old_textures)
   for (MemorySaveState& mss : s_state.memory_save_states)
   {
     mss.state_size = 0;
+    mss.state_delta.deallocate();
     if (mss.state_data.size() != size)
       mss.state_data.resize(size);
   }
+  s_state.memory_save_state_delta_size.store(0, std::memory_order_relaxed);
 
   // Allocate GPU buffers.
   Error error;
@@ -2688,7 +2753,8 @@ void System::FreeMemoryStateStorage(bool release_memory, bool release_textures,
 
     for (MemorySaveState& mss : s_state.memory_save_states)
     {
-      if ((mss.vram_texture || !mss.gpu_state_data.empty()) && !gpu_thread_synced)
+      if ((mss.vram_texture || !mss.gpu_state_data.empty() || s_state.memory_save_state_compression) &&
+          !gpu_thread_synced)
       {
         gpu_thread_synced = true;
         GPUThread::SyncGPUThread(true);
@@ -2703,11 +2769,16 @@ void System::FreeMemoryStateStorage(bool release_memory, bool release_textures,
       }
 
       mss.gpu_state_data.deallocate();
+      mss.gpu_state_delta.deallocate();
       mss.gpu_state_size = 0;
+      mss.gpu_state_capacity = 0;
       mss.state_data.deallocate();
+      mss.state_delta.deallocate();
       mss.state_size = 0;
     }
 
+    s_state.memory_save_state_delta_size.store(0, std::memory_order_relaxed);
+
     if (!textures.empty())
     {
       GPUThread::RunOnThread([textures = std::move(textures), recycle_textures]() mutable {
@@ -2755,11 +2826,54 @@ void System::SaveMemoryState(MemorySaveState& mss)
   Timer save_timer;
 #endif
 
+  // With compression, the previously-newest state gets turned into a delta against this one.
+  MemorySaveState* prev_mss = nullptr;
+  if (s_state.memory_save_state_compression)
+  {
+    // The slot we're overwriting may be the oldest delta, or a released buffer.
+    s_state.memory_save_state_delta_size.fetch_sub(mss.state_delta.size(), std::memory_order_relaxed);
+    mss.state_delta.deallocate();
+    if (mss.state_data.empty())
+      mss.state_data.resize(GetMaxMemorySaveStateSize());
+
+    GPUThread::RunOnThread([&mss]() {
+      s_state.memory_save_state_delta_size.fetch_sub(mss.gpu_state_delta.size(), std::memory_order_relaxed);
+      mss.gpu_state_delta.deallocate();
+      if (mss.gpu_state_data.size() != mss.gpu_state_capacity)
+        mss.gpu_state_data.resize(mss.gpu_state_capacity);
+    });
+
+    if (s_state.memory_save_state_count > 1)
+    {
+      const size_t max_count = s_state.memory_save_states.size();
+      prev_mss = &s_state.memory_save_states[(static_cast<size_t>(&mss - s_state.memory_save_states.data()) +
+                                              max_count - 1) %
+                                             max_count];
+    }
+  }
+
   StateWrapper sw(mss.state_data.span(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
   DoMemoryState(sw, mss, false);
   DebugAssert(!sw.HasError());
   mss.state_size = sw.GetPosition();
 
+  if (prev_mss)
+  {
+    EncodeMemoryStateDelta(prev_mss->state_data, prev_mss->state_size, prev_mss->state_delta,
+                           mss.state_data.cspan(0, mss.state_size));
+    s_state.memory_save_state_delta_size.fetch_add(prev_mss->state_delta.size(), std::memory_order_relaxed);
+
+    // GPU state is written on the GPU thread, so the delta has to be created there too.
+    GPUThread::RunOnThread([&mss, prev_mss]() {
+      if (prev_mss->gpu_state_data.empty())
+        return;
+
+      EncodeMemoryStateDelta(prev_mss->gpu_state_data, prev_mss->gpu_state_size, prev_mss->gpu_state_delta,
+                             mss.gpu_state_data.cspan(0, mss.gpu_state_size));
+      s_state.memory_save_state_delta_size.fetch_add(prev_mss->gpu_state_delta.size(), std::memory_order_relaxed);
+    });
+  }
+
 #ifdef PROFILE_MEMORY_SAVE_STATES
   DEV_LOG("Saving frame {} to memory state slot {} took {} bytes and {:.4f} ms", s_state.frame_number,
           &mss - s_state.memory_save_states.data(), mss.state_size, save_timer.GetTimeMilliseconds());
@@ -2768,6 +2882,108 @@ void System::SaveMemoryState(MemorySaveState& mss)
 #endif
 }
 
+void System::EncodeMemoryStateDelta(DynamicHeapArray<u8>& data, size_t size, DynamicHeapArray<u8>& delta,
+                                    std::span<const u8> ref)
+{
+  // Delta is a sequence of [u32 unchanged bytes][u32 changed bytes][changed bytes XOR ref]. Bytes past the end of the
+  // reference state are compared against zero. Short unchanged runs are folded into the changed run, since the
+  // header costs more than the bytes it would skip.
+  static constexpr size_t MIN_UNCHANGED_RUN = 16;
+
+  const u8* const src = data.data();
+  const u8* const ref_data = ref.data();
+  const size_t common_size = std::min(size, ref.size());
+  const auto ref_byte = [ref_data, common_size](size_t pos) { return (pos < common_size) ? ref_data[pos] : u8(0); };
+
+  // Returns the position of the first byte that differs from the reference, starting at pos.
+  const auto find_changed = [src, ref_data, common_size, size, &ref_byte](size_t pos) {
+    for (; (pos + sizeof(u64)) <= common_size; pos += sizeof(u64))
+    {
+      u64 a, b;
+      std::memcpy(&a, src + pos, sizeof(a));
+      std::memcpy(&b, ref_data + pos, sizeof(b));
+      if (a != b)
+        return pos + (CountTrailingZeros(a ^ b) / 8);
+    }
+    while (pos < size && src[pos] == ref_byte(pos))
+      pos++;
+    return pos;
+  };
+
+  // Worst case is every byte changed, with one header per minimum unchanged run.
+  DynamicHeapArray<u8> out(size + ((size / MIN_UNCHANGED_RUN) + 1) * (sizeof(u32) * 2));
+  u8* out_ptr = out.data();
+
+  size_t pos = 0;
+  while (pos < size)
+  {
+    const size_t changed_start = find_changed(pos);
+    if (changed_start == size)
+      break;
+
+    // Extend the changed run until we hit a long enough unchanged run.
+    size_t changed_end = changed_start;
+    for (;;)
+    {
+      while (changed_end < size && src[changed_end] != ref_byte(changed_end))
+        changed_end++;
+
+      const size_t next_changed = find_changed(changed_end);
+      if (next_changed == size || (next_changed - changed_end) >= MIN_UNCHANGED_RUN)
+        break;
+
+      changed_end = next_changed;
+    }
+
+    const u32 unchanged_count = static_cast<u32>(changed_start - pos);
+    const u32 changed_count = static_cast<u32>(changed_end - changed_start);
+    std::memcpy(out_ptr, &unchanged_count, sizeof(unchanged_count));
+    std::memcpy(out_ptr + sizeof(u32), &changed_count, sizeof(changed_count));
+    out_ptr += sizeof(u32) * 2;
+    for (size_t i = changed_start; i < changed_end; i++)
+      *(out_ptr++) = src[i] ^ ref_byte(i);
+
+    pos = changed_end;
+  }
+
+  delta.assign(out.data(), static_cast<size_t>(out_ptr - out.data()));
+  data.deallocate();
+}
+
+void System::DecodeMemoryStateDelta(DynamicHeapArray<u8>& data, size_t size, size_t capacity,
+                                    DynamicHeapArray<u8>& delta, std::span<const u8> ref)
+{
+  DebugAssert(size <= capacity);
+  data.resize(capacity);
+
+  u8* const dst = data.data();
+  const size_t common_size = std::min(size, ref.size());
+  std::memcpy(dst, ref.data(), common_size);
+  if (size > common_size)
+    std::memset(dst + common_size, 0, size - common_size);
+
+  const u8* in_ptr = delta.data();
+  const u8* const in_end = in_ptr + delta.size();
+  size_t pos = 0;
+  while (in_ptr < in_end)
+  {
+    u32 unchanged_count, changed_count;
+    std::memcpy(&unchanged_count, in_ptr, sizeof(unchanged_count));
+    std::memcpy(&changed_count, in_ptr + sizeof(u32), sizeof(changed_count));
+    in_ptr += sizeof(u32) * 2;
+
+    pos += unchanged_count;
+    DebugAssert((pos + changed_count) <= size);
+    for (u32 i = 0; i < changed_count; i++)
+      dst[pos + i] ^= in_ptr[i];
+
+    in_ptr += changed_count;
+    pos += changed_count;
+  }
+
+  delta.deallocate();
+}
+
 void System::DoMemoryState(StateWrapper& sw, MemorySaveState& mss, bool update_display)
 {
 #if defined(_DEBUG) || defined(_DEVEL)
@@ -3060,6 +3276,7 @@ bool System::LoadStateDataFromBuffer(std::span<const u8> data, u32 version, Erro
     return false;
   }
 
+  CPU::CodeCache::PrecompileCachedBlocks();
   InterruptExecution();
 
   PerformanceCounters::Reset();
@@ -3240,7 +3457,13 @@ bool System::SaveState(std::string path, Error* error, bool backup_existing_save
 
   Timer save_timer;
 
+  // Reuse the buffer from the last save if it has been written, saves page faulting in a new one.
   SaveStateBuffer buffer;
+  {
+    std::unique_lock lock(s_state.save_state_queue_mutex);
+    buffer.state_data = std::move(s_state.save_state_spare_buffer);
+  }
+
   if (!SaveStateToBuffer(&buffer, error, 256))
     return false;
 
@@ -3250,65 +3473,96 @@ bool System::SaveState(std::string path, Error* error, bool backup_existing_save
   Host::AddIconOSDMessage(osd_key, ICON_EMOJI_FLOPPY_DISK,
                           fmt::format(TRANSLATE_FS("System", "Saving state to '{}'."), Path::GetFileName(path)), 60.0f);
 
-  // ensure multiple saves to the same path do not overlap
-  FlushSaveStates();
-
+  // Saves are queued rather than submitted as independent tasks, so that multiple saves to the same path are written
+  // in order, without having to block the CPU thread waiting for the previous save to finish.
   s_state.outstanding_save_state_tasks.fetch_add(1, std::memory_order_acq_rel);
-  s_state.async_task_queue.SubmitTask([path = std::move(path), buffer = std::move(buffer), osd_key = std::move(osd_key),
-                                       backup_existing_save, compression = g_settings.save_state_compression]() {
-    INFO_LOG("Saving state to '{}'...", path);
 
-    Error lerror;
-    Timer lsave_timer;
+  std::unique_lock lock(s_state.save_state_queue_mutex);
+  s_state.save_state_queue.push_back(PendingSaveState{.path = std::move(path),
+                                                      .osd_key = std::move(osd_key),
+                                                      .buffer = std::move(buffer),
+                                                      .compression = g_settings.save_state_compression,
+                                                      .backup_existing_save = backup_existing_save});
+  if (!s_state.save_state_queue_active)
+  {
+    s_state.save_state_queue_active = true;
+    s_state.async_task_queue.SubmitTask(&System::ProcessSaveStateQueue);
+  }
 
-    if (backup_existing_save && FileSystem::FileExists(path.c_str()))
-    {
-      const std::string backup_filename = Path::ReplaceExtension(path, "bak");
-      if (!FileSystem::RenamePath(path.c_str(), backup_filename.c_str(), &lerror))
-      {
-        ERROR_LOG("Failed to rename save state backup '{}': {}", Path::GetFileName(backup_filename),
-                  lerror.GetDescription());
-      }
-    }
+  return true;
+}
 
-    auto fp = FileSystem::CreateAtomicRenamedFile(path, &lerror);
-    bool result = false;
-    if (fp)
-    {
-      if (SaveStateBufferToFile(buffer, fp.get(), &lerror, compression))
-        result = FileSystem::CommitAtomicRenamedFile(fp, &lerror);
-      else
-        FileSystem::DiscardAtomicRenamedFile(fp);
-    }
-    else
-    {
-      lerror.AddPrefixFmt("Cannot open '{}': ", Path::GetFileName(path));
-    }
+void System::ProcessSaveStateQueue()
+{
+  std::unique_lock lock(s_state.save_state_queue_mutex);
+  while (!s_state.save_state_queue.empty())
+  {
+    PendingSaveState pss = std::move(s_state.save_state_queue.front());
+    s_state.save_state_queue.pop_front();
+    lock.unlock();
+
+    WritePendingSaveState(pss);
 
-    VERBOSE_LOG("Saving state took {:.2f} msec", lsave_timer.GetTimeMilliseconds());
+    lock.lock();
+    if (s_state.save_state_spare_buffer.empty())
+      s_state.save_state_spare_buffer = std::move(pss.buffer.state_data);
+  }
 
-    s_state.outstanding_save_state_tasks.fetch_sub(1, std::memory_order_acq_rel);
+  s_state.save_state_queue_active = false;
+}
 
-    // don't display a resume state saved message in FSUI
-    if (!IsValid())
-      return;
+void System::WritePendingSaveState(PendingSaveState& pss)
+{
+  INFO_LOG("Saving state to '{}'...", pss.path);
 
-    if (result)
+  Error error;
+  Timer save_timer;
+
+  if (pss.backup_existing_save && FileSystem::FileExists(pss.path.c_str()))
+  {
+    const std::string backup_filename = Path::ReplaceExtension(pss.path, "bak");
+    if (!FileSystem::RenamePath(pss.path.c_str(), backup_filename.c_str(), &error))
     {
-      Host::AddIconOSDMessage(std::move(osd_key), ICON_EMOJI_FLOPPY_DISK,
-                              fmt::format(TRANSLATE_FS("System", "State saved to '{}'."), Path::GetFileName(path)),
-                              Host::OSD_QUICK_DURATION);
+      ERROR_LOG("Failed to rename save state backup '{}': {}", Path::GetFileName(backup_filename),
+                error.GetDescription());
     }
+  }
+
+  auto fp = FileSystem::CreateAtomicRenamedFile(pss.path, &error);
+  bool result = false;
+  if (fp)
+  {
+    if (SaveStateBufferToFile(pss.buffer, fp.get(), &error, pss.compression))
+      result = FileSystem::CommitAtomicRenamedFile(fp, &error);
     else
-    {
-      Host::AddIconOSDMessage(std::move(osd_key), ICON_EMOJI_WARNING,
-                              fmt::format(TRANSLATE_FS("System", "Failed to save state to '{0}':\n{1}"),
-                                          Path::GetFileName(path), lerror.GetDescription()),
-                              Host::OSD_ERROR_DURATION);
-    }
-  });
+      FileSystem::DiscardAtomicRenamedFile(fp);
+  }
+  else
+  {
+    error.AddPrefixFmt("Cannot open '{}': ", Path::GetFileName(pss.path));
+  }
 
-  return true;
+  VERBOSE_LOG("Saving state took {:.2f} msec", save_timer.GetTimeMilliseconds());
+
+  s_state.outstanding_save_state_tasks.fetch_sub(1, std::memory_order_acq_rel);
+
+  // don't display a resume state saved message in FSUI
+  if (!IsValid())
+    return;
+
+  if (result)
+  {
+    Host::AddIconOSDMessage(std::move(pss.osd_key), ICON_EMOJI_FLOPPY_DISK,
+                            fmt::format(TRANSLATE_FS("System", "State saved to '{}'."), Path::GetFileName(pss.path)),
+                            Host::OSD_QUICK_DURATION);
+  }
+  else
+  {
+    Host::AddIconOSDMessage(std::move(pss.osd_key), ICON_EMOJI_WARNING,
+                            fmt::format(TRANSLATE_FS("System", "Failed to save state to '{0}':\n{1}"),
+                                        Path::GetFileName(pss.path), error.GetDescription()),
+                            Host::OSD_ERROR_DURATION);
+  }
 }
 
 void System::FlushSaveStates()
@@ -3364,8 +3618,9 @@ bool System::SaveStateToBuffer(SaveStateBuffer* buffer, Error* error, u32 screen
   }
 
   // write data
-  if (buffer->state_data.empty())
-    buffer->state_data.resize(GetMaxSaveStateSize());
+  const size_t max_state_size = GetMaxSaveStateSize();
+  if (buffer->state_data.size() != max_state_size)
+    buffer->state_data.resize(max_state_size);
 
   return SaveStateDataToBuffer(buffer->state_data, &buffer->state_size, error);
 }
@@ -3396,8 +3651,8 @@ bool System::SaveStateBufferToFile(const SaveStateBuffer& buffer, std::FILE* fp,
   SAVE_STATE_HEADER header = {};
   header.magic = SAVE_STATE_MAGIC;
   header.version = SAVE_STATE_VERSION;
-  StringUtil::Strlcpy(header.title, s_state.running_game_title.c_str(), sizeof(header.title));
-  StringUtil::Strlcpy(header.serial, s_state.running_game_serial.c_str(), sizeof(header.serial));
+  StringUtil::Strlcpy(header.title, buffer.title.c_str(), sizeof(header.title));
+  StringUtil::Strlcpy(header.serial, buffer.serial.c_str(), sizeof(header.serial));
 
   u32 file_position = 0;
   DebugAssert(FileSystem::FTell64(fp) == static_cast<s64>(file_position));
@@ -3508,7 +3763,7 @@ u32 System::CompressAndWriteStateData(std::FILE* fp, std::span<const u8> src, Sa
   }
 
   const CompressHelpers::OptionalByteBuffer compressed_data =
-    CompressHelpers::CompressToBuffer(ctype, src, clevel, error);
+    CompressHelpers::CompressToBufferMT(ctype, src, clevel, CompressHelpers::DEFAULT_CHUNK_SIZE, error);
   if (!compressed_data.has_value())
     return 0;
 
@@ -4418,6 +4673,7 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
         (g_settings.cpu_recompiler_memory_exceptions != old_settings.cpu_recompiler_memory_exceptions ||
          g_settings.cpu_recompiler_block_linking != old_settings.cpu_recompiler_block_linking ||
          g_settings.cpu_recompiler_icache != old_settings.cpu_recompiler_icache ||
+         g_settings.cpu_recompiler_superblocks != old_settings.cpu_recompiler_superblocks ||
          g_settings.bios_tty_logging != old_settings.bios_tty_logging))
     {
       Host::AddIconOSDMessage("CPUFlushAllBlocks", ICON_FA_MICROCHIP,
@@ -4469,6 +4725,7 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
              g_settings.gpu_multisamples != old_settings.gpu_multisamples ||
              g_settings.gpu_per_sample_shading != old_settings.gpu_per_sample_shading ||
              g_settings.gpu_max_queued_frames != old_settings.gpu_max_queued_frames ||
+             g_settings.gpu_sw_threads != old_settings.gpu_sw_threads ||
              g_settings.gpu_use_software_renderer_for_readbacks !=
                old_settings.gpu_use_software_renderer_for_readbacks ||
              g_settings.gpu_scaled_interlacing != old_settings.gpu_scaled_interlacing ||
@@ -4591,6 +4848,9 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     if (g_settings.cdrom_readahead_sectors != old_settings.cdrom_readahead_sectors)
       CDROM::SetReadaheadSectors(g_settings.cdrom_readahead_sectors);
 
+    if (g_settings.mdec_use_worker_thread != old_settings.mdec_use_worker_thread)
+      MDEC::SetUseWorkerThread(g_settings.mdec_use_worker_thread);
+
     bool controllers_updated = false;
     for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
     {
@@ -4616,6 +4876,7 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     if (g_settings.rewind_enable != old_settings.rewind_enable ||
         g_settings.rewind_save_frequency != old_settings.rewind_save_frequency ||
         g_settings.rewind_save_slots != old_settings.rewind_save_slots ||
+        g_settings.rewind_compression != old_settings.rewind_compression ||
         g_settings.runahead_frames != old_settings.runahead_frames)
     {
       UpdateMemorySaveStateSettings();
@@ -4944,10 +5205,27 @@ void System::LogUnsafeSettingsToConsole(const SmallStringBase& messages)
   WARNING_LOG(console_messages);
 }
 
-void System::CalculateRewindMemoryUsage(u32 num_saves, u32 resolution_scale, u64* ram_usage, u64* vram_usage)
+void System::CalculateRewindMemoryUsage(u32 num_saves, u32 resolution_scale, bool compressed, u64* ram_usage,
+                                        u64* vram_usage)
 {
   const u64 real_resolution_scale = std::max<u64>(g_settings.gpu_resolution_scale, 1u);
-  *ram_usage = GetMaxMemorySaveStateSize() * static_cast<u64>(num_saves);
+  if (compressed && num_saves > 1)
+  {
+    // Only the newest state is stored in full. Use the real delta sizes if we're currently rewinding with compression,
+    // otherwise assume most of RAM is unchanged between saves.
+    static constexpr u64 ESTIMATED_DELTA_RATIO = 16;
+    const u64 full_size = GetMaxMemorySaveStateSize();
+    const u64 delta_size =
+      (s_state.memory_save_state_compression && s_state.memory_save_state_count > 1) ?
+        (s_state.memory_save_state_delta_size.load(std::memory_order_relaxed) / (s_state.memory_save_state_count - 1)) :
+        (full_size / ESTIMATED_DELTA_RATIO);
+    *ram_usage = full_size + delta_size * static_cast<u64>(num_saves - 1);
+  }
+  else
+  {
+    *ram_usage = GetMaxMemorySaveStateSize() * static_cast<u64>(num_saves);
+  }
+
   *vram_usage = ((VRAM_WIDTH * real_resolution_scale) * (VRAM_HEIGHT * real_resolution_scale) * 4) *
                 static_cast<u64>(g_settings.gpu_multisamples) * static_cast<u64>(num_saves);
 }
@@ -4956,6 +5234,7 @@ void System::UpdateMemorySaveStateSettings()
 {
   const bool any_memory_states_active = (g_settings.IsRunaheadEnabled() || g_settings.rewind_enable);
   FreeMemoryStateStorage(true, true, any_memory_states_active);
+  s_state.memory_save_state_compression = false;
 
   if (IsReplayingGPUDump()) [[unlikely]]
   {
@@ -4972,11 +5251,14 @@ void System::UpdateMemorySaveStateSettings()
     s_state.rewind_save_counter = 0;
     num_slots = g_settings.rewind_save_slots;
 
+    s_state.memory_save_state_compression = g_settings.rewind_compression;
+
     u64 ram_usage, vram_usage;
-    CalculateRewindMemoryUsage(g_settings.rewind_save_slots, g_settings.gpu_resolution_scale, &ram_usage, &vram_usage);
-    INFO_LOG("Rewind is enabled, saving every {} frames, with {} slots and {}MB RAM and {}MB VRAM usage",
-             std::max(s_state.rewind_save_frequency, 1), g_settings.rewind_save_slots, ram_usage / 1048576,
-             vram_usage / 1048576);
+    CalculateRewindMemoryUsage(g_settings.rewind_save_slots, g_settings.gpu_resolution_scale,
+                               g_settings.rewind_compression, &ram_usage, &vram_usage);
+    INFO_LOG("Rewind is enabled, saving every {} frames, with {} {}slots and {}MB RAM and {}MB VRAM usage",
+             std::max(s_state.rewind_save_frequency, 1), g_settings.rewind_save_slots,
+             g_settings.rewind_compression ? "compressed " : "", ram_usage / 1048576, vram_usage / 1048576);
   }
   else
   {
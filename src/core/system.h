@@ -178,6 +178,9 @@ bool IsExecuting();
 bool IsReplayingGPUDump();
 size_t GetGPUDumpFrameCount();
 
+/// Moves GPU dump playback to the start of the specified frame.
+bool SeekGPUDump(size_t frame, Error* error);
+
 bool IsStartupCancelled();
 void CancelPendingStartup();
 void InterruptExecution();
@@ -435,7 +438,8 @@ std::string GetImageForLoadingScreen(const std::string& game_path);
 //////////////////////////////////////////////////////////////////////////
 // Memory Save States (Rewind and Runahead)
 //////////////////////////////////////////////////////////////////////////
-void CalculateRewindMemoryUsage(u32 num_saves, u32 resolution_scale, u64* ram_usage, u64* vram_usage);
+void CalculateRewindMemoryUsage(u32 num_saves, u32 resolution_scale, bool compressed, u64* ram_usage,
+                                u64* vram_usage);
 void ClearMemorySaveStates(bool reallocate_resources, bool recycle_textures);
 void SetRunaheadReplayFlag(bool is_analog_input);
 
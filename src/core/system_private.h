@@ -21,6 +21,12 @@ struct MemorySaveState
   std::unique_ptr<GPUTexture> vram_texture;
   DynamicHeapArray<u8> gpu_state_data;
   size_t gpu_state_size;
+  size_t gpu_state_capacity;
+
+  // When rewind compression is enabled, only the newest state is kept in full. Older states are stored as deltas
+  // against the next newer state, and the raw buffers are released.
+  DynamicHeapArray<u8> state_delta;
+  DynamicHeapArray<u8> gpu_state_delta;
 };
 
 MemorySaveState& AllocateMemoryState();
@@ -31,6 +37,14 @@ void FreeMemoryStateStorage(bool release_memory, bool release_textures, bool rec
 void LoadMemoryState(MemorySaveState& mss, bool update_display);
 void SaveMemoryState(MemorySaveState& mss);
 
+/// Replaces the first size bytes of data with a delta against ref, and releases data.
+void EncodeMemoryStateDelta(DynamicHeapArray<u8>& data, size_t size, DynamicHeapArray<u8>& delta,
+                            std::span<const u8> ref);
+
+/// Reconstructs data from a delta created by EncodeMemoryStateDelta(), and releases the delta.
+void DecodeMemoryStateDelta(DynamicHeapArray<u8>& data, size_t size, size_t capacity, DynamicHeapArray<u8>& delta,
+                            std::span<const u8> ref);
+
 bool IsRunaheadActive();
 void IncrementFrameNumber();
 void IncrementInternalFrameNumber();
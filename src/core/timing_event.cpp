@@ -13,29 +13,42 @@
 #include "common/small_string.h"
 #include "common/thirdparty/SmallVector.h"
 
+#include <algorithm>
+
 LOG_CHANNEL(TimingEvents);
 
 namespace TimingEvents {
 
 static GlobalTicks GetTimestampForNewEvent();
 
-static void SortEvent(TimingEvent* event);
+static bool EventRunsBefore(const TimingEvent* lhs, const TimingEvent* rhs);
+static void SetHeapEvent(u32 index, TimingEvent* event);
+static bool SiftEventUp(TimingEvent* event);
+static void SiftEventDown(TimingEvent* event);
+static void SortEvent(TimingEvent* event, GlobalTicks new_run_time);
 static void AddActiveEvent(TimingEvent* event);
 static void RemoveActiveEvent(TimingEvent* event);
-static void SortEvents();
+static void GetActiveEventsInRunOrder(llvm::SmallVector<TimingEvent*, 32>* events);
+static void SortEvents(const llvm::SmallVector<TimingEvent*, 32>& previous_order);
 static TimingEvent* FindActiveEvent(const std::string_view name);
 static void CommitGlobalTicks(const GlobalTicks new_global_ticks);
 
+// Schedule orders count down from here for events that go ahead of others with the same run time, and up for events
+// that go behind them.
+static constexpr u64 SCHEDULE_ORDER_MIDPOINT = UINT64_C(1) << 63;
+
 namespace {
 struct TimingEventsState
 {
-  TimingEvent* active_events_head = nullptr;
-  TimingEvent* active_events_tail = nullptr;
+  // Binary min-heap ordered by next run time then schedule order, the head is always the next event to run.
+  llvm::SmallVector<TimingEvent*, 32> active_events;
   TimingEvent* current_event = nullptr;
-  u32 active_event_count = 0;
   GlobalTicks current_event_next_run_time = 0;
   GlobalTicks global_tick_counter = 0;
   GlobalTicks event_run_tick_counter = 0;
+  u64 next_ahead_schedule_order = SCHEDULE_ORDER_MIDPOINT - 1;
+  u64 next_behind_schedule_order = SCHEDULE_ORDER_MIDPOINT;
+  u64 reschedule_count = 0;
 };
 } // namespace
 
@@ -60,6 +73,11 @@ GlobalTicks TimingEvents::GetEventRunTickCounter()
   return s_state.event_run_tick_counter;
 }
 
+u64 TimingEvents::GetRescheduleCount()
+{
+  return s_state.reschedule_count;
+}
+
 void TimingEvents::Initialize()
 {
   Reset();
@@ -73,20 +91,20 @@ void TimingEvents::Reset()
 
 void TimingEvents::Shutdown()
 {
-  Assert(s_state.active_event_count == 0);
+  Assert(s_state.active_events.empty());
 }
 
 void TimingEvents::UpdateCPUDowncount()
 {
-  DebugAssert(s_state.active_events_head->m_next_run_time >= s_state.global_tick_counter);
-  const u32 event_downcount =
-    static_cast<u32>(s_state.active_events_head->m_next_run_time - s_state.global_tick_counter);
+  const TimingEvent* head = s_state.active_events.front();
+  DebugAssert(head->m_next_run_time >= s_state.global_tick_counter);
+  const u32 event_downcount = static_cast<u32>(head->m_next_run_time - s_state.global_tick_counter);
   CPU::g_state.downcount = CPU::HasPendingInterrupt() ? 0 : event_downcount;
 }
 
 TimingEvent** TimingEvents::GetHeadEventPtr()
 {
-  return &s_state.active_events_head;
+  return s_state.active_events.data();
 }
 
 void TimingEvents::SetGlobalTickCounter(GlobalTicks ticks)
@@ -94,209 +112,143 @@ void TimingEvents::SetGlobalTickCounter(GlobalTicks ticks)
   s_state.global_tick_counter = ticks;
 }
 
-void TimingEvents::SortEvent(TimingEvent* event)
+ALWAYS_INLINE bool TimingEvents::EventRunsBefore(const TimingEvent* lhs, const TimingEvent* rhs)
 {
-  const GlobalTicks event_runtime = event->m_next_run_time;
+  return (lhs->m_next_run_time < rhs->m_next_run_time ||
+          (lhs->m_next_run_time == rhs->m_next_run_time && lhs->m_schedule_order < rhs->m_schedule_order));
+}
 
-  if (event->prev && event->prev->m_next_run_time > event_runtime)
+void TimingEvents::SetHeapEvent(u32 index, TimingEvent* event)
+{
+  s_state.active_events[index] = event;
+  event->m_heap_index = index;
+}
+
+bool TimingEvents::SiftEventUp(TimingEvent* event)
+{
+  u32 index = event->m_heap_index;
+  const u32 start_index = index;
+  while (index > 0)
   {
-    // move backwards
-    TimingEvent* current = event->prev;
-    while (current && current->m_next_run_time > event_runtime)
-      current = current->prev;
-
-    // unlink
-    if (event->prev)
-      event->prev->next = event->next;
-    else
-      s_state.active_events_head = event->next;
-    if (event->next)
-      event->next->prev = event->prev;
-    else
-      s_state.active_events_tail = event->prev;
+    const u32 parent_index = (index - 1) / 2;
+    TimingEvent* parent = s_state.active_events[parent_index];
+    if (!EventRunsBefore(event, parent))
+      break;
 
-    // insert after current
-    if (current)
-    {
-      event->next = current->next;
-      if (current->next)
-        current->next->prev = event;
-      else
-        s_state.active_events_tail = event;
-
-      event->prev = current;
-      current->next = event;
-    }
-    else
-    {
-      // insert at front
-      DebugAssert(s_state.active_events_head);
-      s_state.active_events_head->prev = event;
-      event->prev = nullptr;
-      event->next = s_state.active_events_head;
-      s_state.active_events_head = event;
-      UpdateCPUDowncount();
-    }
+    SetHeapEvent(index, parent);
+    index = parent_index;
   }
-  else if (event->next && event_runtime > event->next->m_next_run_time)
+
+  SetHeapEvent(index, event);
+  return (index != start_index);
+}
+
+void TimingEvents::SiftEventDown(TimingEvent* event)
+{
+  const u32 count = static_cast<u32>(s_state.active_events.size());
+  u32 index = event->m_heap_index;
+  for (;;)
   {
-    // move forwards
-    TimingEvent* current = event->next;
-    while (current && event_runtime > current->m_next_run_time)
-      current = current->next;
+    const u32 left_index = index * 2 + 1;
+    if (left_index >= count)
+      break;
+
+    const u32 right_index = left_index + 1;
+    const u32 child_index =
+      (right_index < count && EventRunsBefore(s_state.active_events[right_index], s_state.active_events[left_index])) ?
+        right_index :
+        left_index;
+    TimingEvent* child = s_state.active_events[child_index];
+    if (!EventRunsBefore(child, event))
+      break;
+
+    SetHeapEvent(index, child);
+    index = child_index;
+  }
 
-    // unlink
-    if (event->prev)
-    {
-      event->prev->next = event->next;
-    }
-    else
-    {
-      s_state.active_events_head = event->next;
-      if (!s_state.current_event)
-        UpdateCPUDowncount();
-    }
-    if (event->next)
-      event->next->prev = event->prev;
-    else
-      s_state.active_events_tail = event->prev;
+  SetHeapEvent(index, event);
+}
 
-    // insert before current
-    if (current)
-    {
-      event->next = current;
-      event->prev = current->prev;
+void TimingEvents::SortEvent(TimingEvent* event, GlobalTicks new_run_time)
+{
+  // Ties resolve the same way the sorted event list did: an event moving later goes ahead of the events already
+  // waiting for its new time, one moving earlier goes behind them, and one which doesn't move keeps its place.
+  if (new_run_time > event->m_next_run_time)
+    event->m_schedule_order = s_state.next_ahead_schedule_order--;
+  else if (new_run_time < event->m_next_run_time)
+    event->m_schedule_order = s_state.next_behind_schedule_order++;
+  event->m_next_run_time = new_run_time;
+  s_state.reschedule_count++;
 
-      if (current->prev)
-      {
-        current->prev->next = event;
-      }
-      else
-      {
-        s_state.active_events_head = event;
-        if (!s_state.current_event)
-          UpdateCPUDowncount();
-      }
+  TimingEvent* const old_head = s_state.active_events.front();
+  if (!SiftEventUp(event))
+    SiftEventDown(event);
 
-      current->prev = event;
-    }
-    else
-    {
-      // insert at back
-      DebugAssert(s_state.active_events_tail);
-      s_state.active_events_tail->next = event;
-      event->next = nullptr;
-      event->prev = s_state.active_events_tail;
-      s_state.active_events_tail = event;
-    }
-  }
+  // Moving to the front always needs the downcount updated, moving away from it is handled after the event runs.
+  TimingEvent* const new_head = s_state.active_events.front();
+  if (new_head != old_head && (new_head == event || !s_state.current_event))
+    UpdateCPUDowncount();
 }
 
 void TimingEvents::AddActiveEvent(TimingEvent* event)
 {
-  DebugAssert(!event->prev && !event->next);
-  s_state.active_event_count++;
+  // New events go ahead of any already waiting for the same time.
+  event->m_schedule_order = s_state.next_ahead_schedule_order--;
+  s_state.reschedule_count++;
 
-  const GlobalTicks event_runtime = event->m_next_run_time;
-  TimingEvent* current = nullptr;
-  TimingEvent* next = s_state.active_events_head;
-  while (next && event_runtime > next->m_next_run_time)
-  {
-    current = next;
-    next = next->next;
-  }
+  const u32 index = static_cast<u32>(s_state.active_events.size());
+  s_state.active_events.push_back(event);
+  event->m_heap_index = index;
+  SiftEventUp(event);
 
-  if (!next)
-  {
-    // new tail
-    event->prev = s_state.active_events_tail;
-    if (s_state.active_events_tail)
-    {
-      s_state.active_events_tail->next = event;
-      s_state.active_events_tail = event;
-    }
-    else
-    {
-      // first event
-      s_state.active_events_tail = event;
-      s_state.active_events_head = event;
-      UpdateCPUDowncount();
-    }
-  }
-  else if (!current)
-  {
-    // new head
-    event->next = s_state.active_events_head;
-    s_state.active_events_head->prev = event;
-    s_state.active_events_head = event;
+  if (s_state.active_events.front() == event)
     UpdateCPUDowncount();
-  }
-  else
-  {
-    // inbetween current < event > next
-    event->prev = current;
-    event->next = next;
-    current->next = event;
-    next->prev = event;
-  }
 }
 
 void TimingEvents::RemoveActiveEvent(TimingEvent* event)
 {
-  DebugAssert(s_state.active_event_count > 0);
+  DebugAssert(!s_state.active_events.empty() && s_state.active_events[event->m_heap_index] == event);
 
-  if (event->next)
+  // Fill the hole with the last event, and move it into place.
+  const u32 index = event->m_heap_index;
+  TimingEvent* const last = s_state.active_events.back();
+  s_state.active_events.pop_back();
+  if (last != event)
   {
-    event->next->prev = event->prev;
-  }
-  else
-  {
-    s_state.active_events_tail = event->prev;
+    last->m_heap_index = index;
+    if (!SiftEventUp(last))
+      SiftEventDown(last);
   }
 
-  if (event->prev)
-  {
-    event->prev->next = event->next;
-  }
-  else
-  {
-    s_state.active_events_head = event->next;
-    if (s_state.active_events_head && !s_state.current_event)
-      UpdateCPUDowncount();
-  }
+  event->m_heap_index = 0;
 
-  event->prev = nullptr;
-  event->next = nullptr;
-
-  s_state.active_event_count--;
+  if (index == 0 && !s_state.active_events.empty() && !s_state.current_event)
+    UpdateCPUDowncount();
 }
 
-void TimingEvents::SortEvents()
+void TimingEvents::GetActiveEventsInRunOrder(llvm::SmallVector<TimingEvent*, 32>* events)
 {
-  llvm::SmallVector<TimingEvent*, 16> events;
-  events.reserve(s_state.active_event_count);
-
-  TimingEvent* next = s_state.active_events_head;
-  while (next)
-  {
-    TimingEvent* current = next;
-    events.push_back(current);
-    next = current->next;
-    current->prev = nullptr;
-    current->next = nullptr;
-  }
+  events->assign(s_state.active_events.begin(), s_state.active_events.end());
+  std::sort(events->begin(), events->end(), &EventRunsBefore);
+}
 
-  s_state.active_events_head = nullptr;
-  s_state.active_events_tail = nullptr;
-  s_state.active_event_count = 0;
+void TimingEvents::SortEvents(const llvm::SmallVector<TimingEvent*, 32>& previous_order)
+{
+  // Run times have probably all changed. Re-add the events in the order they were in before, so ties come out the
+  // same way as adding them one at a time would, then rebuild the heap bottom-up.
+  for (TimingEvent* event : previous_order)
+    event->m_schedule_order = s_state.next_ahead_schedule_order--;
 
-  for (TimingEvent* event : events)
-    AddActiveEvent(event);
+  const u32 count = static_cast<u32>(s_state.active_events.size());
+  for (u32 i = 0; i < count; i++)
+    s_state.active_events[i]->m_heap_index = i;
+  for (u32 i = count / 2; i > 0; i--)
+    SiftEventDown(s_state.active_events[i - 1]);
 }
 
 static TimingEvent* TimingEvents::FindActiveEvent(const std::string_view name)
 {
-  for (TimingEvent* event = s_state.active_events_head; event; event = event->next)
+  for (TimingEvent* event : s_state.active_events)
   {
     if (event->GetName() == name)
       return event;
@@ -318,10 +270,7 @@ void TimingEvents::CancelRunningEvent()
 
   // Might need to sort it, since we're bailing out.
   if (event->IsActive())
-  {
-    event->m_next_run_time = s_state.current_event_next_run_time;
-    SortEvent(event);
-  }
+    SortEvent(event, s_state.current_event_next_run_time);
 
   s_state.current_event = nullptr;
 }
@@ -332,7 +281,7 @@ ALWAYS_INLINE_RELEASE void TimingEvents::CommitGlobalTicks(const GlobalTicks new
 
   do
   {
-    TimingEvent* event = s_state.active_events_head;
+    TimingEvent* event = s_state.active_events.front();
     s_state.global_tick_counter = std::min(new_global_ticks, event->m_next_run_time);
 
     // Now we can actually run the callbacks.
@@ -353,12 +302,9 @@ ALWAYS_INLINE_RELEASE void TimingEvents::CommitGlobalTicks(const GlobalTicks new
       // The cycles_late is only an indicator, it doesn't modify the cycles to execute.
       event->m_callback(event->m_callback_param, ticks_to_execute, ticks_late);
       if (event->m_active)
-      {
-        event->m_next_run_time = s_state.current_event_next_run_time;
-        SortEvent(event);
-      }
+        SortEvent(event, s_state.current_event_next_run_time);
 
-      event = s_state.active_events_head;
+      event = s_state.active_events.front();
     }
   } while (new_global_ticks > s_state.global_tick_counter);
   s_state.current_event = nullptr;
@@ -373,7 +319,7 @@ void TimingEvents::RunEvents()
   {
     const GlobalTicks new_global_ticks =
       s_state.event_run_tick_counter + static_cast<GlobalTicks>(CPU::GetPendingTicks());
-    if (new_global_ticks >= s_state.active_events_head->m_next_run_time)
+    if (new_global_ticks >= s_state.active_events.front()->m_next_run_time)
     {
       CPU::ResetPendingTicks();
       CommitGlobalTicks(new_global_ticks);
@@ -415,6 +361,9 @@ bool TimingEvents::DoState(StateWrapper& sw)
     u32 event_count = 0;
     sw.Do(&event_count);
 
+    llvm::SmallVector<TimingEvent*, 32> previous_order;
+    GetActiveEventsInRunOrder(&previous_order);
+
     for (u32 i = 0; i < event_count; i++)
     {
       TinyString event_name;
@@ -454,7 +403,7 @@ bool TimingEvents::DoState(StateWrapper& sw)
       static_cast<TickCount>(s_state.event_run_tick_counter - s_state.global_tick_counter);
     DebugAssert(pending_ticks >= 0);
     CPU::AddPendingTicks(pending_ticks);
-    SortEvents();
+    SortEvents(previous_order);
     UpdateCPUDowncount();
   }
   else
@@ -469,6 +418,9 @@ bool TimingEvents::DoState(StateWrapper& sw)
       u32 event_count = 0;
       sw.Do(&event_count);
 
+      llvm::SmallVector<TimingEvent*, 32> previous_order;
+      GetActiveEventsInRunOrder(&previous_order);
+
       for (u32 i = 0; i < event_count; i++)
       {
         TinyString event_name;
@@ -500,14 +452,19 @@ bool TimingEvents::DoState(StateWrapper& sw)
       // Even if we're actually running an event, we don't want to set it to a new counter.
       s_state.current_event = nullptr;
 
-      SortEvents();
+      SortEvents(previous_order);
       UpdateCPUDowncount();
     }
     else
     {
-      sw.Do(&s_state.active_event_count);
+      // Write in dispatch order rather than heap order, so the file matches the old sorted list.
+      llvm::SmallVector<TimingEvent*, 32> events;
+      GetActiveEventsInRunOrder(&events);
+
+      u32 event_count = static_cast<u32>(events.size());
+      sw.Do(&event_count);
 
-      for (TimingEvent* event = s_state.active_events_head; event; event = event->next)
+      for (TimingEvent* event : events)
       {
         sw.Do(&event->m_name);
         GlobalTicks next_run_time =
@@ -518,7 +475,7 @@ bool TimingEvents::DoState(StateWrapper& sw)
         sw.Do(&event->m_interval);
       }
 
-      DEBUG_LOG("Wrote {} events to save state.", s_state.active_event_count);
+      DEBUG_LOG("Wrote {} events to save state.", event_count);
     }
   }
 
@@ -564,9 +521,8 @@ void TimingEvent::Delay(TickCount ticks)
 
   DebugAssert(TimingEvents::s_state.current_event != this);
 
-  m_next_run_time += static_cast<u32>(ticks);
-  SortEvent(this);
-  if (s_state.active_events_head == this)
+  SortEvent(this, m_next_run_time + static_cast<u32>(ticks));
+  if (s_state.active_events.front() == this)
     UpdateCPUDowncount();
 }
 
@@ -595,9 +551,8 @@ void TimingEvent::Schedule(TickCount ticks)
     // If this is a call from an IO handler for example, re-sort the event queue.
     if (s_state.current_event != this)
     {
-      m_next_run_time = next_run_time;
-      SortEvent(this);
-      if (s_state.active_events_head == this)
+      SortEvent(this, next_run_time);
+      if (s_state.active_events.front() == this)
         UpdateCPUDowncount();
     }
   }
@@ -637,12 +592,11 @@ void TimingEvent::InvokeEarly(bool force /* = false */)
   if (!force && ticks_to_execute < m_period)
     return;
 
-  m_next_run_time = ts + static_cast<u32>(m_interval);
   m_last_run_time = ts;
 
   // Since we've changed the downcount, we need to re-sort the events.
-  SortEvent(this);
-  if (s_state.active_events_head == this)
+  SortEvent(this, ts + static_cast<u32>(m_interval));
+  if (s_state.active_events.front() == this)
     UpdateCPUDowncount();
 
   m_callback(m_callback_param, ticks_to_execute, 0);
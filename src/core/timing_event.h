@@ -58,8 +58,11 @@ public:
   void SetInterval(TickCount interval) { m_interval = interval; }
   void SetPeriod(TickCount period) { m_period = period; }
 
-  TimingEvent* prev = nullptr;
-  TimingEvent* next = nullptr;
+  // Position in the active event heap, only valid while active.
+  u32 m_heap_index = 0;
+
+  // Breaks ties between events with the same run time, lower orders run first.
+  u64 m_schedule_order = 0;
 
   TimingEventCallback m_callback;
   void* m_callback_param;
@@ -79,6 +82,9 @@ namespace TimingEvents {
 GlobalTicks GetGlobalTickCounter();
 GlobalTicks GetEventRunTickCounter();
 
+/// Number of times an event has been added to or moved within the queue, for performance counters.
+u64 GetRescheduleCount();
+
 void Initialize();
 void Reset();
 void Shutdown();
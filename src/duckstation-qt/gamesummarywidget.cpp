@@ -469,33 +469,16 @@ void GameSummaryWidget::onComputeHashClicked()
   progress_callback.SetProgressRange(image->GetTrackCount());
   progress_callback.MakeVisible();
 
+  // Calculate hashes
   std::vector<CDImageHasher::Hash> track_hashes;
-  track_hashes.reserve(image->GetTrackCount());
+  const bool calculate_hash_success = CDImageHasher::GetTrackHashes(image.get(), &track_hashes, &progress_callback);
+  if (!calculate_hash_success && progress_callback.IsCancelled())
+    return;
 
-  // Calculate hashes
-  bool calculate_hash_success = true;
-  for (u8 track = 1; track <= image->GetTrackCount(); track++)
+  for (size_t i = 0; i < track_hashes.size(); i++)
   {
-    progress_callback.SetProgressValue(track - 1);
-    progress_callback.PushState();
-
-    CDImageHasher::Hash hash;
-    if (!CDImageHasher::GetTrackHash(image.get(), track, &hash, &progress_callback))
-    {
-      progress_callback.PopState();
-
-      if (progress_callback.IsCancelled())
-        return;
-
-      calculate_hash_success = false;
-      break;
-    }
-    track_hashes.emplace_back(hash);
-
-    QTableWidgetItem* item = m_ui.tracks->item(track - 1, 4);
-    item->setText(QString::fromStdString(CDImageHasher::HashToString(hash)));
-
-    progress_callback.PopState();
+    QTableWidgetItem* item = m_ui.tracks->item(static_cast<int>(i), 4);
+    item->setText(QString::fromStdString(CDImageHasher::HashToString(track_hashes[i])));
   }
 
   // Verify hashes against gamedb
@@ -509,57 +492,10 @@ void GameSummaryWidget::onComputeHashClicked()
     progress_callback.SetStatusText(TRANSLATE("GameSummaryWidget", "Verifying hashes..."));
     progress_callback.SetProgressValue(image->GetTrackCount());
 
-    // Verification strategy used:
-    // 1. First, find all matches for the data track
-    //    If none are found, fail verification for all tracks
-    // 2. For each data track match, try to match all audio tracks
-    //    If all match, assume this revision. Else, try other revisions,
-    //    and accept the one with the most matches.
-    const GameDatabase::TrackHashesMap& hashes_map = GameDatabase::GetTrackHashesMap();
-
-    auto data_track_matches = hashes_map.equal_range(track_hashes[0]);
-    if (data_track_matches.first != data_track_matches.second)
+    if (const GameDatabase::TrackData* match = GameDatabase::MatchTrackHashes(track_hashes, &verification_results))
     {
-      auto best_data_match = data_track_matches.second;
-      for (auto iter = data_track_matches.first; iter != data_track_matches.second; ++iter)
-      {
-        std::vector<bool> current_verification_results(image->GetTrackCount(), false);
-        const auto& data_track_attribs = iter->second;
-        current_verification_results[0] = true; // Data track already matched
-
-        for (auto audio_tracks_iter = std::next(track_hashes.begin()); audio_tracks_iter != track_hashes.end();
-             ++audio_tracks_iter)
-        {
-          auto audio_track_matches = hashes_map.equal_range(*audio_tracks_iter);
-          for (auto audio_iter = audio_track_matches.first; audio_iter != audio_track_matches.second; ++audio_iter)
-          {
-            // If audio track comes from the same revision and code as the data track, "pass" it
-            if (audio_iter->second == data_track_attribs)
-            {
-              current_verification_results[std::distance(track_hashes.begin(), audio_tracks_iter)] = true;
-              break;
-            }
-          }
-        }
-
-        const auto old_matches_count = std::count(verification_results.begin(), verification_results.end(), true);
-        const auto new_matches_count =
-          std::count(current_verification_results.begin(), current_verification_results.end(), true);
-
-        if (new_matches_count > old_matches_count)
-        {
-          best_data_match = iter;
-          verification_results = current_verification_results;
-          // If all elements got matched, early out
-          if (new_matches_count >= static_cast<ptrdiff_t>(verification_results.size()))
-          {
-            break;
-          }
-        }
-      }
-
-      found_revision = best_data_match->second.revision_str;
-      found_serial = best_data_match->second.serial;
+      found_revision = match->revision_str;
+      found_serial = match->serial;
     }
 
     QString text;
@@ -157,6 +157,7 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.gpuThread, "GPU", "UseThread", true);
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.maxQueuedFrames, "GPU", "MaxQueuedFrames",
                                               Settings::DEFAULT_GPU_MAX_QUEUED_FRAMES);
+  SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.softwareRendererThreads, "GPU", "SoftwareRendererThreads", 1);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.scaledInterlacing, "GPU", "ScaledInterlacing", true);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.useSoftwareRendererForReadbacks, "GPU",
                                                "UseSoftwareRendererForReadbacks", false);
@@ -491,6 +492,10 @@ GraphicsSettingsWidget::GraphicsSettingsWidget(SettingsWindow* dialog, QWidget*
   dialog->registerWidgetHelp(m_ui.gpuThread, tr("Threaded Rendering"), tr("Checked"),
                              tr("Uses a second thread for drawing graphics. Provides a significant speed improvement "
                                 "particularly with the software renderer, and is safe to use."));
+  dialog->registerWidgetHelp(
+    m_ui.softwareRendererThreads, tr("Software Renderer Threads"), tr("1"),
+    tr("Splits drawing in the software renderer across multiple threads. Can improve performance in demanding scenes, "
+       "but is experimental. Automatic uses up to half of the available CPU cores."));
   dialog->registerWidgetHelp(m_ui.scaledInterlacing, tr("Scaled Interlacing"), tr("Checked"),
                              tr("Scales line skipping in interlaced rendering to the internal resolution. This makes "
                                 "the combing less obvious at higher resolutions. Usually safe to enable."));
@@ -782,6 +787,8 @@ void GraphicsSettingsWidget::updateRendererDependentOptions()
                                      !m_dialog->hasGameTrait(GameDatabase::Trait::DisableScaledInterlacing));
   m_ui.useSoftwareRendererForReadbacks->setEnabled(
     is_hardware && !m_dialog->hasGameTrait(GameDatabase::Trait::ForceSoftwareRendererForReadbacks));
+  m_ui.softwareRendererThreads->setEnabled(!is_hardware);
+  m_ui.softwareRendererThreadsLabel->setEnabled(!is_hardware);
   m_ui.forceRoundedTexcoords->setEnabled(
     is_hardware && !m_dialog->hasGameTrait(GameDatabase::Trait::ForceRoundUpscaledTextureCoordinates));
 
@@ -17,12 +17,14 @@
 #include "memoryeditorwindow.h"
 #include "memoryscannerwindow.h"
 #include "qthost.h"
+#include "qtprogresscallback.h"
 #include "qtutils.h"
 #include "selectdiscdialog.h"
 #include "settingswindow.h"
 #include "settingwidgetbinder.h"
 
 #include "core/cheats.h"
+#include "core/game_database.h"
 #include "core/game_list.h"
 #include "core/host.h"
 #include "core/memory_card.h"
@@ -30,6 +32,7 @@
 #include "core/system.h"
 
 #include "util/cd_image.h"
+#include "util/cd_image_hasher.h"
 #include "util/gpu_device.h"
 #include "util/platform_misc.h"
 
@@ -37,6 +40,7 @@
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/path.h"
 #include "common/string_util.h"
 
 #include <QtCore/QDebug>
@@ -52,6 +56,7 @@
 #include <QtWidgets/QInputDialog>
 #include <QtWidgets/QProgressBar>
 #include <QtWidgets/QStyleFactory>
+#include <algorithm>
 #include <cmath>
 
 #include "moc_mainwindow.cpp"
@@ -2516,6 +2521,7 @@ void MainWindow::connectSignals()
   connect(m_ui.actionMemoryScanner, &QAction::triggered, this, &MainWindow::onToolsMemoryScannerTriggered);
   connect(m_ui.actionISOBrowser, &QAction::triggered, this, &MainWindow::onToolsISOBrowserTriggered);
   connect(m_ui.actionCoverDownloader, &QAction::triggered, this, &MainWindow::onToolsCoverDownloaderTriggered);
+  connect(m_ui.actionVerifyGameLibrary, &QAction::triggered, this, &MainWindow::onToolsVerifyGameLibraryTriggered);
   connect(m_ui.actionControllerTest, &QAction::triggered, g_emu_thread, &EmuThread::startControllerTest);
   connect(m_ui.actionMediaCapture, &QAction::toggled, this, &MainWindow::onToolsMediaCaptureToggled);
   connect(m_ui.actionCaptureGPUFrame, &QAction::triggered, g_emu_thread, &EmuThread::captureGPUFrameDump);
@@ -3302,6 +3308,82 @@ void MainWindow::onToolsCoverDownloaderTriggered()
   QtUtils::ShowOrRaiseWindow(m_cover_download_window);
 }
 
+void MainWindow::onToolsVerifyGameLibraryTriggered()
+{
+  std::vector<std::string> paths;
+  {
+    const auto lock = GameList::GetLock();
+    for (const GameList::Entry& entry : GameList::GetEntries())
+    {
+      if (entry.IsDisc())
+        paths.push_back(entry.path);
+    }
+  }
+
+  if (paths.empty())
+  {
+    QtUtils::MessageBoxInformation(this, tr("Verify Game Library"),
+                                   tr("There are no disc images in the game list to verify."));
+    return;
+  }
+
+  QtModalProgressCallback progress_callback(this);
+  progress_callback.SetTitle(tr("Verify Game Library").toUtf8().constData());
+  progress_callback.SetStatusText(tr("Computing hashes for %n disc image(s)...", "", static_cast<int>(paths.size()))
+                                    .toUtf8()
+                                    .constData());
+  progress_callback.MakeVisible();
+
+  const std::vector<CDImageHasher::ImageHashResult> results =
+    CDImageHasher::GetTrackHashesForImages(paths, &progress_callback);
+  if (progress_callback.IsCancelled())
+    return;
+
+  progress_callback.SetStatusText(tr("Verifying hashes...").toUtf8().constData());
+
+  u32 verified_count = 0;
+  QStringList problems;
+  std::vector<bool> track_results;
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    const CDImageHasher::ImageHashResult& result = results[i];
+    const QString filename = QtUtils::StringViewToQString(Path::GetFileName(paths[i]));
+    if (!result.success)
+    {
+      problems.append(QStringLiteral("%1: %2").arg(filename).arg(QString::fromStdString(result.error)));
+      continue;
+    }
+
+    const GameDatabase::TrackData* match = GameDatabase::MatchTrackHashes(result.track_hashes, &track_results);
+    const qsizetype matched_tracks = std::count(track_results.begin(), track_results.end(), true);
+    if (!match)
+    {
+      problems.append(tr("%1: No known dump found that matches this hash.").arg(filename));
+    }
+    else if (matched_tracks != static_cast<qsizetype>(track_results.size()))
+    {
+      problems.append(tr("%1: %2 of %3 tracks match %4.")
+                        .arg(filename)
+                        .arg(matched_tracks)
+                        .arg(track_results.size())
+                        .arg(QString::fromStdString(match->serial)));
+    }
+    else
+    {
+      verified_count++;
+    }
+  }
+
+  QMessageBox* const mb = QtUtils::NewMessageBox(
+    problems.isEmpty() ? QMessageBox::Information : QMessageBox::Warning, tr("Verify Game Library"),
+    tr("%1 of %2 disc images match a known good dump.").arg(verified_count).arg(results.size()), QMessageBox::Ok,
+    QMessageBox::NoButton, Qt::WindowModal, this);
+  mb->setAttribute(Qt::WA_DeleteOnClose, true);
+  if (!problems.isEmpty())
+    mb->setDetailedText(problems.join(QLatin1Char('\n')));
+  mb->open();
+}
+
 void MainWindow::onToolsMediaCaptureToggled(bool checked)
 {
   if (!s_system_valid)
@@ -27,6 +27,7 @@
 #include <QtWidgets/QInputDialog>
 #include <QtWidgets/QMenu>
 #include <QtWidgets/QTreeWidgetItemIterator>
+#include <algorithm>
 #include <array>
 #include <utility>
 
@@ -319,7 +320,7 @@ void MemoryScannerWindow::addToWatchClicked()
 
   for (int index = indexFirst; index <= indexLast; index++)
   {
-    const MemoryScan::Result& res = m_scanner.GetResults()[static_cast<u32>(index)];
+    const MemoryScan::Result res = m_scanner.GetResult(static_cast<u32>(index));
     m_watch.AddEntry(formatCheatCode(res.address, res.value, m_scanner.GetSize()), res.address, m_scanner.GetSize(),
                      m_scanner.GetValueSigned(), false);
     updateWatch();
@@ -530,13 +531,11 @@ void MemoryScannerWindow::updateResults()
   QSignalBlocker sb(m_ui.scanTable);
   m_ui.scanTable->setRowCount(0);
 
-  int row = 0;
-  const MemoryScan::ResultVector& results = m_scanner.GetResults();
-  for (const MemoryScan::Result& res : results)
+  const u32 result_count = m_scanner.GetResultCount();
+  const int display_count = static_cast<int>(std::min<u32>(result_count, MAX_DISPLAYED_SCAN_RESULTS));
+  for (int row = 0; row < display_count; row++)
   {
-    if (row == MAX_DISPLAYED_SCAN_RESULTS)
-      break;
-
+    const MemoryScan::Result res = m_scanner.GetResult(static_cast<u32>(row));
     m_ui.scanTable->insertRow(row);
 
     QTableWidgetItem* address_item = new QTableWidgetItem(formatHexValue(res.address, MemoryAccessSize::Word));
@@ -550,16 +549,14 @@ void MemoryScannerWindow::updateResults()
                             createValueItem(m_scanner.GetSize(), res.last_value, m_scanner.GetValueSigned(), false));
     m_ui.scanTable->setItem(row, 3,
                             createValueItem(m_scanner.GetSize(), res.first_value, m_scanner.GetValueSigned(), false));
-
-    row++;
   }
 
-  m_ui.scanResultCount->setText((row < static_cast<int>(results.size())) ?
-                                  tr("%1 (only showing first %2)").arg(results.size()).arg(row) :
-                                  QString::number(m_scanner.GetResultCount()));
+  m_ui.scanResultCount->setText((static_cast<u32>(display_count) < result_count) ?
+                                  tr("%1 (only showing first %2)").arg(result_count).arg(display_count) :
+                                  QString::number(result_count));
 
-  m_ui.scanResetSearch->setEnabled(!results.empty());
-  m_ui.scanSearchAgain->setEnabled(!results.empty());
+  m_ui.scanResetSearch->setEnabled(result_count > 0);
+  m_ui.scanSearchAgain->setEnabled(result_count > 0);
   m_ui.scanAddWatch->setEnabled(false);
 }
 
@@ -567,9 +564,11 @@ void MemoryScannerWindow::updateResultsValues()
 {
   QSignalBlocker sb(m_ui.scanTable);
 
-  int row = 0;
-  for (const MemoryScan::Result& res : m_scanner.GetResults())
+  const int display_count =
+    static_cast<int>(std::min<u32>(m_scanner.GetResultCount(), MAX_DISPLAYED_SCAN_RESULTS));
+  for (int row = 0; row < display_count; row++)
   {
+    const MemoryScan::Result res = m_scanner.GetResult(static_cast<u32>(row));
     if (res.value_changed)
     {
       QTableWidgetItem* item = m_ui.scanTable->item(row, 1);
@@ -579,10 +578,6 @@ void MemoryScannerWindow::updateResultsValues()
         item->setText(formatHexValue(res.value, m_scanner.GetSize()));
       item->setForeground(Qt::red);
     }
-
-    row++;
-    if (row == MAX_DISPLAYED_SCAN_RESULTS)
-      break;
   }
 }
 
@@ -4,6 +4,7 @@
 #include "core/achievements.h"
 #include "core/bus.h"
 #include "core/controller.h"
+#include "core/cpu_code_cache.h"
 #include "core/fullscreenui.h"
 #include "core/fullscreenui_widgets.h"
 #include "core/game_list.h"
@@ -15,6 +16,7 @@
 #include "core/spu.h"
 #include "core/system.h"
 #include "core/system_private.h"
+#include "core/timing_event.h"
 
 #include "scmversion/scmversion.h"
 
@@ -43,6 +45,13 @@
 #include <cstdio>
 #include <ctime>
 
+#ifdef _WIN32
+#include "common/windows_headers.h"
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
 LOG_CHANNEL(Host);
 
 namespace RegTestHost {
@@ -55,7 +64,12 @@ static void InitializeEarlyConsole();
 static void HookSignals();
 static bool SetFolders();
 static bool SetNewDataRoot(const std::string& filename);
-static void DumpSystemStateHashes();
+static void DumpSystemStateHashes(u32 frame);
+static u64 GetPeakMemoryUsage();
+static bool WriteReport(const std::string& path, const std::string& boot_path, u32 frames_executed,
+                        double elapsed_time_ms, bool success);
+static void LogGPUBenchmark(double elapsed_time_ms);
+static void WriteGPUBenchmarkJSON(std::string& json, double elapsed_time_ms);
 static std::string GetFrameDumpPath(u32 frame);
 static void ProcessCPUThreadEvents();
 static void GPUThreadEntryPoint();
@@ -68,6 +82,15 @@ struct RegTestHostState
   u32 blocking_cpu_events_pending = 0;
 };
 
+struct FrameHashes
+{
+  u32 frame;
+  std::string save_state_hash;
+  std::string ram_hash;
+  std::string spu_ram_hash;
+  std::string vram_hash;
+};
+
 static RegTestHostState s_state;
 
 } // namespace RegTestHost
@@ -78,7 +101,12 @@ static Threading::Thread s_gpu_thread;
 static u32 s_frames_to_run = 60 * 60;
 static u32 s_frames_remaining = 0;
 static u32 s_frame_dump_interval = 0;
+static u32 s_gpu_dump_start_frame = 0;
+static u32 s_gpu_benchmark_replays = 0;
+static u32 s_hash_interval = 0;
 static std::string s_dump_base_directory;
+static std::string s_report_path;
+static std::vector<RegTestHost::FrameHashes> s_frame_hashes;
 
 bool RegTestHost::SetFolders()
 {
@@ -356,11 +384,18 @@ void Host::PumpMessagesOnCPUThread()
   RegTestHost::ProcessCPUThreadEvents();
 
   s_frames_remaining--;
+
+  // Number frames from the start of the dump, so partial replays line up with a full run.
+  const u32 frame_number = s_gpu_dump_start_frame + (s_frames_to_run - s_frames_remaining);
   if (s_frames_remaining == 0)
   {
-    RegTestHost::DumpSystemStateHashes();
+    RegTestHost::DumpSystemStateHashes(frame_number);
     System::ShutdownSystem(false);
   }
+  else if (s_hash_interval > 0 && (frame_number % s_hash_interval) == 0)
+  {
+    RegTestHost::DumpSystemStateHashes(frame_number);
+  }
 }
 
 void Host::RunOnCPUThread(std::function<void()> function, bool block /* = false */)
@@ -473,6 +508,8 @@ void Host::DestroyAuxiliaryRenderWindow(AuxiliaryRenderWindowHandle handle, s32*
 
 void Host::FrameDoneOnGPUThread(GPUBackend* gpu_backend, u32 frame_number)
 {
+  frame_number += s_gpu_dump_start_frame;
+
   const GPUPresenter& presenter = gpu_backend->GetPresenter();
   if (s_frame_dump_interval == 0 || (frame_number % s_frame_dump_interval) != 0 || !presenter.HasDisplayTexture())
     return;
@@ -757,9 +794,11 @@ void RegTestHost::GPUThreadEntryPoint()
   GPUThread::Internal::GPUThreadEntryPoint();
 }
 
-void RegTestHost::DumpSystemStateHashes()
+void RegTestHost::DumpSystemStateHashes(u32 frame)
 {
   Error error;
+  FrameHashes hashes = {};
+  hashes.frame = frame;
 
   // don't save full state on gpu dump, it's not going to be complete...
   if (!System::IsReplayingGPUDump())
@@ -772,15 +811,218 @@ void RegTestHost::DumpSystemStateHashes()
       return;
     }
 
-    INFO_LOG("Save State Hash: {}",
-             SHA256Digest::DigestToString(SHA256Digest::GetDigest(state_data.cspan(0, state_data_size))));
-    INFO_LOG("RAM Hash: {}",
-             SHA256Digest::DigestToString(SHA256Digest::GetDigest(std::span<const u8>(Bus::g_ram, Bus::g_ram_size))));
-    INFO_LOG("SPU RAM Hash: {}", SHA256Digest::DigestToString(SHA256Digest::GetDigest(SPU::GetRAM())));
+    hashes.save_state_hash =
+      SHA256Digest::DigestToString(SHA256Digest::GetDigest(state_data.cspan(0, state_data_size)));
+    hashes.ram_hash =
+      SHA256Digest::DigestToString(SHA256Digest::GetDigest(std::span<const u8>(Bus::g_ram, Bus::g_ram_size)));
+    hashes.spu_ram_hash = SHA256Digest::DigestToString(SHA256Digest::GetDigest(SPU::GetRAM()));
+    INFO_LOG("Save State Hash: {}", hashes.save_state_hash);
+    INFO_LOG("RAM Hash: {}", hashes.ram_hash);
+    INFO_LOG("SPU RAM Hash: {}", hashes.spu_ram_hash);
+  }
+  else
+  {
+    // No save state to force a readback, so make sure g_vram is current before hashing it.
+    GPUBackendReadVRAMCommand* cmd = GPUBackend::NewReadVRAMCommand();
+    cmd->x = 0;
+    cmd->y = 0;
+    cmd->width = VRAM_WIDTH;
+    cmd->height = VRAM_HEIGHT;
+    GPUBackend::PushCommandAndSync(cmd, true);
+  }
+
+  hashes.vram_hash = SHA256Digest::DigestToString(
+    SHA256Digest::GetDigest(std::span<const u8>(reinterpret_cast<const u8*>(g_vram), VRAM_SIZE)));
+  INFO_LOG("VRAM Hash: {}", hashes.vram_hash);
+
+  if (!s_report_path.empty())
+    s_frame_hashes.push_back(std::move(hashes));
+}
+
+u64 RegTestHost::GetPeakMemoryUsage()
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS pmc = {};
+  pmc.cb = sizeof(pmc);
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+    return 0;
+
+  return static_cast<u64>(pmc.PeakWorkingSetSize);
+#else
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru) != 0)
+    return 0;
+
+#ifdef __APPLE__
+  // Bytes on MacOS, kilobytes everywhere else.
+  return static_cast<u64>(ru.ru_maxrss);
+#else
+  return static_cast<u64>(ru.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+static std::string EscapeJSONString(std::string_view str)
+{
+  std::string ret;
+  ret.reserve(str.size());
+  for (const char ch : str)
+  {
+    switch (ch)
+    {
+      case '"':
+        ret.append("\\\"");
+        break;
+      case '\\':
+        ret.append("\\\\");
+        break;
+      case '\n':
+        ret.append("\\n");
+        break;
+      case '\r':
+        ret.append("\\r");
+        break;
+      case '\t':
+        ret.append("\\t");
+        break;
+      default:
+      {
+        if (static_cast<unsigned char>(ch) < 0x20)
+          fmt::format_to(std::back_inserter(ret), "\\u{:04x}", static_cast<unsigned>(ch));
+        else
+          ret.push_back(ch);
+      }
+      break;
+    }
+  }
+
+  return ret;
+}
+
+bool RegTestHost::WriteReport(const std::string& path, const std::string& boot_path, u32 frames_executed,
+                              double elapsed_time_ms, bool success)
+{
+  std::string json;
+  fmt::format_to(std::back_inserter(json), "{{\n");
+  fmt::format_to(std::back_inserter(json), "  \"path\": \"{}\",\n", EscapeJSONString(boot_path));
+  fmt::format_to(std::back_inserter(json), "  \"success\": {},\n", success);
+  fmt::format_to(std::back_inserter(json), "  \"gpu_dump\": {},\n", System::IsReplayingGPUDump());
+  fmt::format_to(std::back_inserter(json), "  \"renderer\": \"{}\",\n",
+                 Settings::GetRendererName(g_settings.gpu_renderer));
+  fmt::format_to(std::back_inserter(json), "  \"frames\": {},\n", frames_executed);
+  fmt::format_to(std::back_inserter(json), "  \"wall_time_ms\": {:.3f},\n", elapsed_time_ms);
+  fmt::format_to(std::back_inserter(json), "  \"fps\": {:.3f},\n",
+                 (elapsed_time_ms > 0.0) ? (static_cast<double>(frames_executed) / elapsed_time_ms * 1000.0) : 0.0);
+  fmt::format_to(std::back_inserter(json), "  \"peak_rss_bytes\": {},\n", GetPeakMemoryUsage());
+  if (!System::IsReplayingGPUDump())
+  {
+    const CPU::CodeCache::Statistics& ccs = CPU::CodeCache::GetStatistics();
+    fmt::format_to(std::back_inserter(json),
+                   "  \"code_cache\": {{\"page_invalidations\": {}, \"page_invalidation_ms\": {:.3f}, "
+                   "\"blocks_invalidated\": {}, \"links_added\": {}, \"links_removed\": {}, \"links_patched\": {}}},\n",
+                   ccs.page_invalidations, Timer::ConvertValueToMilliseconds(ccs.page_invalidation_ticks),
+                   ccs.blocks_invalidated, ccs.links_added, ccs.links_removed, ccs.links_patched);
+
+    const u64 reschedules = TimingEvents::GetRescheduleCount();
+    const GlobalTicks emulated_ticks = TimingEvents::GetGlobalTickCounter();
+    fmt::format_to(std::back_inserter(json), "  \"event_reschedules\": {},\n", reschedules);
+    fmt::format_to(std::back_inserter(json), "  \"event_reschedules_per_emulated_second\": {:.1f},\n",
+                   (emulated_ticks > 0) ? (static_cast<double>(reschedules) * static_cast<double>(System::MASTER_CLOCK) /
+                                           static_cast<double>(emulated_ticks)) :
+                                          0.0);
+  }
+  if (s_gpu_benchmark_replays > 0)
+    WriteGPUBenchmarkJSON(json, elapsed_time_ms);
+  fmt::format_to(std::back_inserter(json), "  \"hashes\": [");
+  for (size_t i = 0; i < s_frame_hashes.size(); i++)
+  {
+    const FrameHashes& fh = s_frame_hashes[i];
+    fmt::format_to(std::back_inserter(json), "{}\n    {{\"frame\": {}", (i > 0) ? "," : "", fh.frame);
+    if (!fh.save_state_hash.empty())
+    {
+      fmt::format_to(std::back_inserter(json), ", \"save_state\": \"{}\", \"ram\": \"{}\", \"spu_ram\": \"{}\"",
+                     fh.save_state_hash, fh.ram_hash, fh.spu_ram_hash);
+    }
+    fmt::format_to(std::back_inserter(json), ", \"vram\": \"{}\"}}", fh.vram_hash);
   }
+  fmt::format_to(std::back_inserter(json), "{}]\n}}\n", s_frame_hashes.empty() ? "" : "\n  ");
 
-  INFO_LOG("VRAM Hash: {}", SHA256Digest::DigestToString(SHA256Digest::GetDigest(
-                              std::span<const u8>(reinterpret_cast<const u8*>(g_vram), VRAM_SIZE))));
+  Error error;
+  if (!FileSystem::WriteStringToFile(path.c_str(), json, &error))
+  {
+    ERROR_LOG("Failed to write report to '{}': {}", path, error.GetDescription());
+    return false;
+  }
+
+  INFO_LOG("Wrote report to '{}'.", path);
+  return true;
+}
+
+void RegTestHost::LogGPUBenchmark(double elapsed_time_ms)
+{
+  const GPUBackend::CommandProfile& profile = GPUBackend::GetCommandProfile();
+  const double elapsed_time_sec = elapsed_time_ms / 1000.0;
+
+  u64 total_primitives = 0;
+  u64 total_pixels = 0;
+  INFO_LOG("{:<20} {:>10} {:>12} {:>12} {:>14}", "Command", "Count", "Time (ms)", "Primitives", "Pixels");
+  for (size_t i = 0; i < profile.size(); i++)
+  {
+    const GPUBackend::CommandProfileEntry& entry = profile[i];
+    if (entry.count == 0)
+      continue;
+
+    INFO_LOG("{:<20} {:>10} {:>12.2f} {:>12} {:>14}",
+             GPUBackend::GetCommandTypeName(static_cast<GPUBackendCommandType>(i)), entry.count,
+             Timer::ConvertValueToMilliseconds(entry.time), entry.primitives, entry.pixels);
+    total_primitives += entry.primitives;
+    total_pixels += entry.pixels;
+  }
+
+  INFO_LOG("{} primitives/sec, {} pixels/sec over {} replays.",
+           static_cast<u64>(static_cast<double>(total_primitives) / elapsed_time_sec),
+           static_cast<u64>(static_cast<double>(total_pixels) / elapsed_time_sec), s_gpu_benchmark_replays);
+}
+
+void RegTestHost::WriteGPUBenchmarkJSON(std::string& json, double elapsed_time_ms)
+{
+  const GPUBackend::CommandProfile& profile = GPUBackend::GetCommandProfile();
+  const double elapsed_time_sec = elapsed_time_ms / 1000.0;
+
+  u64 total_primitives = 0;
+  u64 total_pixels = 0;
+  for (const GPUBackend::CommandProfileEntry& entry : profile)
+  {
+    total_primitives += entry.primitives;
+    total_pixels += entry.pixels;
+  }
+
+  fmt::format_to(std::back_inserter(json), "  \"gpu_benchmark\": {{\n");
+  fmt::format_to(std::back_inserter(json), "    \"replays\": {},\n", s_gpu_benchmark_replays);
+  fmt::format_to(std::back_inserter(json), "    \"primitives\": {},\n", total_primitives);
+  fmt::format_to(std::back_inserter(json), "    \"primitives_per_sec\": {:.3f},\n",
+                 (elapsed_time_sec > 0.0) ? (static_cast<double>(total_primitives) / elapsed_time_sec) : 0.0);
+  fmt::format_to(std::back_inserter(json), "    \"pixels\": {},\n", total_pixels);
+  fmt::format_to(std::back_inserter(json), "    \"pixels_per_sec\": {:.3f},\n",
+                 (elapsed_time_sec > 0.0) ? (static_cast<double>(total_pixels) / elapsed_time_sec) : 0.0);
+  fmt::format_to(std::back_inserter(json), "    \"commands\": [");
+
+  bool first = true;
+  for (size_t i = 0; i < profile.size(); i++)
+  {
+    const GPUBackend::CommandProfileEntry& entry = profile[i];
+    if (entry.count == 0)
+      continue;
+
+    fmt::format_to(std::back_inserter(json),
+                   "{}\n      {{\"type\": \"{}\", \"count\": {}, \"time_ms\": {:.3f}, \"primitives\": {}, "
+                   "\"pixels\": {}}}",
+                   first ? "" : ",", GPUBackend::GetCommandTypeName(static_cast<GPUBackendCommandType>(i)),
+                   entry.count, Timer::ConvertValueToMilliseconds(entry.time), entry.primitives, entry.pixels);
+    first = false;
+  }
+
+  fmt::format_to(std::back_inserter(json), "{}]\n  }},\n", first ? "" : "\n    ");
 }
 
 void RegTestHost::InitializeEarlyConsole()
@@ -812,6 +1054,10 @@ void RegTestHost::PrintCommandLineHelp(const char* progname)
   std::fprintf(stderr, "  -dumpdir: Set frame dump base directory (will be dumped to basedir/gametitle).\n");
   std::fprintf(stderr, "  -dumpinterval: Dumps every N frames.\n");
   std::fprintf(stderr, "  -frames: Sets the number of frames to execute.\n");
+  std::fprintf(stderr, "  -startframe <frame>: Starts GPU dump playback at the specified frame.\n");
+  std::fprintf(stderr, "  -gpubench <replays>: Replays a GPU dump N times, and reports per-command timings.\n");
+  std::fprintf(stderr, "  -hashinterval <frames>: Logs system state hashes every N frames.\n");
+  std::fprintf(stderr, "  -report <file>: Writes a JSON report of hashes, timing and peak memory usage.\n");
   std::fprintf(stderr, "  -log <level>: Sets the log level. Defaults to verbose.\n");
   std::fprintf(stderr, "  -console: Enables console logging output.\n");
   std::fprintf(stderr, "  -pgxp: Enables PGXP.\n");
@@ -885,6 +1131,53 @@ bool RegTestHost::ParseCommandLineParameters(int argc, char* argv[], std::option
 
         continue;
       }
+      else if (CHECK_ARG_PARAM("-startframe"))
+      {
+        const std::optional<u32> start_frame = StringUtil::FromChars<u32>(argv[++i]);
+        if (!start_frame.has_value())
+        {
+          ERROR_LOG("Invalid start frame specified: {}", argv[i]);
+          return false;
+        }
+
+        s_gpu_dump_start_frame = start_frame.value();
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-gpubench"))
+      {
+        s_gpu_benchmark_replays = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_gpu_benchmark_replays == 0)
+        {
+          ERROR_LOG("Invalid replay count specified: {}", argv[i]);
+          return false;
+        }
+
+        GPUBackend::SetCommandProfilingEnabled(true);
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-hashinterval"))
+      {
+        s_hash_interval = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_hash_interval == 0)
+        {
+          ERROR_LOG("Invalid hash interval specified: {}", argv[i]);
+          return false;
+        }
+
+        INFO_LOG("Logging state hashes every {} frames.", s_hash_interval);
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-report"))
+      {
+        s_report_path = argv[++i];
+        if (s_report_path.empty())
+        {
+          ERROR_LOG("Invalid report path specified.");
+          return false;
+        }
+
+        continue;
+      }
       else if (CHECK_ARG_PARAM("-log"))
       {
         std::optional<Log::Level> level = Settings::ParseLogLevelName(argv[++i]);
@@ -1051,6 +1344,7 @@ int main(int argc, char* argv[])
 
   Error error;
   int result = -1;
+  const std::string boot_path = autoboot->path;
   INFO_LOG("Trying to boot '{}'...", autoboot->path);
   if (!System::BootSystem(std::move(autoboot.value()), &error))
   {
@@ -1058,11 +1352,34 @@ int main(int argc, char* argv[])
     goto cleanup;
   }
 
-  if (System::IsReplayingGPUDump() && !s_dump_base_directory.empty())
+  if (s_gpu_dump_start_frame > 0)
+  {
+    if (!System::SeekGPUDump(s_gpu_dump_start_frame, &error))
+    {
+      ERROR_LOG("Failed to seek GPU dump: {}", error.GetDescription());
+      goto cleanup;
+    }
+
+    INFO_LOG("Starting GPU dump playback at frame {}.", s_gpu_dump_start_frame);
+  }
+
+  if (s_gpu_benchmark_replays > 0)
+  {
+    if (!System::IsReplayingGPUDump())
+    {
+      ERROR_LOG("GPU benchmark requires a GPU dump.");
+      goto cleanup;
+    }
+
+    // each pass ends on the dump's last vsync, then loops back to the start
+    s_frames_to_run = (static_cast<u32>(System::GetGPUDumpFrameCount()) - 1) * s_gpu_benchmark_replays;
+    INFO_LOG("Benchmarking {} replays of GPU dump.", s_gpu_benchmark_replays);
+  }
+  else if (System::IsReplayingGPUDump() && !s_dump_base_directory.empty())
   {
     INFO_LOG("Replaying GPU dump, dumping all frames.");
     s_frame_dump_interval = 1;
-    s_frames_to_run = static_cast<u32>(System::GetGPUDumpFrameCount());
+    s_frames_to_run = static_cast<u32>(System::GetGPUDumpFrameCount()) - s_gpu_dump_start_frame;
   }
 
   if (s_frame_dump_interval > 0)
@@ -1080,6 +1397,7 @@ int main(int argc, char* argv[])
   s_frames_remaining = s_frames_to_run;
 
   {
+    GPUBackend::ResetCommandProfile();
     const Timer::Value start_time = Timer::GetCurrentValue();
 
     System::Execute();
@@ -1089,6 +1407,19 @@ int main(int argc, char* argv[])
     INFO_LOG("Total execution time: {:.2f}ms, average frame time {:.2f}ms, {:.2f} FPS", elapsed_time_ms,
              elapsed_time_ms / static_cast<double>(s_frames_to_run),
              static_cast<double>(s_frames_to_run) / elapsed_time_ms * 1000.0);
+
+    if (s_gpu_benchmark_replays > 0)
+      RegTestHost::LogGPUBenchmark(elapsed_time_ms);
+
+    if (!s_report_path.empty())
+    {
+      const u32 frames_executed = s_frames_to_run - s_frames_remaining;
+      if (!RegTestHost::WriteReport(s_report_path, boot_path, frames_executed, elapsed_time_ms,
+                                    s_frames_remaining == 0))
+      {
+        goto cleanup;
+      }
+    }
   }
 
   INFO_LOG("Exiting with success.");
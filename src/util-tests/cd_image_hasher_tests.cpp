@@ -0,0 +1,251 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "util/cd_image.h"
+#include "util/cd_image_hasher.h"
+#include "util/host.h"
+
+#include "common/error.h"
+#include "common/file_system.h"
+#include "common/md5_digest.h"
+#include "common/path.h"
+
+#include "fmt/format.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+// The hasher's status text goes through the translation layer, which the frontend normally provides.
+s32 Host::Internal::GetTranslatedStringImpl(std::string_view context, std::string_view msg,
+                                            std::string_view disambiguation, char* tbuf, size_t tbuf_space)
+{
+  if (msg.size() > tbuf_space)
+    return -1;
+  else if (msg.empty())
+    return 0;
+
+  std::memcpy(tbuf, msg.data(), msg.size());
+  return static_cast<s32>(msg.size());
+}
+
+namespace {
+
+// Not a multiple of the pipeline's chunk size, so the last chunk of each index is short.
+static constexpr u32 DATA_TRACK_SECTORS = 300;
+static constexpr u32 AUDIO_PREGAP_SECTORS = 150;
+static constexpr u32 AUDIO_TRACK_SECTORS = 200;
+
+class CDImageHasherTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_directory = Path::Combine(std::filesystem::temp_directory_path().string(),
+                                fmt::format("cd_image_hasher_tests_{}", static_cast<const void*>(this)));
+    ASSERT_TRUE(FileSystem::CreateDirectory(m_directory.c_str(), true));
+
+    ASSERT_TRUE(WriteSectors("data.bin", DATA_TRACK_SECTORS, 1));
+    ASSERT_TRUE(WriteSectors("audio.bin", AUDIO_PREGAP_SECTORS + AUDIO_TRACK_SECTORS, 2));
+
+    const std::string cue = "FILE \"data.bin\" BINARY\n"
+                            "  TRACK 01 MODE2/2352\n"
+                            "    INDEX 01 00:00:00\n"
+                            "FILE \"audio.bin\" BINARY\n"
+                            "  TRACK 02 AUDIO\n"
+                            "    INDEX 00 00:00:00\n"
+                            "    INDEX 01 00:02:00\n";
+    m_cue_path = Path::Combine(m_directory, "image.cue");
+    ASSERT_TRUE(FileSystem::WriteBinaryFile(m_cue_path.c_str(), cue.data(), cue.size()));
+
+    Error error;
+    m_image = CDImage::Open(m_cue_path.c_str(), false, &error);
+    ASSERT_NE(m_image, nullptr) << error.GetDescription();
+    ASSERT_EQ(m_image->GetTrackCount(), 2u);
+  }
+
+  void TearDown() override
+  {
+    m_image.reset();
+    FileSystem::RecursiveDeleteDirectory(m_directory.c_str());
+  }
+
+  bool WriteSectors(const char* filename, u32 count, u32 seed)
+  {
+    std::vector<u8> data(count * CDImage::RAW_SECTOR_SIZE);
+    u32 state = seed;
+    for (u8& byte : data)
+    {
+      state = state * 1103515245u + 12345u;
+      byte = static_cast<u8>(state >> 16);
+    }
+
+    return FileSystem::WriteBinaryFile(Path::Combine(m_directory, filename).c_str(), data.data(), data.size());
+  }
+
+  // Reads and hashes a track one sector at a time, the same way the hasher did before it was pipelined.
+  void SerialHashTrack(u8 track, MD5Digest* digest)
+  {
+    for (u8 index = 0; index < 2; index++)
+    {
+      if (track == 1 && index == 0)
+        continue;
+
+      const u32 length = m_image->GetTrackIndexLength(track, index);
+      ASSERT_TRUE(m_image->Seek(m_image->GetTrackIndexPosition(track, index)));
+
+      u8 sector[CDImage::RAW_SECTOR_SIZE];
+      for (u32 lba = 0; lba < length; lba++)
+      {
+        ASSERT_TRUE(m_image->ReadRawSector(sector, nullptr));
+        digest->Update(sector, sizeof(sector));
+      }
+    }
+  }
+
+  CDImageHasher::Hash SerialTrackHash(u8 track)
+  {
+    MD5Digest digest;
+    SerialHashTrack(track, &digest);
+
+    CDImageHasher::Hash hash;
+    digest.Final(hash);
+    return hash;
+  }
+
+  std::string m_directory;
+  std::string m_cue_path;
+  std::unique_ptr<CDImage> m_image;
+};
+
+class CancelAfterProgressCallback final : public ProgressCallback
+{
+public:
+  explicit CancelAfterProgressCallback(u32 checks) : m_checks_remaining(checks) {}
+
+  bool IsCancelled() const override
+  {
+    if (m_checks_remaining == 0)
+      return true;
+
+    m_checks_remaining--;
+    return false;
+  }
+
+private:
+  mutable u32 m_checks_remaining;
+};
+
+} // namespace
+
+TEST_F(CDImageHasherTest, TrackHashMatchesSerialMD5)
+{
+  for (u8 track = 1; track <= 2; track++)
+  {
+    CDImageHasher::Hash hash;
+    ASSERT_TRUE(CDImageHasher::GetTrackHash(m_image.get(), track, &hash));
+    EXPECT_EQ(hash, SerialTrackHash(track)) << "track " << static_cast<u32>(track);
+  }
+}
+
+TEST_F(CDImageHasherTest, TrackHashesMatchSerialMD5)
+{
+  std::vector<CDImageHasher::Hash> hashes;
+  ASSERT_TRUE(CDImageHasher::GetTrackHashes(m_image.get(), &hashes));
+  ASSERT_EQ(hashes.size(), 2u);
+  EXPECT_EQ(hashes[0], SerialTrackHash(1));
+  EXPECT_EQ(hashes[1], SerialTrackHash(2));
+}
+
+TEST_F(CDImageHasherTest, ImageHashMatchesSerialMD5)
+{
+  MD5Digest digest;
+  SerialHashTrack(1, &digest);
+  SerialHashTrack(2, &digest);
+
+  CDImageHasher::Hash expected;
+  digest.Final(expected);
+
+  CDImageHasher::Hash hash;
+  ASSERT_TRUE(CDImageHasher::GetImageHash(m_image.get(), &hash));
+  EXPECT_EQ(hash, expected);
+}
+
+TEST_F(CDImageHasherTest, CancelWithChunksInFlight)
+{
+  // Cancel part-way through the data track, while chunks are still queued for the hasher.
+  for (u32 checks : {1u, 65u, 200u, DATA_TRACK_SECTORS + 10u})
+  {
+    CancelAfterProgressCallback progress(checks);
+    CDImageHasher::Hash hash;
+    EXPECT_FALSE(CDImageHasher::GetImageHash(m_image.get(), &hash, &progress));
+
+    CancelAfterProgressCallback progress2(checks);
+    std::vector<CDImageHasher::Hash> hashes;
+    EXPECT_FALSE(CDImageHasher::GetTrackHashes(m_image.get(), &hashes, &progress2));
+  }
+
+  // Hashing still works afterwards.
+  CDImageHasher::Hash hash;
+  ASSERT_TRUE(CDImageHasher::GetTrackHash(m_image.get(), 1, &hash));
+  EXPECT_EQ(hash, SerialTrackHash(1));
+}
+
+TEST_F(CDImageHasherTest, TrackHashesForImagesMatchSingleImage)
+{
+  std::vector<CDImageHasher::Hash> expected;
+  ASSERT_TRUE(CDImageHasher::GetTrackHashes(m_image.get(), &expected));
+
+  // More images than workers, with a failure in the middle.
+  std::vector<std::string> paths(9, m_cue_path);
+  paths[4] = Path::Combine(m_directory, "missing.cue");
+
+  const std::vector<CDImageHasher::ImageHashResult> results = CDImageHasher::GetTrackHashesForImages(paths);
+  ASSERT_EQ(results.size(), paths.size());
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    if (i == 4)
+    {
+      EXPECT_FALSE(results[i].success);
+      EXPECT_FALSE(results[i].error.empty());
+      continue;
+    }
+
+    EXPECT_TRUE(results[i].success) << results[i].error;
+    EXPECT_EQ(results[i].track_hashes, expected) << "image " << i;
+  }
+}
+
+TEST_F(CDImageHasherTest, TrackHashesForImagesCancel)
+{
+  // Cancelled before starting, nothing is hashed.
+  {
+    CancelAfterProgressCallback progress(0);
+    const std::vector<CDImageHasher::ImageHashResult> results =
+      CDImageHasher::GetTrackHashesForImages(std::vector<std::string>(4, m_cue_path), &progress);
+    ASSERT_EQ(results.size(), 4u);
+    for (const CDImageHasher::ImageHashResult& result : results)
+    {
+      EXPECT_FALSE(result.success);
+      EXPECT_TRUE(result.error.empty());
+    }
+  }
+
+  // Cancelled at the first progress update. Images which were in flight are abandoned, not reported as errors.
+  {
+    CancelAfterProgressCallback progress(1);
+    const std::vector<CDImageHasher::ImageHashResult> results =
+      CDImageHasher::GetTrackHashesForImages(std::vector<std::string>(32, m_cue_path), &progress);
+    ASSERT_EQ(results.size(), 32u);
+
+    size_t hashed_count = 0;
+    for (const CDImageHasher::ImageHashResult& result : results)
+    {
+      EXPECT_TRUE(result.error.empty()) << result.error;
+      hashed_count += result.success ? 1 : 0;
+    }
+    EXPECT_LT(hashed_count, results.size());
+  }
+}
@@ -0,0 +1,227 @@
+// SPDX-FileCopyrightText: 2019-2025 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: CC-BY-NC-ND-4.0
+
+#include "util/compress_helpers.h"
+
+#include "common/error.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace CompressHelpers;
+
+namespace {
+
+// Small chunks keep the tests fast while still producing several chunks.
+static constexpr size_t TEST_CHUNK_SIZE = 4096;
+
+// Seek table layout, from the end of the buffer: entries, then num_frames (u32), descriptor (u8) and magic (u32).
+static constexpr size_t SEEK_TABLE_FOOTER_SIZE = 9;
+static constexpr size_t SEEK_TABLE_ENTRY_SIZE = 8;
+static constexpr size_t SKIPPABLE_HEADER_SIZE = 8;
+
+ByteBuffer CreateTestData(size_t size)
+{
+  // Compressible, but not so repetitive that every chunk compresses to the same bytes.
+  ByteBuffer data(size);
+  u32 state = 1;
+  for (size_t i = 0; i < size; i++)
+  {
+    state = state * 1103515245u + 12345u;
+    data[i] = static_cast<u8>((i / 64) + ((state >> 16) & 0x7));
+  }
+
+  return data;
+}
+
+size_t GetSeekTableEntryOffset(const ByteBuffer& compressed, size_t num_frames, size_t index)
+{
+  return compressed.size() - SEEK_TABLE_FOOTER_SIZE - (num_frames - index) * SEEK_TABLE_ENTRY_SIZE;
+}
+
+void WriteU32(ByteBuffer& buffer, size_t offset, u32 value)
+{
+  std::memcpy(&buffer[offset], &value, sizeof(value));
+}
+
+u32 ReadU32(const ByteBuffer& buffer, size_t offset)
+{
+  u32 value;
+  std::memcpy(&value, &buffer[offset], sizeof(value));
+  return value;
+}
+
+void CheckRoundTrip(CompressType type, size_t size)
+{
+  const ByteBuffer data = CreateTestData(size);
+  Error error;
+  const OptionalByteBuffer compressed = CompressToBufferMT(type, data.cspan(), -1, TEST_CHUNK_SIZE, &error);
+  ASSERT_TRUE(compressed.has_value()) << error.GetDescription();
+
+  const std::optional<size_t> decompressed_size = GetDecompressedSize(type, compressed->cspan(), &error);
+  ASSERT_TRUE(decompressed_size.has_value()) << error.GetDescription();
+  EXPECT_EQ(decompressed_size.value(), size);
+
+  const OptionalByteBuffer decompressed = DecompressBuffer(type, compressed->cspan(), std::nullopt, &error);
+  ASSERT_TRUE(decompressed.has_value()) << error.GetDescription();
+  ASSERT_EQ(decompressed->size(), size);
+  EXPECT_EQ(std::memcmp(decompressed->data(), data.data(), size), 0);
+}
+
+} // namespace
+
+TEST(CompressHelpers, ZstdMTRoundTripMultipleChunks)
+{
+  CheckRoundTrip(CompressType::Zstandard, TEST_CHUNK_SIZE * 4);
+}
+
+TEST(CompressHelpers, ZstdMTRoundTripShortLastChunk)
+{
+  CheckRoundTrip(CompressType::Zstandard, TEST_CHUNK_SIZE * 3 + 123);
+}
+
+TEST(CompressHelpers, ZstdMTRoundTripSingleChunk)
+{
+  CheckRoundTrip(CompressType::Zstandard, TEST_CHUNK_SIZE - 1);
+}
+
+TEST(CompressHelpers, XzMTRoundTripMultipleChunks)
+{
+  CheckRoundTrip(CompressType::XZ, TEST_CHUNK_SIZE * 4);
+}
+
+TEST(CompressHelpers, XzMTRoundTripShortLastChunk)
+{
+  CheckRoundTrip(CompressType::XZ, TEST_CHUNK_SIZE * 3 + 123);
+}
+
+TEST(CompressHelpers, ZstdSeekTableDescribesChunks)
+{
+  const size_t size = TEST_CHUNK_SIZE * 3 + 123;
+  const ByteBuffer data = CreateTestData(size);
+  const OptionalByteBuffer compressed = CompressToBufferMT(CompressType::Zstandard, data.cspan(), -1, TEST_CHUNK_SIZE);
+  ASSERT_TRUE(compressed.has_value());
+
+  Error error;
+  const std::optional<SeekTable> seek_table = ReadZstdSeekTable(compressed->cspan(), &error);
+  ASSERT_TRUE(seek_table.has_value()) << error.GetDescription();
+  ASSERT_EQ(seek_table->size(), 4u);
+
+  size_t compressed_offset = 0;
+  for (size_t i = 0; i < seek_table->size(); i++)
+  {
+    const SeekTableEntry& entry = seek_table.value()[i];
+    EXPECT_EQ(entry.compressed_offset, compressed_offset);
+    EXPECT_EQ(entry.decompressed_offset, i * TEST_CHUNK_SIZE);
+    EXPECT_EQ(entry.decompressed_size, (i == 3) ? 123u : TEST_CHUNK_SIZE);
+    compressed_offset += entry.compressed_size;
+  }
+}
+
+TEST(CompressHelpers, ZstdSeekTableMissingFromSingleFrame)
+{
+  const ByteBuffer data = CreateTestData(TEST_CHUNK_SIZE);
+  const OptionalByteBuffer compressed = CompressToBuffer(CompressType::Zstandard, data.cspan());
+  ASSERT_TRUE(compressed.has_value());
+
+  Error error;
+  EXPECT_FALSE(ReadZstdSeekTable(compressed->cspan(), &error).has_value());
+  EXPECT_FALSE(error.IsValid());
+}
+
+TEST(CompressHelpers, ZstdDecompressChunksIndividually)
+{
+  const size_t size = TEST_CHUNK_SIZE * 3 + 123;
+  const ByteBuffer data = CreateTestData(size);
+  const OptionalByteBuffer compressed = CompressToBufferMT(CompressType::Zstandard, data.cspan(), -1, TEST_CHUNK_SIZE);
+  ASSERT_TRUE(compressed.has_value());
+
+  const std::optional<SeekTable> seek_table = ReadZstdSeekTable(compressed->cspan());
+  ASSERT_TRUE(seek_table.has_value());
+
+  // Chunks are independent, so the order they're decompressed in doesn't matter.
+  ByteBuffer decompressed(size);
+  std::memset(decompressed.data(), 0, size);
+  for (size_t i = seek_table->size(); i > 0; i--)
+  {
+    Error error;
+    ASSERT_TRUE(DecompressZstdChunk(decompressed.span(), compressed->cspan(), seek_table.value()[i - 1], &error))
+      << error.GetDescription();
+  }
+  EXPECT_EQ(std::memcmp(decompressed.data(), data.data(), size), 0);
+
+  // Entries pointing outside of either buffer are rejected rather than read.
+  SeekTableEntry entry = seek_table->back();
+  entry.decompressed_size++;
+  EXPECT_FALSE(DecompressZstdChunk(decompressed.span(), compressed->cspan(), entry));
+
+  entry = seek_table->back();
+  entry.compressed_offset = compressed->size();
+  EXPECT_FALSE(DecompressZstdChunk(decompressed.span(), compressed->cspan(), entry));
+}
+
+TEST(CompressHelpers, ZstdCorruptedSeekTable)
+{
+  const size_t size = TEST_CHUNK_SIZE * 3 + 123;
+  const ByteBuffer data = CreateTestData(size);
+  const OptionalByteBuffer compressed = CompressToBufferMT(CompressType::Zstandard, data.cspan(), -1, TEST_CHUNK_SIZE);
+  ASSERT_TRUE(compressed.has_value());
+
+  const size_t footer_offset = compressed->size() - SEEK_TABLE_FOOTER_SIZE;
+  const size_t num_frames = ReadU32(compressed.value(), footer_offset);
+  ASSERT_EQ(num_frames, 4u);
+
+  // Reserved descriptor bits set.
+  {
+    ByteBuffer corrupted = compressed.value();
+    corrupted[footer_offset + sizeof(u32)] |= 0x04;
+    Error error;
+    EXPECT_FALSE(ReadZstdSeekTable(corrupted.cspan(), &error).has_value());
+    EXPECT_TRUE(error.IsValid());
+  }
+
+  // Frame count larger than the buffer.
+  {
+    ByteBuffer corrupted = compressed.value();
+    WriteU32(corrupted, footer_offset, 0x10000000u);
+    Error error;
+    EXPECT_FALSE(ReadZstdSeekTable(corrupted.cspan(), &error).has_value());
+    EXPECT_TRUE(error.IsValid());
+  }
+
+  // Skippable frame header doesn't match the table size.
+  {
+    ByteBuffer corrupted = compressed.value();
+    const size_t header_offset = GetSeekTableEntryOffset(corrupted, num_frames, 0) - SKIPPABLE_HEADER_SIZE;
+    WriteU32(corrupted, header_offset + sizeof(u32), ReadU32(corrupted, header_offset + sizeof(u32)) + 1);
+    Error error;
+    EXPECT_FALSE(ReadZstdSeekTable(corrupted.cspan(), &error).has_value());
+    EXPECT_TRUE(error.IsValid());
+  }
+
+  // Compressed size running past the start of the seek table.
+  {
+    ByteBuffer corrupted = compressed.value();
+    WriteU32(corrupted, GetSeekTableEntryOffset(corrupted, num_frames, 2), static_cast<u32>(corrupted.size()));
+    Error error;
+    EXPECT_FALSE(ReadZstdSeekTable(corrupted.cspan(), &error).has_value());
+    EXPECT_TRUE(error.IsValid());
+  }
+
+  // Decompressed size which doesn't match the frame. The table still parses, but decompression has to fail.
+  {
+    ByteBuffer corrupted = compressed.value();
+    const size_t entry_offset = GetSeekTableEntryOffset(corrupted, num_frames, 1);
+    WriteU32(corrupted, entry_offset + sizeof(u32), ReadU32(corrupted, entry_offset + sizeof(u32)) + 16);
+
+    const std::optional<SeekTable> seek_table = ReadZstdSeekTable(corrupted.cspan());
+    ASSERT_TRUE(seek_table.has_value());
+    EXPECT_EQ(seek_table.value()[1].decompressed_size, TEST_CHUNK_SIZE + 16);
+
+    Error error;
+    EXPECT_FALSE(DecompressBuffer(CompressType::Zstandard, corrupted.cspan(), std::nullopt, &error).has_value());
+    EXPECT_TRUE(error.IsValid());
+  }
+}
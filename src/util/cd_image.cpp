@@ -352,6 +352,10 @@ bool CDImage::IsPrecached() const
   return false;
 }
 
+void CDImage::PrefetchSectors(LBA start_lba, u32 count)
+{
+}
+
 s64 CDImage::GetSizeOnDisk() const
 {
   return -1;
@@ -312,6 +312,10 @@ public:
   virtual PrecacheResult Precache(ProgressCallback* progress = ProgressCallback::NullProgressCallback);
   virtual bool IsPrecached() const;
 
+  // Hints that the sectors starting at the specified disc position will be read soon.
+  // Images which need to decompress data can do so ahead of time, others can ignore it.
+  virtual void PrefetchSectors(LBA start_lba, u32 count);
+
   // Returns the size on disk of the image. This could be multiple files.
   // If this function returns -1, it means the size could not be computed.
   virtual s64 GetSizeOnDisk() const;
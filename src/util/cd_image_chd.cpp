@@ -20,11 +20,13 @@
 
 #include <algorithm>
 #include <cerrno>
+#include <condition_variable>
 #include <cstdio>
 #include <cstring>
 #include <limits>
 #include <mutex>
 #include <optional>
+#include <thread>
 
 LOG_CHANNEL(CDImage);
 
@@ -68,6 +70,7 @@ public:
   PrecacheResult Precache(ProgressCallback* progress) override;
   bool IsPrecached() const override;
   s64 GetSizeOnDisk() const override;
+  void PrefetchSectors(LBA start_lba, u32 count) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
@@ -76,19 +79,58 @@ private:
   static constexpr u32 CHD_CD_SECTOR_DATA_SIZE = 2352 + 96;
   static constexpr u32 CHD_CD_TRACK_ALIGNMENT = 4;
   static constexpr u32 MAX_PARENTS = 32; // Surely someone wouldn't be insane enough to go beyond this...
+  static constexpr u32 MIN_HUNK_CACHE_SIZE = 8;
+  static constexpr u32 MAX_HUNK_CACHE_SIZE = 64;
+  static constexpr u32 INVALID_HUNK_INDEX = static_cast<u32>(-1);
+
+  enum class HunkState : u8
+  {
+    Empty,
+    Loading,
+    Ready,
+  };
+
+  struct CachedHunk
+  {
+    DynamicHeapArray<u8, 16> data;
+    u32 hunk_index = INVALID_HUNK_INDEX;
+    u32 last_used = 0;
+    HunkState state = HunkState::Empty;
+  };
 
   chd_file* OpenCHD(std::string_view filename, FileSystem::ManagedCFilePtr fp, Error* error, u32 recursion_level);
-  bool UpdateHunkBuffer(const Index& index, LBA lba_in_index, u32& hunk_offset);
+  const u8* GetHunkForSector(const Index& index, LBA lba_in_index, u32& hunk_offset);
+
+  CachedHunk* LookupCachedHunk(u32 hunk_index);
+  CachedHunk* GetHunkCacheVictim();
+  bool ReadHunk(std::unique_lock<std::mutex>& lock, CachedHunk* hunk, u32 hunk_index);
+  void ResizeHunkCache(u32 size);
+  void StopPrefetchThread();
+  void PrefetchThreadEntryPoint();
 
   static void CopyAndSwap(void* dst_ptr, const u8* src_ptr);
 
   chd_file* m_chd = nullptr;
   u32 m_hunk_size = 0;
   u32 m_sectors_per_hunk = 0;
-
-  DynamicHeapArray<u8, 16> m_hunk_buffer;
-  u32 m_current_hunk_index = static_cast<u32>(-1);
+  u32 m_hunk_count = 0;
   bool m_precached = false;
+
+  // chd_read() is not reentrant, so the reader and prefetch thread take turns.
+  std::mutex m_chd_mutex;
+
+  // Least-recently-used cache of decompressed hunks, shared with the prefetch thread.
+  // The hunk last returned to the reader is never evicted by the prefetch thread.
+  std::mutex m_hunk_cache_mutex;
+  std::condition_variable m_hunk_loaded_cv;
+  std::vector<std::unique_ptr<CachedHunk>> m_hunk_cache;
+  CachedHunk* m_current_hunk = nullptr;
+  u32 m_hunk_cache_counter = 0;
+
+  std::thread m_prefetch_thread;
+  std::condition_variable m_prefetch_cv;
+  std::vector<u32> m_prefetch_queue;
+  bool m_prefetch_shutdown = false;
 };
 } // namespace
 
@@ -96,6 +138,8 @@ CDImageCHD::CDImageCHD() = default;
 
 CDImageCHD::~CDImageCHD()
 {
+  StopPrefetchThread();
+
   if (m_chd)
     chd_close(m_chd);
 }
@@ -258,7 +302,8 @@ bool CDImageCHD::Open(const char* filename, Error* error)
   }
 
   m_sectors_per_hunk = m_hunk_size / CHD_CD_SECTOR_DATA_SIZE;
-  m_hunk_buffer.resize(m_hunk_size);
+  m_hunk_count = header->totalhunks;
+  ResizeHunkCache(MIN_HUNK_CACHE_SIZE);
   m_filename = filename;
 
   u32 disc_lba = 0;
@@ -421,11 +466,12 @@ bool CDImageCHD::ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_
     return CDImage::ReadSubChannelQ(subq, index, lba_in_index);
 
   u32 hunk_offset;
-  if (!UpdateHunkBuffer(index, lba_in_index, hunk_offset))
+  const u8* hunk_data = GetHunkForSector(index, lba_in_index, hunk_offset);
+  if (!hunk_data)
     return false;
 
   u8 deinterleaved_subchannel_data[96];
-  const u8* raw_subchannel_data = &m_hunk_buffer[hunk_offset + RAW_SECTOR_SIZE];
+  const u8* raw_subchannel_data = &hunk_data[hunk_offset + RAW_SECTOR_SIZE];
   const u8* real_subchannel_data = raw_subchannel_data;
   if (index.submode == CDImage::SubchannelMode::RawInterleaved)
   {
@@ -461,6 +507,7 @@ CDImage::PrecacheResult CDImageCHD::Precache(ProgressCallback* progress)
     static_cast<ProgressCallback*>(param)->SetStatusText(TinyString::from_format("{}MB of {}MB", pos_mb, total_mb));
   };
 
+  std::unique_lock lock(m_chd_mutex);
   if (chd_precache_progress(m_chd, callback, progress) != CHDERR_NONE)
     return CDImage::PrecacheResult::ReadError;
 
@@ -495,42 +542,217 @@ ALWAYS_INLINE_RELEASE void CDImageCHD::CopyAndSwap(void* dst_ptr, const u8* src_
 bool CDImageCHD::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
 {
   u32 hunk_offset;
-  if (!UpdateHunkBuffer(index, lba_in_index, hunk_offset))
+  const u8* hunk_data = GetHunkForSector(index, lba_in_index, hunk_offset);
+  if (!hunk_data)
     return false;
 
   // Audio data is in big-endian, so we have to swap it for little endian hosts...
   if (index.mode == TrackMode::Audio)
-    CopyAndSwap(buffer, &m_hunk_buffer[hunk_offset]);
+    CopyAndSwap(buffer, &hunk_data[hunk_offset]);
   else
-    std::memcpy(buffer, &m_hunk_buffer[hunk_offset], RAW_SECTOR_SIZE);
+    std::memcpy(buffer, &hunk_data[hunk_offset], RAW_SECTOR_SIZE);
 
   return true;
 }
 
-ALWAYS_INLINE_RELEASE bool CDImageCHD::UpdateHunkBuffer(const Index& index, LBA lba_in_index, u32& hunk_offset)
+const u8* CDImageCHD::GetHunkForSector(const Index& index, LBA lba_in_index, u32& hunk_offset)
 {
   const u32 disc_frame = static_cast<LBA>(index.file_offset) + lba_in_index;
   const u32 hunk_index = static_cast<u32>(disc_frame / m_sectors_per_hunk);
   hunk_offset = static_cast<u32>((disc_frame % m_sectors_per_hunk) * CHD_CD_SECTOR_DATA_SIZE);
   DebugAssert((m_hunk_size - hunk_offset) >= CHD_CD_SECTOR_DATA_SIZE);
 
-  if (m_current_hunk_index == hunk_index)
-    return true;
+  // Fast path, sequential reads within the same hunk. The prefetch thread can't evict the current hunk.
+  if (m_current_hunk && m_current_hunk->hunk_index == hunk_index && m_current_hunk->state == HunkState::Ready)
+    return m_current_hunk->data.data();
 
-  const chd_error err = chd_read(m_chd, hunk_index, m_hunk_buffer.data());
-  if (err != CHDERR_NONE)
+  std::unique_lock lock(m_hunk_cache_mutex);
+
+  CachedHunk* hunk = LookupCachedHunk(hunk_index);
+  if (hunk && hunk->state == HunkState::Loading)
   {
-    ERROR_LOG("chd_read({}) failed: {}", hunk_index, chd_error_string(err));
+    // Prefetch thread is already decompressing it, no point doing it twice.
+    m_hunk_loaded_cv.wait(lock, [hunk, hunk_index]() {
+      return (hunk->state != HunkState::Loading || hunk->hunk_index != hunk_index);
+    });
+    if (hunk->state != HunkState::Ready || hunk->hunk_index != hunk_index) [[unlikely]]
+      hunk = nullptr;
+  }
+
+  if (!hunk)
+  {
+    hunk = GetHunkCacheVictim();
+    DebugAssert(hunk);
+    if (!ReadHunk(lock, hunk, hunk_index))
+    {
+      m_current_hunk = nullptr;
+      return nullptr;
+    }
+  }
 
-    // data might have been partially written
-    m_current_hunk_index = static_cast<u32>(-1);
+  hunk->last_used = ++m_hunk_cache_counter;
+  m_current_hunk = hunk;
+  return hunk->data.data();
+}
+
+CDImageCHD::CachedHunk* CDImageCHD::LookupCachedHunk(u32 hunk_index)
+{
+  for (const std::unique_ptr<CachedHunk>& hunk : m_hunk_cache)
+  {
+    if (hunk->hunk_index == hunk_index && hunk->state != HunkState::Empty)
+      return hunk.get();
+  }
+
+  return nullptr;
+}
+
+CDImageCHD::CachedHunk* CDImageCHD::GetHunkCacheVictim()
+{
+  CachedHunk* victim = nullptr;
+  for (const std::unique_ptr<CachedHunk>& hunk : m_hunk_cache)
+  {
+    if (hunk->state == HunkState::Loading || hunk.get() == m_current_hunk)
+      continue;
+    else if (hunk->state == HunkState::Empty)
+      return hunk.get();
+    else if (!victim || hunk->last_used < victim->last_used)
+      victim = hunk.get();
+  }
+
+  return victim;
+}
+
+bool CDImageCHD::ReadHunk(std::unique_lock<std::mutex>& lock, CachedHunk* hunk, u32 hunk_index)
+{
+  hunk->hunk_index = hunk_index;
+  hunk->state = HunkState::Loading;
+  lock.unlock();
+
+  chd_error err;
+  {
+    std::unique_lock chd_lock(m_chd_mutex);
+    err = chd_read(m_chd, hunk_index, hunk->data.data());
+  }
+
+  lock.lock();
+
+  // data might have been partially written
+  hunk->state = (err == CHDERR_NONE) ? HunkState::Ready : HunkState::Empty;
+  hunk->last_used = ++m_hunk_cache_counter;
+  m_hunk_loaded_cv.notify_all();
+  if (err != CHDERR_NONE) [[unlikely]]
+  {
+    ERROR_LOG("chd_read({}) failed: {}", hunk_index, chd_error_string(err));
     return false;
   }
 
-  m_current_hunk_index = hunk_index;
   return true;
 }
 
+void CDImageCHD::ResizeHunkCache(u32 size)
+{
+  // Only grows, so existing pointers stay valid.
+  std::unique_lock lock(m_hunk_cache_mutex);
+  size = std::min(size, MAX_HUNK_CACHE_SIZE);
+  if (m_hunk_cache.size() >= size)
+    return;
+
+  DEV_LOG("Resizing CHD hunk cache to {} hunks ({} KB)", size, (size * m_hunk_size) / 1024);
+  m_hunk_cache.reserve(size);
+  while (m_hunk_cache.size() < size)
+  {
+    std::unique_ptr<CachedHunk> hunk = std::make_unique<CachedHunk>();
+    hunk->data.resize(m_hunk_size);
+    m_hunk_cache.push_back(std::move(hunk));
+  }
+}
+
+void CDImageCHD::PrefetchSectors(LBA start_lba, u32 count)
+{
+  if (count == 0 || start_lba >= m_lba_count)
+    return;
+
+  // Convert disc positions to hunks. Indices can be discontinuous in the CHD due to track padding.
+  const LBA end_lba = std::min(start_lba + count, m_lba_count) - 1;
+  const Index* start_index = GetIndexForDiscPosition(start_lba);
+  const Index* end_index = GetIndexForDiscPosition(end_lba);
+  const auto get_hunk_index = [this](const Index* index, LBA lba) {
+    return (index && index->file_sector_size > 0) ?
+             static_cast<u32>((index->file_offset + (lba - index->start_lba_on_disc)) / m_sectors_per_hunk) :
+             INVALID_HUNK_INDEX;
+  };
+  u32 first_hunk = get_hunk_index(start_index, start_lba);
+  u32 last_hunk = get_hunk_index(end_index, end_lba);
+  if (first_hunk == INVALID_HUNK_INDEX)
+    first_hunk = last_hunk;
+  else if (last_hunk == INVALID_HUNK_INDEX || last_hunk < first_hunk)
+    last_hunk = first_hunk;
+  if (first_hunk >= m_hunk_count)
+    return;
+  last_hunk = std::min(last_hunk, m_hunk_count - 1);
+
+  // Make sure the cache can hold the prefetched hunks, as well as the one currently being read.
+  const u32 num_hunks = std::min(last_hunk - first_hunk + 1, MAX_HUNK_CACHE_SIZE - 2);
+  if (m_hunk_cache.size() < (num_hunks + 2))
+    ResizeHunkCache(std::max(num_hunks + 2, MIN_HUNK_CACHE_SIZE));
+
+  // Anything still queued from the last hint is stale if the reader seeked.
+  std::unique_lock lock(m_hunk_cache_mutex);
+  m_prefetch_queue.clear();
+  for (u32 hunk_index = first_hunk; hunk_index < (first_hunk + num_hunks); hunk_index++)
+  {
+    if (!LookupCachedHunk(hunk_index))
+      m_prefetch_queue.push_back(hunk_index);
+  }
+  if (m_prefetch_queue.empty())
+    return;
+
+  if (!m_prefetch_thread.joinable())
+    m_prefetch_thread = std::thread(&CDImageCHD::PrefetchThreadEntryPoint, this);
+  else
+    m_prefetch_cv.notify_one();
+}
+
+void CDImageCHD::StopPrefetchThread()
+{
+  if (!m_prefetch_thread.joinable())
+    return;
+
+  {
+    std::unique_lock lock(m_hunk_cache_mutex);
+    m_prefetch_shutdown = true;
+    m_prefetch_cv.notify_one();
+  }
+
+  m_prefetch_thread.join();
+}
+
+void CDImageCHD::PrefetchThreadEntryPoint()
+{
+  std::unique_lock lock(m_hunk_cache_mutex);
+
+  for (;;)
+  {
+    m_prefetch_cv.wait(lock, [this]() { return (m_prefetch_shutdown || !m_prefetch_queue.empty()); });
+    if (m_prefetch_shutdown)
+      break;
+
+    const u32 hunk_index = m_prefetch_queue.front();
+    m_prefetch_queue.erase(m_prefetch_queue.begin());
+
+    // reader might have got there first
+    if (LookupCachedHunk(hunk_index))
+      continue;
+
+    CachedHunk* hunk = GetHunkCacheVictim();
+    if (!hunk)
+      continue;
+
+    DEBUG_LOG("Prefetching hunk {}", hunk_index);
+    ReadHunk(lock, hunk, hunk_index);
+  }
+}
+
 s64 CDImageCHD::GetSizeOnDisk() const
 {
   return static_cast<s64>(chd_get_compressed_size(m_chd));
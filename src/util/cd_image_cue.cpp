@@ -11,6 +11,7 @@
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/memmap.h"
 #include "common/path.h"
 #include "common/string_util.h"
 
@@ -41,6 +42,9 @@ public:
 
   virtual bool Read(void* buffer, u64 offset, u32 size, Error* error) = 0;
 
+  /// Starts paging in the whole file, if it is memory mapped. Returns false if unsupported.
+  virtual bool Precache();
+
 protected:
   std::string m_filename;
 };
@@ -55,10 +59,15 @@ public:
   u64 GetDiskSize() override;
 
   bool Read(void* buffer, u64 offset, u32 size, Error* error) override;
+  bool Precache() override;
 
 private:
   FileSystem::ManagedCFilePtr m_file;
   u64 m_file_position = 0;
+
+  // Uncompressed images are mapped where possible, so reads skip stdio and share the OS page cache.
+  const u8* m_mapping = nullptr;
+  u64 m_mapping_size = 0;
 };
 
 class ECMTrackFileInterface final : public TrackFileInterface
@@ -143,6 +152,8 @@ public:
   bool OpenAndParseCueSheet(const char* path, Error* error);
   bool OpenAndParseSingleFile(const char* path, Error* error);
 
+  PrecacheResult Precache(ProgressCallback* progress = ProgressCallback::NullProgressCallback) override;
+  bool IsPrecached() const override;
   s64 GetSizeOnDisk() const override;
 
 protected:
@@ -150,6 +161,7 @@ protected:
 
 private:
   std::vector<std::unique_ptr<TrackFileInterface>> m_files;
+  bool m_precached = false;
 };
 
 } // namespace
@@ -162,12 +174,38 @@ TrackFileInterface::TrackFileInterface(std::string filename) : m_filename(std::m
 
 TrackFileInterface::~TrackFileInterface() = default;
 
+bool TrackFileInterface::Precache()
+{
+  return false;
+}
+
 BinaryTrackFileInterface::BinaryTrackFileInterface(std::string filename, FileSystem::ManagedCFilePtr file)
   : TrackFileInterface(std::move(filename)), m_file(std::move(file))
 {
+  // Not worth the address space on 32-bit hosts.
+  if constexpr (sizeof(void*) < 8)
+    return;
+
+  const s64 size = FileSystem::FSize64(m_file.get());
+  if (size <= 0)
+    return;
+
+  Error error;
+  m_mapping = static_cast<const u8*>(MemMap::MapFileReadOnly(m_file.get(), static_cast<size_t>(size), &error));
+  if (!m_mapping)
+  {
+    WARNING_LOG("Failed to map '{}', falling back to buffered reads: {}", m_filename, error.GetDescription());
+    return;
+  }
+
+  m_mapping_size = static_cast<u64>(size);
 }
 
-BinaryTrackFileInterface::~BinaryTrackFileInterface() = default;
+BinaryTrackFileInterface::~BinaryTrackFileInterface()
+{
+  if (m_mapping)
+    MemMap::UnmapFile(m_mapping, static_cast<size_t>(m_mapping_size));
+}
 
 std::unique_ptr<TrackFileInterface> TrackFileInterface::OpenBinaryFile(const std::string_view filename,
                                                                        const std::string& path, Error* error)
@@ -193,6 +231,19 @@ std::unique_ptr<TrackFileInterface> TrackFileInterface::OpenBinaryFile(const std
 
 bool BinaryTrackFileInterface::Read(void* buffer, u64 offset, u32 size, Error* error)
 {
+  if (m_mapping)
+  {
+    if (offset > m_mapping_size || size > (m_mapping_size - offset)) [[unlikely]]
+    {
+      Error::SetStringFmt(error, "Read of {} bytes at offset {} is past end of file ({} bytes)", size, offset,
+                          m_mapping_size);
+      return false;
+    }
+
+    std::memcpy(buffer, m_mapping + offset, size);
+    return true;
+  }
+
   if (m_file_position != offset)
   {
     if (!FileSystem::FSeek64(m_file.get(), static_cast<s64>(offset), SEEK_SET, error)) [[unlikely]]
@@ -214,6 +265,15 @@ bool BinaryTrackFileInterface::Read(void* buffer, u64 offset, u32 size, Error* e
   return true;
 }
 
+bool BinaryTrackFileInterface::Precache()
+{
+  if (!m_mapping)
+    return false;
+
+  MemMap::PrefetchFileMapping(m_mapping, static_cast<size_t>(m_mapping_size));
+  return true;
+}
+
 u64 BinaryTrackFileInterface::GetSize()
 {
   return static_cast<u64>(std::max<s64>(FileSystem::FSize64(m_file.get()), 0));
@@ -878,6 +938,29 @@ bool CDImageCueSheet::ReadSectorFromIndex(void* buffer, const Index& index, LBA
   return true;
 }
 
+CDImage::PrecacheResult
+CDImageCueSheet::Precache(ProgressCallback* progress /*= ProgressCallback::NullProgressCallback*/)
+{
+  if (m_precached)
+    return PrecacheResult::Success;
+
+  // Mapped files only need paging in, the OS keeps them cached and shares them between processes.
+  // Anything else (ECM, WAV) falls back to copying the image into memory.
+  for (const std::unique_ptr<TrackFileInterface>& tf : m_files)
+  {
+    if (!tf->Precache())
+      return PrecacheResult::Unsupported;
+  }
+
+  m_precached = true;
+  return PrecacheResult::Success;
+}
+
+bool CDImageCueSheet::IsPrecached() const
+{
+  return m_precached;
+}
+
 s64 CDImageCueSheet::GetSizeOnDisk() const
 {
   // Doesn't include the cue.. but they're tiny anyway, whatever.
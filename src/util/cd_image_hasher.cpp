@@ -5,19 +5,169 @@
 #include "cd_image.h"
 #include "host.h"
 
+#include "common/error.h"
+#include "common/heap_array.h"
 #include "common/md5_digest.h"
 #include "common/string_util.h"
 
 #include "fmt/format.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 namespace CDImageHasher {
 
-static bool ReadIndex(CDImage* image, u8 track, u8 index, MD5Digest* digest, ProgressCallback* progress_callback);
-static bool ReadTrack(CDImage* image, u8 track, MD5Digest* digest, ProgressCallback* progress_callback);
+namespace {
+
+/// Overlaps reading sectors on the calling thread with hashing them on a worker thread.
+/// Chunks are hashed in submission order, so each digest sees its data sequentially.
+class HashPipeline
+{
+public:
+  static constexpr u32 SECTORS_PER_CHUNK = 64;
+  static constexpr u32 CHUNK_SIZE = SECTORS_PER_CHUNK * CDImage::RAW_SECTOR_SIZE;
+  static constexpr u32 NUM_CHUNKS = 4;
+
+  HashPipeline();
+  ~HashPipeline();
+
+  /// Returns the next buffer to read into, waiting for the hasher if all buffers are in use.
+  u8* BeginChunk();
+
+  /// Queues the buffer returned by BeginChunk() for hashing.
+  void SubmitChunk(MD5Digest* digest, u32 size);
+
+  /// Waits for all submitted chunks to be hashed.
+  void Flush();
+
+private:
+  struct Chunk
+  {
+    MD5Digest* digest;
+    u32 size;
+  };
+
+  void WorkerThreadEntryPoint();
+
+  DynamicHeapArray<u8> m_buffer;
+  std::array<Chunk, NUM_CHUNKS> m_chunks = {};
+  u32 m_write_pos = 0;
+  u32 m_read_pos = 0;
+  u32 m_count = 0;
+  bool m_shutdown = false;
+
+  std::mutex m_mutex;
+  std::condition_variable m_work_cv;
+  std::condition_variable m_done_cv;
+  std::thread m_thread;
+};
+
+/// Progress callback for images hashed on a worker thread. Progress isn't reported from workers, but cancellation
+/// is checked for every sector, and read errors are kept for the result instead of being shown.
+class WorkerProgressCallback final : public ProgressCallback
+{
+public:
+  WorkerProgressCallback(const std::atomic_bool& cancelled, std::string* error);
+
+  bool IsCancelled() const override;
+  void ModalError(const std::string_view message) override;
+
+private:
+  const std::atomic_bool& m_cancelled;
+  std::string* m_error;
+};
+
+} // namespace
+
+static constexpr u32 MAX_PARALLEL_IMAGES = 4;
+
+static bool ReadIndex(CDImage* image, u8 track, u8 index, HashPipeline& pipeline, MD5Digest* digest,
+                      ProgressCallback* progress_callback);
+static bool ReadTrack(CDImage* image, u8 track, HashPipeline& pipeline, MD5Digest* digest,
+                      ProgressCallback* progress_callback);
+static void HashImage(const std::string& path, const std::atomic_bool& cancelled, ImageHashResult* result);
 
 } // namespace CDImageHasher
 
-bool CDImageHasher::ReadIndex(CDImage* image, u8 track, u8 index, MD5Digest* digest,
+CDImageHasher::HashPipeline::HashPipeline()
+{
+  m_buffer.resize(CHUNK_SIZE * NUM_CHUNKS);
+  m_thread = std::thread(&HashPipeline::WorkerThreadEntryPoint, this);
+}
+
+CDImageHasher::HashPipeline::~HashPipeline()
+{
+  {
+    std::unique_lock lock(m_mutex);
+    m_shutdown = true;
+    m_work_cv.notify_one();
+  }
+
+  m_thread.join();
+}
+
+u8* CDImageHasher::HashPipeline::BeginChunk()
+{
+  std::unique_lock lock(m_mutex);
+  m_done_cv.wait(lock, [this]() { return (m_count < NUM_CHUNKS); });
+  return &m_buffer[m_write_pos * CHUNK_SIZE];
+}
+
+void CDImageHasher::HashPipeline::SubmitChunk(MD5Digest* digest, u32 size)
+{
+  std::unique_lock lock(m_mutex);
+  m_chunks[m_write_pos] = Chunk{digest, size};
+  m_write_pos = (m_write_pos + 1) % NUM_CHUNKS;
+  m_count++;
+  m_work_cv.notify_one();
+}
+
+void CDImageHasher::HashPipeline::Flush()
+{
+  std::unique_lock lock(m_mutex);
+  m_done_cv.wait(lock, [this]() { return (m_count == 0); });
+}
+
+void CDImageHasher::HashPipeline::WorkerThreadEntryPoint()
+{
+  std::unique_lock lock(m_mutex);
+  for (;;)
+  {
+    m_work_cv.wait(lock, [this]() { return (m_count > 0 || m_shutdown); });
+    if (m_count == 0)
+      break;
+
+    const Chunk& chunk = m_chunks[m_read_pos];
+    const u8* data = &m_buffer[m_read_pos * CHUNK_SIZE];
+    lock.unlock();
+
+    chunk.digest->Update(data, chunk.size);
+
+    lock.lock();
+    m_read_pos = (m_read_pos + 1) % NUM_CHUNKS;
+    m_count--;
+    m_done_cv.notify_one();
+  }
+}
+
+CDImageHasher::WorkerProgressCallback::WorkerProgressCallback(const std::atomic_bool& cancelled, std::string* error)
+  : m_cancelled(cancelled), m_error(error)
+{
+}
+
+bool CDImageHasher::WorkerProgressCallback::IsCancelled() const
+{
+  return m_cancelled.load(std::memory_order_relaxed);
+}
+
+void CDImageHasher::WorkerProgressCallback::ModalError(const std::string_view message)
+{
+  m_error->assign(message);
+}
+
+bool CDImageHasher::ReadIndex(CDImage* image, u8 track, u8 index, HashPipeline& pipeline, MD5Digest* digest,
                               ProgressCallback* progress_callback)
 {
   const CDImage::LBA index_start = image->GetTrackIndexPosition(track, index);
@@ -34,7 +184,8 @@ bool CDImageHasher::ReadIndex(CDImage* image, u8 track, u8 index, MD5Digest* dig
     return false;
   }
 
-  std::array<u8, CDImage::RAW_SECTOR_SIZE> sector;
+  u8* chunk = nullptr;
+  u32 chunk_size = 0;
   for (u32 lba = 0; lba < index_length; lba++)
   {
     if ((lba % update_interval) == 0)
@@ -43,20 +194,35 @@ bool CDImageHasher::ReadIndex(CDImage* image, u8 track, u8 index, MD5Digest* dig
     if (progress_callback->IsCancelled())
       return false;
 
-    if (!image->ReadRawSector(sector.data(), nullptr))
+    if (!chunk)
+    {
+      chunk = pipeline.BeginChunk();
+      chunk_size = 0;
+    }
+
+    if (!image->ReadRawSector(chunk + chunk_size, nullptr))
     {
       progress_callback->FormatModalError("Failed to read sector {} from image", image->GetPositionOnDisc());
       return false;
     }
 
-    digest->Update(sector);
+    chunk_size += CDImage::RAW_SECTOR_SIZE;
+    if (chunk_size == HashPipeline::CHUNK_SIZE)
+    {
+      pipeline.SubmitChunk(digest, chunk_size);
+      chunk = nullptr;
+    }
   }
 
+  if (chunk)
+    pipeline.SubmitChunk(digest, chunk_size);
+
   progress_callback->SetProgressValue(index_length);
   return true;
 }
 
-bool CDImageHasher::ReadTrack(CDImage* image, u8 track, MD5Digest* digest, ProgressCallback* progress_callback)
+bool CDImageHasher::ReadTrack(CDImage* image, u8 track, HashPipeline& pipeline, MD5Digest* digest,
+                              ProgressCallback* progress_callback)
 {
   static constexpr u8 INDICES_TO_READ = 2;
 
@@ -76,7 +242,7 @@ bool CDImageHasher::ReadTrack(CDImage* image, u8 track, MD5Digest* digest, Progr
 
     progress++;
     progress_callback->PushState();
-    if (!ReadIndex(image, track, index, digest, progress_callback))
+    if (!ReadIndex(image, track, index, pipeline, digest, progress_callback))
     {
       progress_callback->PopState();
       progress_callback->PopState();
@@ -113,7 +279,9 @@ std::optional<CDImageHasher::Hash> CDImageHasher::HashFromString(std::string_vie
 bool CDImageHasher::GetImageHash(CDImage* image, Hash* out_hash,
                                  ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/)
 {
+  // Digest must outlive the pipeline, which still hashes queued chunks when destroyed on error.
   MD5Digest digest;
+  HashPipeline pipeline;
 
   progress_callback->SetCancellable(true);
   progress_callback->SetProgressRange(image->GetTrackCount());
@@ -123,7 +291,7 @@ bool CDImageHasher::GetImageHash(CDImage* image, Hash* out_hash,
   for (u32 i = 1; i <= image->GetTrackCount(); i++)
   {
     progress_callback->SetProgressValue(i - 1);
-    if (!ReadTrack(image, static_cast<u8>(i), &digest, progress_callback))
+    if (!ReadTrack(image, static_cast<u8>(i), pipeline, &digest, progress_callback))
     {
       progress_callback->PopState();
       return false;
@@ -131,6 +299,7 @@ bool CDImageHasher::GetImageHash(CDImage* image, Hash* out_hash,
   }
 
   progress_callback->SetProgressValue(image->GetTrackCount());
+  pipeline.Flush();
   digest.Final(*out_hash);
   return true;
 }
@@ -139,9 +308,124 @@ bool CDImageHasher::GetTrackHash(CDImage* image, u8 track, Hash* out_hash,
                                  ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/)
 {
   MD5Digest digest;
-  if (!ReadTrack(image, track, &digest, progress_callback))
+  HashPipeline pipeline;
+  if (!ReadTrack(image, track, pipeline, &digest, progress_callback))
     return false;
 
+  pipeline.Flush();
   digest.Final(*out_hash);
   return true;
 }
+
+bool CDImageHasher::GetTrackHashes(CDImage* image, std::vector<Hash>* out_hashes,
+                                   ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/)
+{
+  // Tracks are read back-to-back, so the next track's reads overlap with hashing the end of the previous one.
+  const u32 track_count = image->GetTrackCount();
+  std::vector<MD5Digest> digests(track_count);
+  HashPipeline pipeline;
+
+  progress_callback->SetProgressRange(track_count);
+  progress_callback->SetProgressValue(0);
+
+  for (u32 i = 0; i < track_count; i++)
+  {
+    progress_callback->SetProgressValue(i);
+    if (!ReadTrack(image, static_cast<u8>(i + 1), pipeline, &digests[i], progress_callback))
+      return false;
+  }
+
+  progress_callback->SetProgressValue(track_count);
+  pipeline.Flush();
+
+  out_hashes->resize(track_count);
+  for (u32 i = 0; i < track_count; i++)
+    digests[i].Final((*out_hashes)[i]);
+
+  return true;
+}
+
+void CDImageHasher::HashImage(const std::string& path, const std::atomic_bool& cancelled, ImageHashResult* result)
+{
+  Error error;
+  std::unique_ptr<CDImage> image = CDImage::Open(path.c_str(), false, &error);
+  if (!image)
+  {
+    result->error = error.GetDescription();
+    return;
+  }
+
+  WorkerProgressCallback progress(cancelled, &result->error);
+  result->success = GetTrackHashes(image.get(), &result->track_hashes, &progress);
+}
+
+std::vector<CDImageHasher::ImageHashResult>
+CDImageHasher::GetTrackHashesForImages(std::span<const std::string> paths,
+                                       ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/)
+{
+  std::vector<ImageHashResult> results(paths.size());
+  progress_callback->SetCancellable(true);
+  progress_callback->SetProgressRange(static_cast<u32>(paths.size()));
+  progress_callback->SetProgressValue(0);
+  if (paths.empty() || progress_callback->IsCancelled())
+    return results;
+
+  // Each image already has its own reader and hasher thread, so a few images in flight is enough to keep the disk
+  // busy. This also bounds memory usage to a handful of open images and chunk buffers.
+  const u32 num_threads = std::min<u32>(
+    std::clamp<u32>(std::thread::hardware_concurrency() / 2, 1, MAX_PARALLEL_IMAGES), static_cast<u32>(paths.size()));
+
+  std::mutex mutex;
+  std::condition_variable done_cv;
+  std::atomic<size_t> next_index{0};
+  std::atomic_bool cancelled{false};
+  size_t completed = 0;
+
+  const auto worker = [&]() {
+    for (;;)
+    {
+      const size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+      if (index >= paths.size() || cancelled.load(std::memory_order_relaxed))
+        break;
+
+      HashImage(paths[index], cancelled, &results[index]);
+
+      std::unique_lock lock(mutex);
+      completed++;
+      done_cv.notify_one();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (u32 i = 0; i < num_threads; i++)
+    threads.emplace_back(worker);
+
+  // Progress callbacks aren't thread-safe, so only report from here. Poll so cancellation is noticed promptly, the
+  // workers then abandon the images they're part-way through.
+  {
+    std::unique_lock lock(mutex);
+    while (completed < paths.size())
+    {
+      const size_t last_completed = completed;
+      done_cv.wait_for(lock, std::chrono::milliseconds(100), [&]() { return (completed != last_completed); });
+
+      const size_t current_completed = completed;
+      lock.unlock();
+      progress_callback->SetProgressValue(static_cast<u32>(current_completed));
+      if (progress_callback->IsCancelled())
+      {
+        cancelled.store(true, std::memory_order_relaxed);
+        lock.lock();
+        break;
+      }
+
+      lock.lock();
+    }
+  }
+
+  for (std::thread& thread : threads)
+    thread.join();
+
+  return results;
+}
@@ -6,7 +6,9 @@
 #include "common/types.h"
 #include <array>
 #include <optional>
+#include <span>
 #include <string>
+#include <vector>
 
 class CDImage;
 
@@ -21,4 +23,22 @@ bool GetImageHash(CDImage* image, Hash* out_hash,
 bool GetTrackHash(CDImage* image, u8 track, Hash* out_hash,
                   ProgressCallback* progress_callback = ProgressCallback::NullProgressCallback);
 
+/// Hashes every track of the image in a single pass, one hash per track.
+bool GetTrackHashes(CDImage* image, std::vector<Hash>* out_hashes,
+                    ProgressCallback* progress_callback = ProgressCallback::NullProgressCallback);
+
+struct ImageHashResult
+{
+  std::vector<Hash> track_hashes;
+  std::string error;
+  bool success = false;
+};
+
+/// Hashes every track of each image, several images at a time. Memory usage is bounded by the number of images
+/// in flight, not the number or size of images. Results are in the same order as paths. Cancelling stops images
+/// part-way through; those, and any images which were not started, have neither success nor an error set.
+std::vector<ImageHashResult>
+GetTrackHashesForImages(std::span<const std::string> paths,
+                        ProgressCallback* progress_callback = ProgressCallback::NullProgressCallback);
+
 } // namespace CDImageHasher
\ No newline at end of file
@@ -29,6 +29,9 @@ public:
 
   bool ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index) override;
   bool HasSubchannelData() const override;
+  PrecacheResult Precache(ProgressCallback* progress = ProgressCallback::NullProgressCallback) override;
+  bool IsPrecached() const override;
+  void PrefetchSectors(LBA start_lba, u32 count) override;
 
   bool HasSubImages() const override;
   u32 GetSubImageCount() const override;
@@ -120,6 +123,21 @@ bool CDImageM3u::HasSubchannelData() const
   return m_current_image->HasSubchannelData();
 }
 
+CDImage::PrecacheResult CDImageM3u::Precache(ProgressCallback* progress /*= ProgressCallback::NullProgressCallback*/)
+{
+  return m_current_image->Precache(progress);
+}
+
+bool CDImageM3u::IsPrecached() const
+{
+  return m_current_image->IsPrecached();
+}
+
+void CDImageM3u::PrefetchSectors(LBA start_lba, u32 count)
+{
+  m_current_image->PrefetchSectors(start_lba, count);
+}
+
 bool CDImageM3u::HasSubImages() const
 {
   return true;
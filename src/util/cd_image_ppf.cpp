@@ -38,6 +38,7 @@ public:
   std::string GetSubImageTitle(u32 index) const override;
 
   PrecacheResult Precache(ProgressCallback* progress = ProgressCallback::NullProgressCallback) override;
+  void PrefetchSectors(LBA start_lba, u32 count) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
@@ -430,6 +431,11 @@ CDImage::PrecacheResult CDImagePPF::Precache(ProgressCallback* progress /*= Prog
   return m_parent_image->Precache(progress);
 }
 
+void CDImagePPF::PrefetchSectors(LBA start_lba, u32 count)
+{
+  m_parent_image->PrefetchSectors(start_lba, count);
+}
+
 bool CDImagePPF::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
 {
   DebugAssert(index.file_index == 0);
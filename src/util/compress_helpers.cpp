@@ -11,6 +11,7 @@
 #include "common/path.h"
 #include "common/scoped_guard.h"
 #include "common/string_util.h"
+#include "common/task_queue.h"
 
 #include "7zCrc.h"
 #include "Alloc.h"
@@ -22,6 +23,8 @@
 #include <zstd.h>
 #include <zstd_errors.h>
 
+#include <thread>
+
 LOG_CHANNEL(CompressHelpers);
 
 // TODO: Use streaming API to avoid mallocing the whole input buffer. But one read() call is probably still faster..
@@ -35,6 +38,11 @@ static bool DecompressDeflate(std::span<u8> dst, size_t uncompressed_size, std::
 
 static std::optional<size_t> GetZstdDecompressedSize(std::span<const u8> data, Error* error);
 static bool DecompressZstd(std::span<u8> dst, size_t uncompressed_size, std::span<const u8> data, Error* error);
+static bool CompressZstdMT(ByteBuffer& ret, std::span<const u8> data, int clevel, size_t chunk_size, Error* error);
+static bool CompressXzMT(ByteBuffer& ret, std::span<const u8> data, int clevel, size_t chunk_size, Error* error);
+
+template<typename F>
+static bool ForEachChunk(size_t num_chunks, const F& func, Error* error);
 
 template<typename T>
 static bool DecompressHelper(ByteBuffer& ret, CompressType type, T data, std::optional<size_t> decompressed_size,
@@ -48,6 +56,16 @@ static bool XzCompress(ByteBuffer& ret, const u8* data, size_t data_size, int cl
 
 static std::once_flag s_lzma_crc_table_init;
 
+// Zstandard seekable format, see contrib/seekable_format in the zstd repository.
+static constexpr u32 ZSTD_SKIPPABLE_FRAME_MAGIC = 0x184D2A5E;
+static constexpr u32 ZSTD_SEEKABLE_MAGIC = 0x8F92EAB1;
+static constexpr size_t ZSTD_SKIPPABLE_HEADER_SIZE = 8;
+static constexpr size_t ZSTD_SEEK_TABLE_FOOTER_SIZE = 9;
+static constexpr size_t ZSTD_SEEK_TABLE_ENTRY_SIZE = 8;
+static constexpr size_t ZSTD_SEEK_TABLE_ENTRY_SIZE_WITH_CHECKSUM = 12;
+static constexpr u8 ZSTD_SEEK_TABLE_CHECKSUM_FLAG = 0x80;
+static constexpr u8 ZSTD_SEEK_TABLE_RESERVED_BITS = 0x7C;
+
 } // namespace CompressHelpers
 
 std::optional<CompressHelpers::CompressType> CompressHelpers::GetCompressType(const std::string_view path, Error* error)
@@ -130,6 +148,10 @@ bool CompressHelpers::DecompressDeflate(std::span<u8> dst, size_t uncompressed_s
 
 std::optional<size_t> CompressHelpers::GetZstdDecompressedSize(std::span<const u8> data, Error* error)
 {
+  // Frame header only describes the first chunk in seekable buffers.
+  if (const std::optional<SeekTable> seek_table = ReadZstdSeekTable(data); seek_table.has_value())
+    return seek_table->empty() ? 0 : (seek_table->back().decompressed_offset + seek_table->back().decompressed_size);
+
   const unsigned long long runtime_decompressed_size = ZSTD_getFrameContentSize(data.data(), data.size());
   if (runtime_decompressed_size == ZSTD_CONTENTSIZE_UNKNOWN || runtime_decompressed_size == ZSTD_CONTENTSIZE_ERROR ||
       runtime_decompressed_size >= std::numeric_limits<size_t>::max()) [[unlikely]]
@@ -150,6 +172,25 @@ bool CompressHelpers::DecompressZstd(std::span<u8> dst, size_t uncompressed_size
     return false;
   }
 
+  // Chunks in seekable buffers are independent, so they can be decompressed in parallel.
+  if (const std::optional<SeekTable> seek_table = ReadZstdSeekTable(data);
+      seek_table.has_value() && seek_table->size() > 1)
+  {
+    const size_t total_size = seek_table->back().decompressed_offset + seek_table->back().decompressed_size;
+    if (total_size != uncompressed_size) [[unlikely]]
+    {
+      Error::SetStringFmt(error, "Seek table size mismatch, expected {}, got {}", uncompressed_size, total_size);
+      return false;
+    }
+
+    return ForEachChunk(
+      seek_table->size(),
+      [dst, data, &seek_table](size_t i, Error* chunk_error) {
+        return DecompressZstdChunk(dst, data, seek_table.value()[i], chunk_error);
+      },
+      error);
+  }
+
   const size_t result = ZSTD_decompress(dst.data(), dst.size(), data.data(), data.size());
   if (ZSTD_isError(result)) [[unlikely]]
   {
@@ -341,11 +382,18 @@ bool CompressHelpers::XzDecompressor::Decompress(std::span<u8> dst, Error* error
     return false;
   }
 
+  // Blocks are independent, so gather their locations first and decompress them in parallel.
+  struct BlockInfo
+  {
+    size_t src_offset;
+    size_t src_size;
+    size_t dst_offset;
+    size_t dst_size;
+    CXzStreamFlags stream_flags;
+  };
+  std::vector<BlockInfo> blocks;
   size_t out_pos = 0;
 
-  CXzUnpacker unpacker = {};
-  XzUnpacker_Construct(&unpacker, &g_Alloc);
-
   for (int sn = static_cast<int>(xzs.num - 1); sn >= 0; sn--)
   {
     const CXzStream& stream = xzs.streams[sn];
@@ -356,47 +404,61 @@ bool CompressHelpers::XzDecompressor::Decompress(std::span<u8> dst, Error* error
     for (size_t bn = 0; bn < stream.numBlocks; bn++)
     {
       const CXzBlockSizes& block = stream.blocks[bn];
+      const size_t compressed_size =
+        std::min<size_t>(Common::AlignUpPow2(block.totalSize, 4),
+                         static_cast<size_t>(mis.data_size - src_offset)); // LZMA blocks are 4 byte aligned?;
+
+      blocks.push_back(BlockInfo{.src_offset = src_offset,
+                                 .src_size = compressed_size,
+                                 .dst_offset = out_pos,
+                                 .dst_size = static_cast<size_t>(block.unpackSize),
+                                 .stream_flags = stream.flags});
+      out_pos += static_cast<size_t>(block.unpackSize);
+      src_offset += compressed_size;
+    }
+  }
 
+  if (out_pos != stream_size)
+  {
+    Error::SetStringFmt(error, "Only decompressed {} of {} bytes", out_pos, stream_size);
+    return false;
+  }
+
+  return ForEachChunk(
+    blocks.size(),
+    [this, dst, &blocks](size_t i, Error* block_error) {
+      const BlockInfo& bi = blocks[i];
+
+      CXzUnpacker unpacker = {};
+      XzUnpacker_Construct(&unpacker, &g_Alloc);
       XzUnpacker_Init(&unpacker);
-      unpacker.streamFlags = stream.flags;
+      unpacker.streamFlags = bi.stream_flags;
       XzUnpacker_PrepareToRandomBlockDecoding(&unpacker);
-      XzUnpacker_SetOutBuf(&unpacker, &dst[out_pos], dst.size() - out_pos);
-
-      const size_t orig_compressed_size =
-        std::min<size_t>(Common::AlignUpPow2(block.totalSize, 4),
-                         static_cast<size_t>(mis.data_size - src_offset)); // LZMA blocks are 4 byte aligned?;
+      XzUnpacker_SetOutBuf(&unpacker, &dst[bi.dst_offset], bi.dst_size);
 
-      SizeT block_uncompressed_size = block.unpackSize;
-      SizeT block_compressed_size = orig_compressed_size;
+      SizeT block_uncompressed_size = bi.dst_size;
+      SizeT block_compressed_size = bi.src_size;
 
       ECoderStatus status;
-      SRes res = XzUnpacker_Code(&unpacker, nullptr, &block_uncompressed_size, &mis.data[src_offset],
-                                 &block_compressed_size, true, CODER_FINISH_END, &status);
+      const SRes res = XzUnpacker_Code(&unpacker, nullptr, &block_uncompressed_size, &mis.data[bi.src_offset],
+                                       &block_compressed_size, true, CODER_FINISH_END, &status);
+      XzUnpacker_Free(&unpacker);
       if (res != SZ_OK || status != CODER_STATUS_FINISHED_WITH_MARK) [[unlikely]]
       {
-        Error::SetStringFmt(error, "XzUnpacker_Code() failed: {} ({}) (status {})", SZErrorToString(res), res,
+        Error::SetStringFmt(block_error, "XzUnpacker_Code() failed: {} ({}) (status {})", SZErrorToString(res), res,
                             static_cast<unsigned>(status));
         return false;
       }
 
-      if (block_compressed_size != orig_compressed_size || block_uncompressed_size != block.unpackSize)
+      if (block_compressed_size != bi.src_size || block_uncompressed_size != bi.dst_size)
       {
         WARNING_LOG("Decompress size mismatch: {}/{} vs {}/{}", block_compressed_size, block_uncompressed_size,
-                    orig_compressed_size, block.unpackSize);
+                    bi.src_size, bi.dst_size);
       }
 
-      out_pos += block_uncompressed_size;
-      src_offset += block_compressed_size;
-    }
-  }
-
-  if (out_pos != stream_size)
-  {
-    Error::SetStringFmt(error, "Only decompressed {} of {} bytes", out_pos, stream_size);
-    return false;
-  }
-
-  return true;
+      return true;
+    },
+    error);
 }
 
 bool CompressHelpers::XzCompress(ByteBuffer& ret, const u8* data, size_t data_size, int clevel, Error* error)
@@ -825,3 +887,280 @@ bool CompressHelpers::CompressToFile(CompressType type, const char* path, std::s
   return atomic_write ? FileSystem::WriteAtomicRenamedFile(path, cdata->data(), cdata->size(), error) :
                         FileSystem::WriteBinaryFile(path, cdata->data(), cdata->size(), error);
 }
+
+template<typename F>
+bool CompressHelpers::ForEachChunk(size_t num_chunks, const F& func, Error* error)
+{
+  const u32 num_threads =
+    static_cast<u32>(std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), num_chunks));
+  if (num_threads <= 1)
+  {
+    for (size_t i = 0; i < num_chunks; i++)
+    {
+      if (!func(i, error))
+        return false;
+    }
+
+    return true;
+  }
+
+  std::vector<Error> errors(num_chunks);
+  std::vector<u8> results(num_chunks);
+  {
+    // Calling thread also executes tasks while waiting.
+    TaskQueue queue;
+    queue.SetWorkerCount(num_threads - 1);
+    for (size_t i = 0; i < num_chunks; i++)
+      queue.SubmitTask([&func, &errors, &results, i]() { results[i] = func(i, &errors[i]); });
+    queue.WaitForAll();
+  }
+
+  for (size_t i = 0; i < num_chunks; i++)
+  {
+    if (!results[i])
+    {
+      if (error)
+        *error = std::move(errors[i]);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool CompressHelpers::CompressZstdMT(ByteBuffer& ret, std::span<const u8> data, int clevel, size_t chunk_size,
+                                     Error* error)
+{
+  const size_t num_chunks = (data.size() + chunk_size - 1) / chunk_size;
+  std::vector<ByteBuffer> chunks(num_chunks);
+  if (!ForEachChunk(
+        num_chunks,
+        [data, clevel, chunk_size, &chunks](size_t i, Error* chunk_error) {
+          const size_t offset = i * chunk_size;
+          return CompressHelper(chunks[i], CompressType::Zstandard,
+                                data.subspan(offset, std::min(chunk_size, data.size() - offset)), clevel, chunk_error);
+        },
+        error))
+  {
+    return false;
+  }
+
+  // Frames, followed by the seek table in a skippable frame.
+  SeekTable entries(num_chunks);
+  size_t total_size = 0;
+  for (size_t i = 0; i < num_chunks; i++)
+  {
+    entries[i].compressed_offset = total_size;
+    entries[i].compressed_size = chunks[i].size();
+    entries[i].decompressed_offset = i * chunk_size;
+    entries[i].decompressed_size = std::min(chunk_size, data.size() - i * chunk_size);
+    total_size += chunks[i].size();
+  }
+
+  const ByteBuffer seek_table = CreateZstdSeekTable(entries);
+  ret.resize(total_size + seek_table.size());
+  u8* out_ptr = ret.data();
+  for (const ByteBuffer& chunk : chunks)
+  {
+    std::memcpy(out_ptr, chunk.data(), chunk.size());
+    out_ptr += chunk.size();
+  }
+  std::memcpy(out_ptr, seek_table.data(), seek_table.size());
+  return true;
+}
+
+CompressHelpers::ByteBuffer CompressHelpers::CreateZstdSeekTable(std::span<const SeekTableEntry> entries)
+{
+  const size_t seek_table_size = entries.size() * ZSTD_SEEK_TABLE_ENTRY_SIZE + ZSTD_SEEK_TABLE_FOOTER_SIZE;
+  ByteBuffer ret(ZSTD_SKIPPABLE_HEADER_SIZE + seek_table_size);
+  u8* out_ptr = ret.data();
+  const auto write_u32 = [&out_ptr](u32 value) {
+    std::memcpy(out_ptr, &value, sizeof(value));
+    out_ptr += sizeof(value);
+  };
+
+  write_u32(ZSTD_SKIPPABLE_FRAME_MAGIC);
+  write_u32(static_cast<u32>(seek_table_size));
+  for (const SeekTableEntry& entry : entries)
+  {
+    write_u32(static_cast<u32>(entry.compressed_size));
+    write_u32(static_cast<u32>(entry.decompressed_size));
+  }
+  write_u32(static_cast<u32>(entries.size()));
+  *(out_ptr++) = 0; // no checksums
+  write_u32(ZSTD_SEEKABLE_MAGIC);
+  DebugAssert(out_ptr == ret.data() + ret.size());
+  return ret;
+}
+
+bool CompressHelpers::CompressXzMT(ByteBuffer& ret, std::span<const u8> data, int clevel, size_t chunk_size,
+                                   Error* error)
+{
+  // Concatenated xz streams are still a valid xz file.
+  const size_t num_chunks = (data.size() + chunk_size - 1) / chunk_size;
+  std::vector<ByteBuffer> chunks(num_chunks);
+  if (!ForEachChunk(
+        num_chunks,
+        [data, clevel, chunk_size, &chunks](size_t i, Error* chunk_error) {
+          const size_t offset = i * chunk_size;
+          const size_t size = std::min(chunk_size, data.size() - offset);
+          return XzCompress(chunks[i], data.data() + offset, size, clevel, chunk_error);
+        },
+        error))
+  {
+    return false;
+  }
+
+  size_t total_size = 0;
+  for (const ByteBuffer& chunk : chunks)
+    total_size += chunk.size();
+
+  ret.resize(total_size);
+  size_t out_pos = 0;
+  for (const ByteBuffer& chunk : chunks)
+  {
+    std::memcpy(ret.data() + out_pos, chunk.data(), chunk.size());
+    out_pos += chunk.size();
+  }
+
+  return true;
+}
+
+CompressHelpers::OptionalByteBuffer CompressHelpers::CompressToBufferMT(CompressType type, std::span<const u8> data,
+                                                                        int clevel /* = -1 */,
+                                                                        size_t chunk_size /* = DEFAULT_CHUNK_SIZE */,
+                                                                        Error* error /* = nullptr */)
+{
+  OptionalByteBuffer ret = ByteBuffer();
+  bool result;
+  if (data.size() == 0) [[unlikely]]
+  {
+    Error::SetStringView(error, "Buffer is empty.");
+    result = false;
+  }
+  else if (type == CompressType::Zstandard)
+  {
+    result = CompressZstdMT(ret.value(), data, clevel, std::max<size_t>(chunk_size, 1), error);
+  }
+  else if (type == CompressType::XZ)
+  {
+    result = CompressXzMT(ret.value(), data, clevel, std::max<size_t>(chunk_size, 1), error);
+  }
+  else
+  {
+    result = CompressHelper(ret.value(), type, data, clevel, error);
+  }
+
+  if (!result)
+    ret.reset();
+
+  return ret;
+}
+
+bool CompressHelpers::CompressToFileMT(const char* path, std::span<const u8> data, int clevel /* = -1 */,
+                                       bool atomic_write /* = true */, size_t chunk_size /* = DEFAULT_CHUNK_SIZE */,
+                                       Error* error /* = nullptr */)
+{
+  const std::optional<CompressType> type = GetCompressType(path, error);
+  if (!type.has_value())
+    return false;
+
+  const OptionalByteBuffer cdata = CompressToBufferMT(type.value(), data, clevel, chunk_size, error);
+  if (!cdata.has_value())
+    return false;
+
+  return atomic_write ? FileSystem::WriteAtomicRenamedFile(path, cdata->data(), cdata->size(), error) :
+                        FileSystem::WriteBinaryFile(path, cdata->data(), cdata->size(), error);
+}
+
+std::optional<CompressHelpers::SeekTable> CompressHelpers::ReadZstdSeekTable(std::span<const u8> data,
+                                                                             Error* error /* = nullptr */)
+{
+  std::optional<SeekTable> ret;
+  if (data.size() < (ZSTD_SKIPPABLE_HEADER_SIZE + ZSTD_SEEK_TABLE_FOOTER_SIZE))
+    return ret;
+
+  const auto read_u32 = [&data](size_t offset) {
+    u32 value;
+    std::memcpy(&value, &data[offset], sizeof(value));
+    return value;
+  };
+
+  const size_t footer_offset = data.size() - ZSTD_SEEK_TABLE_FOOTER_SIZE;
+  const u32 num_frames = read_u32(footer_offset);
+  const u8 descriptor = data[footer_offset + sizeof(u32)];
+  if (read_u32(footer_offset + sizeof(u32) + sizeof(u8)) != ZSTD_SEEKABLE_MAGIC)
+    return ret;
+
+  const size_t entry_size = (descriptor & ZSTD_SEEK_TABLE_CHECKSUM_FLAG) ? ZSTD_SEEK_TABLE_ENTRY_SIZE_WITH_CHECKSUM :
+                                                                           ZSTD_SEEK_TABLE_ENTRY_SIZE;
+  const size_t seek_table_size = static_cast<size_t>(num_frames) * entry_size + ZSTD_SEEK_TABLE_FOOTER_SIZE;
+  if ((descriptor & ZSTD_SEEK_TABLE_RESERVED_BITS) != 0 ||
+      (seek_table_size + ZSTD_SKIPPABLE_HEADER_SIZE) > data.size()) [[unlikely]]
+  {
+    Error::SetStringView(error, "Seek table is corrupted.");
+    return ret;
+  }
+
+  const size_t seek_table_offset = data.size() - seek_table_size - ZSTD_SKIPPABLE_HEADER_SIZE;
+  if (read_u32(seek_table_offset) != ZSTD_SKIPPABLE_FRAME_MAGIC ||
+      read_u32(seek_table_offset + sizeof(u32)) != seek_table_size) [[unlikely]]
+  {
+    Error::SetStringView(error, "Seek table header is corrupted.");
+    return ret;
+  }
+
+  SeekTable& table = ret.emplace();
+  table.reserve(num_frames);
+
+  size_t compressed_offset = 0;
+  size_t decompressed_offset = 0;
+  for (u32 i = 0; i < num_frames; i++)
+  {
+    const size_t entry_offset = seek_table_offset + ZSTD_SKIPPABLE_HEADER_SIZE + i * entry_size;
+    const size_t compressed_size = read_u32(entry_offset);
+    const size_t decompressed_size = read_u32(entry_offset + sizeof(u32));
+    if ((compressed_offset + compressed_size) > seek_table_offset) [[unlikely]]
+    {
+      Error::SetStringFmt(error, "Frame {} is out of range.", i);
+      ret.reset();
+      return ret;
+    }
+
+    table.push_back(SeekTableEntry{.compressed_offset = compressed_offset,
+                                   .compressed_size = compressed_size,
+                                   .decompressed_offset = decompressed_offset,
+                                   .decompressed_size = decompressed_size});
+    compressed_offset += compressed_size;
+    decompressed_offset += decompressed_size;
+  }
+
+  return ret;
+}
+
+bool CompressHelpers::DecompressZstdChunk(std::span<u8> dst, std::span<const u8> data, const SeekTableEntry& entry,
+                                          Error* error /* = nullptr */)
+{
+  if ((entry.decompressed_offset + entry.decompressed_size) > dst.size() ||
+      (entry.compressed_offset + entry.compressed_size) > data.size()) [[unlikely]]
+  {
+    Error::SetStringView(error, "Chunk is out of range.");
+    return false;
+  }
+
+  const size_t result = ZSTD_decompress(&dst[entry.decompressed_offset], entry.decompressed_size,
+                                        &data[entry.compressed_offset], entry.compressed_size);
+  if (ZSTD_isError(result)) [[unlikely]]
+  {
+    const char* errstr = ZSTD_getErrorString(ZSTD_getErrorCode(result));
+    Error::SetStringFmt(error, "ZSTD_decompress() failed: {}", errstr ? errstr : "<unknown>");
+    return false;
+  }
+  else if (result != entry.decompressed_size) [[unlikely]]
+  {
+    Error::SetStringFmt(error, "ZSTD_decompress() only returned {} of {} bytes.", result, entry.decompressed_size);
+    return false;
+  }
+
+  return true;
+}
@@ -7,6 +7,7 @@
 
 #include <optional>
 #include <span>
+#include <vector>
 
 class Error;
 
@@ -23,6 +24,19 @@ enum class CompressType
 using ByteBuffer = DynamicHeapArray<u8>;
 using OptionalByteBuffer = std::optional<ByteBuffer>;
 
+/// Default size of each independently-compressed chunk for the multi-threaded functions.
+static constexpr size_t DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+/// Location of an independently-decompressable chunk in a seekable Zstandard buffer.
+struct SeekTableEntry
+{
+  size_t compressed_offset;
+  size_t compressed_size;
+  size_t decompressed_offset;
+  size_t decompressed_size;
+};
+using SeekTable = std::vector<SeekTableEntry>;
+
 std::optional<size_t> GetDecompressedSize(CompressType type, std::span<const u8> data, Error* error = nullptr);
 std::optional<size_t> DecompressBuffer(std::span<u8> dst, CompressType type, std::span<const u8> data,
                                        std::optional<size_t> decompressed_size = std::nullopt, Error* error = nullptr);
@@ -55,6 +69,26 @@ bool CompressToFile(const char* path, std::span<const u8> data, int clevel = -1,
 bool CompressToFile(CompressType type, const char* path, std::span<const u8> data, int clevel = -1,
                     bool atomic_write = true, Error* error = nullptr);
 
+/// Compresses data as independent chunks on multiple threads. Zstandard output is a sequence of frames followed by a
+/// seek table in the zstd seekable format, XZ output is a sequence of streams. Both remain readable by the regular
+/// decompression functions, which decompress chunks in parallel where possible. Deflate is compressed as one chunk.
+OptionalByteBuffer CompressToBufferMT(CompressType type, std::span<const u8> data, int clevel = -1,
+                                      size_t chunk_size = DEFAULT_CHUNK_SIZE, Error* error = nullptr);
+bool CompressToFileMT(const char* path, std::span<const u8> data, int clevel = -1, bool atomic_write = true,
+                      size_t chunk_size = DEFAULT_CHUNK_SIZE, Error* error = nullptr);
+
+/// Reads the seek table from a Zstandard buffer created by CompressToBufferMT(). Returns std::nullopt if the buffer
+/// does not contain a seek table.
+std::optional<SeekTable> ReadZstdSeekTable(std::span<const u8> data, Error* error = nullptr);
+
+/// Creates a seek table frame for chunks which were compressed as independent Zstandard frames. Only the compressed and
+/// decompressed sizes of each entry are used. Appending it to the frames produces the same layout as CompressToBufferMT().
+ByteBuffer CreateZstdSeekTable(std::span<const SeekTableEntry> entries);
+
+/// Decompresses a single chunk from a seekable Zstandard buffer.
+bool DecompressZstdChunk(std::span<u8> dst, std::span<const u8> data, const SeekTableEntry& entry,
+                         Error* error = nullptr);
+
 const char* SZErrorToString(int res);
 
 } // namespace CompressHelpers